@@ -0,0 +1,20 @@
+#ifndef BENCH_UTIL_HPP
+#define BENCH_UTIL_HPP
+
+
+namespace bench {
+
+// Stores to a volatile can't be left out, so neither can the work behind them
+inline volatile double sink;
+
+/**
+ * @brief Keeps the compiler from optimizing away a result that is only timed
+ */
+inline void do_not_optimize(double value) {
+	sink = value;
+}
+
+} // namespace bench
+
+
+#endif	// BENCH_UTIL_HPP
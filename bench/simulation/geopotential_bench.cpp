@@ -0,0 +1,83 @@
+#include "simulation/forces/force_model.hpp"
+#include "simulation/forces/geopotential.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "bench_util.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+
+namespace {
+
+// Field with Kaula's rule magnitudes, the cost doesn't depend on the values
+void write_kaula_field(const std::string &filename, int degree) {
+	std::ofstream file(filename);
+	file << std::setprecision(17) << "0 0 1 0\n";
+	for (int n = 2; n <= degree; n++) {
+		for (int m = 0; m <= n; m++) {
+			double c = 1e-5 / (n * n) * std::sin(3.0 * n + m);
+			double s = m == 0 ? 0 : 1e-5 / (n * n) * std::cos(5.0 * n - m);
+			file << n << " " << m << " " << c << " " << s << "\n";
+		}
+	}
+}
+
+template <typename DE>
+double ns_per_eval(const DE &de_system, int evals) {
+	// Walk along a circle so nothing can be hoisted out of the loop
+	orbsim::Vec3 sum{0, 0, 0};
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < evals; i++) {
+		double angle = i * 1e-3;
+		orbsim::Vec3 x{1.1 * std::cos(angle), 1.1 * std::sin(angle), 0.3};
+		sum = sum + de_system.accel(i * 1e-3, x, x);
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	bench::do_not_optimize(sum.x + sum.y + sum.z);
+	return elapsed.count() * 1e9 / evals;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	using namespace orbsim;
+
+	// Usage: geopotential_bench [evals] [coefficient file]
+	int evals = argc > 1 ? std::atoi(argv[1]) : 200000;
+	std::string filename = argc > 2 ? argv[2] : "geopotential_bench_field.txt";
+	bool generated = argc <= 2;
+	if (generated) write_kaula_field(filename, 70);
+
+	double point_mass = ns_per_eval(orbit_de, evals);
+	std::cout << std::setw(8) << "field" << std::setw(14) << "[ns/eval]"
+			  << std::setw(16) << "x point-mass" << "\n";
+	std::cout << std::setw(8) << "0x0" << std::setw(14) << std::fixed << std::setprecision(1)
+			  << point_mass << std::setw(16) << 1.0 << "\n";
+
+	for (int degree : {2, 4, 8, 12, 20, 30, 50, 70}) {
+		Geopotential field(filename, degree, degree);
+		ForceModelDE force_model;
+		force_model.set_geopotential(&field);
+
+		// Fewer evaluations for the big fields
+		int n = std::max(1000, evals / std::max(1, degree * degree / 16));
+		double ns = ns_per_eval(force_model, n);
+
+		std::cout << std::setw(8) << (std::to_string(degree) + "x" + std::to_string(degree))
+				  << std::setw(14) << ns << std::setw(16) << ns / point_mass << "\n";
+	}
+
+	if (generated) std::remove(filename.c_str());
+	return 0;
+}
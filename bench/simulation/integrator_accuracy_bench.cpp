@@ -0,0 +1,94 @@
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/integrators/euler.hpp"
+#include "simulation/integrators/verlet.hpp"
+#include "simulation/integrators/rk4.hpp"
+#include "simulation/integrators/rk87.hpp"
+#include "simulation/integrators/gauss_jackson.hpp"
+#include "simulation/integrators/yoshida.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+
+namespace {
+
+// Slightly eccentric LEO (e = 0.1, a = 8000 km), starting at periapsis. After
+// a whole number of periods the exact solution is back at the initial state.
+const double a = 8000;
+const double e = 0.1;
+const double mu = orbsim::G * orbsim::Earth.mass / 1e9;	// [km^3/s^2]
+const double period = 2 * orbsim::PI * std::sqrt(a*a*a / mu);
+const orbsim::Vec3 x0{a * (1 - e), 0, 0};
+const orbsim::Vec3 v0{0, std::sqrt(mu / a * (1 + e) / (1 - e)), 0};
+
+void run(std::string name, std::string setting, orbsim::Integrator &integ) {
+	auto start = std::chrono::steady_clock::now();
+	integ.integrate();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	double err = (integ.get_pos_arr()[integ.get_steps() - 1] - x0).len();
+
+	std::cout << std::setw(14) << name << std::setw(12) << setting
+			  << std::setw(14) << integ.get_rhs_evals()
+			  << std::setw(12) << std::fixed << std::setprecision(4) << elapsed.count()
+			  << std::setw(14) << std::scientific << std::setprecision(2) << err << "\n";
+	std::cout.unsetf(std::ios::floatfield);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	using namespace orbsim;
+
+	// Usage: integrator_accuracy_bench [periods]
+	int periods = argc > 1 ? std::atoi(argv[1]) : 100;
+	double t_end = periods * period;
+
+	std::cout << periods << " periods (" << t_end / 86400 << " days)\n";
+	std::cout << std::setw(14) << "integ" << std::setw(12) << "setting"
+			  << std::setw(14) << "RHS evals" << std::setw(12) << "time [s]"
+			  << std::setw(14) << "error [km]" << "\n";
+
+	// The fixed step schemes are given a number of steps per period
+	for (int per_period : {100, 1000, 10000}) {
+		int steps = periods * per_period + 1;
+		std::string setting = std::to_string(per_period) + "/rev";
+
+		Euler euler(orbit_de, Earth.mass, Earth.radius, x0, v0, 0, t_end, steps);
+		run("Euler", setting, euler);
+		Verlet verlet(orbit_de, Earth.mass, Earth.radius, x0, v0, 0, t_end, steps);
+		run("Verlet", setting, verlet);
+		RK4 rk4(orbit_de, Earth.mass, Earth.radius, x0, v0, 0, t_end, steps);
+		run("RK4", setting, rk4);
+		Yoshida4 yoshida4(orbit_de, Earth.mass, Earth.radius, x0, v0, 0, t_end, steps);
+		run("Yoshida4", setting, yoshida4);
+		Yoshida6 yoshida6(orbit_de, Earth.mass, Earth.radius, x0, v0, 0, t_end, steps);
+		run("Yoshida6", setting, yoshida6);
+		Yoshida8 yoshida8(orbit_de, Earth.mass, Earth.radius, x0, v0, 0, t_end, steps);
+		run("Yoshida8", setting, yoshida8);
+	}
+
+	for (int per_period : {50, 100, 200}) {
+		int steps = periods * per_period + 1;
+		GaussJackson gj(orbit_de, Earth.mass, Earth.radius, x0, v0, 0, t_end, steps);
+		run("GaussJackson", std::to_string(per_period) + "/rev", gj);
+	}
+
+	// RK87 only needs the output grid, the steps come from the tolerance
+	for (double tol : {1e-8, 1e-10, 1e-12}) {
+		std::ostringstream setting;
+		setting << "tol " << tol;
+		RK87 rk87(orbit_de, Earth.mass, Earth.radius, x0, v0, 0, t_end, periods + 1, tol, tol * 1e-3);
+		run("RK87", setting.str(), rk87);
+	}
+
+	return 0;
+}
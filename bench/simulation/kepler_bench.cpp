@@ -0,0 +1,70 @@
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/integrators/rk4.hpp"
+#include "simulation/integrators/kepler.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/thread_pool.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+
+namespace {
+
+double time_it(orbsim::Integrator &integ) {
+	auto start = std::chrono::steady_clock::now();
+	integ.integrate();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+void print(std::string name, double secs, double err) {
+	std::cout << std::setw(20) << name
+			  << std::setw(12) << std::fixed << std::setprecision(4) << secs
+			  << std::setw(14) << std::scientific << std::setprecision(2) << err << "\n";
+	std::cout.unsetf(std::ios::floatfield);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	using namespace orbsim;
+
+	// Usage: kepler_bench [samples] [days] [threads]
+	int samples = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	double days = argc > 2 ? std::atof(argv[2]) : 365;
+	unsigned threads = argc > 3 ? std::atoi(argv[3]) : 0;
+
+	Vec3 x0{7000, 0, 0};
+	Vec3 v0{0, 5.1, 7.3};
+	double t_end = days * 86400;
+
+	Kepler serial(orbit_de, Earth.mass, Earth.radius, x0, v0, 0, t_end, samples);
+	Kepler parallel(orbit_de, Earth.mass, Earth.radius, x0, v0, 0, t_end, samples);
+	ThreadPool pool(threads);
+	parallel.set_thread_pool(&pool);
+
+	double serial_secs = time_it(serial);
+	double parallel_secs = time_it(parallel);
+	Vec3 exact = serial.get_pos_arr()[samples - 1];
+
+	std::cout << samples << " samples over " << days << " days, " << pool.get_threads() << " threads\n";
+	std::cout << std::setw(20) << "propagator" << std::setw(12) << "time [s]"
+			  << std::setw(14) << "error [km]" << "\n";
+	print("Kepler", serial_secs, 0);
+	print("Kepler parallel", parallel_secs, (parallel.get_pos_arr()[samples - 1] - exact).len());
+
+	// RK4 has to step at least as often as the samples, and more for accuracy
+	for (int substeps : {1, 4, 16}) {
+		int steps = (samples - 1) * substeps + 1;
+		RK4 rk4(orbit_de, Earth.mass, Earth.radius, x0, v0, 0, t_end, steps);
+		double secs = time_it(rk4);
+		print("RK4 x" + std::to_string(substeps) + " steps", secs, (rk4.get_pos_arr()[steps - 1] - exact).len());
+	}
+
+	return 0;
+}
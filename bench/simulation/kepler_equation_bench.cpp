@@ -0,0 +1,89 @@
+#include "simulation/orbital_elements.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/thread_pool.hpp"
+
+#include "bench_util.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+// Plain Newton iterations until converged, the usual way to solve it
+double newton(double M, double e) {
+	double E = e < 0.8 ? M : orbsim::PI;
+	for (int i = 0; i < 100; i++) {
+		double dE = (E - e * std::sin(E) - M) / (1 - e * std::cos(E));
+		E -= dE;
+		if (std::fabs(dE) < 1e-15) break;
+	}
+	return E;
+}
+
+template <typename Solve>
+double solves_per_sec(Solve solve, int count) {
+	auto start = std::chrono::steady_clock::now();
+	solve();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return count / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	using namespace orbsim;
+
+	// Usage: kepler_equation_bench [solves] [threads]
+	int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	unsigned threads = argc > 2 ? std::atoi(argv[2]) : 0;
+	ThreadPool pool(threads);
+
+	std::mt19937 gen(1);
+	std::uniform_real_distribution<double> mean(0, 2 * PI);
+	std::vector<double> M(count), e(count), E(count);
+	for (double &m : M) m = mean(gen);
+
+	std::cout << count << " solves, " << pool.get_threads() << " threads\n";
+	std::cout << std::setw(8) << "ecc" << std::setw(14) << "Newton [M/s]"
+			  << std::setw(14) << "single [M/s]" << std::setw(14) << "batch [M/s]"
+			  << std::setw(16) << "parallel [M/s]" << std::setw(12) << "residual" << "\n";
+
+	for (double ecc : {0.0, 0.1, 0.5, 0.9, 0.99, 0.999}) {
+		std::fill(e.begin(), e.end(), ecc);
+
+		double sink = 0;
+		double newton_rate = solves_per_sec([&] {
+			for (int i = 0; i < count; i++) sink += newton(M[i], ecc);
+		}, count);
+		double single_rate = solves_per_sec([&] {
+			for (int i = 0; i < count; i++) sink += ecc_anom_from_mean(M[i], ecc);
+		}, count);
+		double batch_rate = solves_per_sec([&] {
+			ecc_anom_from_mean(M.data(), e.data(), E.data(), count);
+		}, count);
+		double parallel_rate = solves_per_sec([&] {
+			ecc_anom_from_mean(M.data(), e.data(), E.data(), count, &pool);
+		}, count);
+
+		double residual = 0;
+		for (int i = 0; i < count; i++) {
+			residual = std::max(residual, std::fabs(E[i] - ecc * std::sin(E[i]) - M[i]));
+		}
+		bench::do_not_optimize(sink);
+
+		std::cout << std::setw(8) << std::fixed << std::setprecision(3) << ecc << std::setprecision(2)
+				  << std::setw(14) << newton_rate / 1e6 << std::setw(14) << single_rate / 1e6
+				  << std::setw(14) << batch_rate / 1e6 << std::setw(16) << parallel_rate / 1e6
+				  << std::setw(12) << std::scientific << std::setprecision(1) << residual << "\n";
+		std::cout.unsetf(std::ios::floatfield);
+	}
+
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include "simulation/integrators/rk4.hpp"
+#include "simulation/orbital_elements.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "bench_util.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+template <typename Op>
+void run(std::string name, Op op, long long count) {
+	auto start = std::chrono::steady_clock::now();
+	double sink = op();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	bench::do_not_optimize(sink);
+
+	std::cout << std::setw(22) << name << std::setw(14) << std::fixed << std::setprecision(2)
+			  << count / elapsed.count() / 1e6 << "\n";
+	std::cout.unsetf(std::ios::floatfield);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	using namespace orbsim;
+
+	// Usage: math_obj_bench [vectors]
+	int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	const int repeats = 20;
+
+	std::mt19937 gen(1);
+	std::uniform_real_distribution<double> unif(-1, 1);
+	std::vector<Vec3> x(count), y(count);
+	for (int i = 0; i < count; i++) {
+		x[i] = Vec3{unif(gen), unif(gen), unif(gen)};
+		y[i] = Vec3{unif(gen), unif(gen), unif(gen)};
+	}
+
+	std::cout << count << " vectors, " << repeats << " passes\n";
+	std::cout << std::setw(22) << "op" << std::setw(14) << "[M/s]" << "\n";
+
+	// Every pass reads x and updates y in place
+	run("y = y + a * x", [&] {
+		for (int r = 0; r < repeats; r++) {
+			for (int i = 0; i < count; i++) y[i] = y[i] + 1e-3 * x[i];
+		}
+		return y[0].x;
+	}, (long long) repeats * count);
+	run("y += a * x", [&] {
+		for (int r = 0; r < repeats; r++) {
+			for (int i = 0; i < count; i++) y[i] += 1e-3 * x[i];
+		}
+		return y[0].x;
+	}, (long long) repeats * count);
+	run("y = fmadd(a, x, y)", [&] {
+		for (int r = 0; r < repeats; r++) {
+			for (int i = 0; i < count; i++) y[i] = fmadd(-1e-3, x[i], y[i]);
+		}
+		return y[0].x;
+	}, (long long) repeats * count);
+	run("dot + cross", [&] {
+		double sum = 0;
+		for (int r = 0; r < repeats; r++) {
+			for (int i = 0; i < count; i++) sum += x[i].cross(y[i]).dot(x[i]);
+		}
+		return sum;
+	}, (long long) repeats * count);
+	run("Mat3 * Vec3", [&] {
+		Mat3 rot = rot_z(0.3) * rot_x(1.1) * rot_z(-0.7);
+		for (int r = 0; r < repeats; r++) {
+			for (int i = 0; i < count; i++) y[i] = rot * y[i];
+		}
+		return y[0].x;
+	}, (long long) repeats * count);
+	run("Mat3 * Mat3", [&] {
+		Mat3 acc = Mat3::identity();
+		for (int r = 0; r < repeats; r++) {
+			for (int i = 0; i < count; i++) acc = rot_z(x[i].x, x[i].y) * acc;
+		}
+		return acc.m[0];
+	}, (long long) repeats * count);
+
+	// Whole kernels built on the vectors
+	std::vector<KeplElem> kepl_elems(count);
+	std::vector<CartElem> cart_elems(count);
+	for (KeplElem &k : kepl_elems) {
+		k = KeplElem{0.1 + 0.05 * unif(gen), 8000, 1 + unif(gen), PI + 3 * unif(gen), PI + 3 * unif(gen), PI + 3 * unif(gen)};
+	}
+	run("kepl_to_cart", [&] {
+		kepl_to_cart(kepl_elems.data(), cart_elems.data(), count);
+		return cart_elems[0].pos.x;
+	}, count);
+	run("cart_to_kepl", [&] {
+		cart_to_kepl(cart_elems.data(), kepl_elems.data(), count);
+		return kepl_elems[0].ecc;
+	}, count);
+
+	int steps = count / 10 + 1;
+	RK4 rk4(orbit_de, Earth.mass, Earth.radius, Vec3{7000, 0, 0}, Vec3{0, 7.5, 0}, 0, 10.0 * (steps - 1), steps);
+	run("RK4 steps", [&] {
+		rk4.integrate();
+		return rk4.get_pos_arr()[steps - 1].x;
+	}, steps - 1);
+
+	return 0;
+}
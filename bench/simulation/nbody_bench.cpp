@@ -0,0 +1,58 @@
+#include "simulation/nbody.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+
+namespace {
+
+double ms_per_eval(orbsim::NBody &nbody, int evals) {
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < evals; i++) nbody.compute_accel();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() * 1e3 / evals;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	using namespace orbsim;
+
+	// Usage: nbody_bench [threads]
+	unsigned threads = argc > 1 ? std::atoi(argv[1]) : 0;
+
+	std::cout << std::setw(8) << "bodies" << std::setw(14) << "direct [ms]"
+			  << std::setw(14) << "tree [ms]" << std::setw(10) << "speedup" << "\n";
+
+	for (int n : {1000, 4000, 16000, 64000}) {
+		NBody nbody(0, 1, 2, 0.5, threads);
+		std::mt19937 gen(7);
+		std::normal_distribution<double> pos(0, 1000);
+		for (int i = 0; i < n; i++) {
+			nbody.add_body(CelestialObj{1e12, 0.01}, CartElem{Vec3{pos(gen), pos(gen), pos(gen)}, Vec3{0, 0, 0}});
+		}
+
+		double tree = ms_per_eval(nbody, 5);
+
+		// Only the smaller clouds in direct mode, it grows as n^2
+		double direct = 0;
+		if (n <= 16000) {
+			nbody.set_direct(true);
+			direct = ms_per_eval(nbody, n <= 4000 ? 5 : 1);
+		}
+
+		std::cout << std::setw(8) << n << std::fixed << std::setprecision(2);
+		if (direct > 0) {
+			std::cout << std::setw(14) << direct << std::setw(14) << tree << std::setw(10) << direct / tree << "\n";
+		} else {
+			std::cout << std::setw(14) << "-" << std::setw(14) << tree << std::setw(10) << "-" << "\n";
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,59 @@
+#include "simulation/parallel_propagator.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+int main(int argc, char *argv[]) {
+
+	// Usage: parallel_propagator_bench [satellites] [steps]
+	int n_sats = argc > 1 ? std::atoi(argv[1]) : 512;
+	int t_steps = argc > 2 ? std::atoi(argv[2]) : 8640;
+
+	std::vector<orbsim::CartElem> cart_elems;
+	for (int i = 0; i < n_sats; i++) {
+		double scale = 1 + 0.5 * i / n_sats;
+		cart_elems.push_back(orbsim::CartElem{
+			orbsim::Vec3{7000 * scale, 0, 0},
+			orbsim::Vec3{0, 7.5 / scale, 1}
+		});
+	}
+
+	unsigned max_threads = std::thread::hardware_concurrency();
+	if (max_threads == 0) max_threads = 1;
+
+	std::cout << n_sats << " satellites, " << t_steps << " RK4 steps each\n"
+			  << std::setw(8) << "threads" << std::setw(12) << "time [s]"
+			  << std::setw(14) << "sats/s" << std::setw(10) << "speedup" << "\n";
+
+	// Powers of two up to the core count, plus the core count itself
+	std::vector<unsigned> thread_counts;
+	for (unsigned threads = 1; threads < max_threads; threads *= 2) {
+		thread_counts.push_back(threads);
+	}
+	thread_counts.push_back(max_threads);
+
+	double base_time = 0;
+	for (unsigned threads : thread_counts) {
+		orbsim::ParallelPropagator propagator(threads);
+		propagator.add_sats(cart_elems, "RK4", orbsim::Earth, 0, 86400, t_steps);
+
+		auto start = std::chrono::steady_clock::now();
+		propagator.propagate();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		if (threads == 1) base_time = elapsed.count();
+		std::cout << std::setw(8) << threads
+				  << std::setw(12) << std::fixed << std::setprecision(3) << elapsed.count()
+				  << std::setw(14) << std::setprecision(1) << n_sats / elapsed.count()
+				  << std::setw(10) << std::setprecision(2) << base_time / elapsed.count() << "\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,60 @@
+#include "simulation/integrators/euler.hpp"
+#include "simulation/integrators/verlet.hpp"
+#include "simulation/integrators/rk4.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+
+template <typename I, typename DE>
+double steps_per_sec(DE de_system, int steps, int repeats) {
+	I integ(de_system, orbsim::Earth.mass, orbsim::Earth.radius,
+			orbsim::Vec3{7000, 0, 0}, orbsim::Vec3{0, 5.1, 7.3}, 0, 86400, steps);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < repeats; i++) {
+		integ.set_x0(orbsim::Vec3{7000, 0, 0});
+		integ.set_v0(orbsim::Vec3{0, 5.1, 7.3});
+		integ.integrate();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	return (double) steps * repeats / elapsed.count();
+}
+
+template <template <typename> class I>
+void compare(std::string name, int steps, int repeats) {
+	using namespace orbsim;
+
+	// Before: every RHS evaluation goes through a std::function
+	double generic = steps_per_sec<I<DESystem<Vec3>>>(DESystem<Vec3>(orbit_de), steps, repeats);
+	// After: the RHS is a compile-time functor
+	double fixed = steps_per_sec<I<OrbitDE>>(orbit_de, steps, repeats);
+
+	std::cout << std::setw(8) << name
+			  << std::setw(16) << std::fixed << std::setprecision(0) << generic
+			  << std::setw(16) << fixed
+			  << std::setw(10) << std::setprecision(2) << fixed / generic << "\n";
+}
+
+int main(int argc, char *argv[]) {
+
+	// Usage: rhs_dispatch_bench [steps] [repeats]
+	int steps = argc > 1 ? std::atoi(argv[1]) : 86400;
+	int repeats = argc > 2 ? std::atoi(argv[2]) : 20;
+
+	std::cout << std::setw(8) << "integ" << std::setw(16) << "DESystem [st/s]"
+			  << std::setw(16) << "OrbitDE [st/s]" << std::setw(10) << "speedup" << "\n";
+
+	compare<orbsim::BasicEuler>("Euler", steps, repeats);
+	compare<orbsim::BasicVerlet>("Verlet", steps, repeats);
+	compare<orbsim::BasicRK4>("RK4", steps, repeats);
+
+	return 0;
+}
@@ -1,6 +1,6 @@
 #include "simulation/satellite.hpp"
+#include "simulation/trajectory_sink.hpp"
 
-#include <string>
 #include <iostream>
 
 
@@ -8,15 +8,11 @@ int main(int argc, char *argv[]) {
 
 	// Example of how to use orbsim without a GUI
 
-    orbsim::Satellite sat;
-    orbsim::SimData sim_data = sat.propagate();
+	// The samples are written out as they are computed, so the memory use
+	// doesn't depend on the number of steps
+	orbsim::Satellite sat;
+	orbsim::StreamSink sink(std::cout);
+	sat.propagate(sink);
 
-	std::string output;
-	for (int i = 0; i < sim_data.steps - 1; i++) {
-		output += sim_data.pos_arr[i].to_str() + " " + sim_data.vel_arr[i].to_str() + "\n";
-	}
-
-	std::cout << output << "\n";
-
-    return 0;
+	return 0;
 }
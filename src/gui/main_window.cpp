@@ -7,6 +7,7 @@
 #include "simulation/integrators/rk4.hpp"	
 #include "simulation/math_obj.hpp"
 #include "simulation/satellite.hpp"
+#include "simulation/trajectory_file.hpp"
 
 #include <QComboBox>
 #include <QDoubleSpinBox>
@@ -26,7 +27,7 @@
 
 MainWindow::MainWindow(QWidget *parent)
 	: QMainWindow(parent), ui(new Ui::MainWindow),
-	  sim_data(orbsim::SimData{0, nullptr, nullptr, nullptr}) {
+	  sim_data() {
 
 	ui->setupUi(this);
 
@@ -51,7 +52,9 @@ MainWindow::MainWindow(QWidget *parent)
 	connect(ui->EndTimeSpinBox, &QSpinBox::valueChanged,
 			this, [this](int t_end) {
 				try {
+					// The step count follows, so only the new interval is propagated
 					this->sat.set_t_end(t_end);
+					ui->TimeStepsSpinBox->setValue(this->sat.get_t_steps());
 				} catch (const std::exception &e) {
 					QMessageBox err_msg;
 					err_msg.setText(e.what());
@@ -80,22 +83,44 @@ MainWindow::~MainWindow() {
 
 void MainWindow::export_data() {
 
-	if (this->sim_data.steps == 0) {
+	if (this->sim_data.get_steps() == 0) {
 		QMessageBox err_msg;
 		err_msg.setText("No simulation data found!");
 		err_msg.exec();
 		return;
 	}
 
+	QString binary_filter = tr("Binary Trajectories (*.orbtraj)");
+	QString selected_filter;
 	QString file_path = QFileDialog::getSaveFileName(this,
 		tr("Export Simulated Data"),
 		QStandardPaths::writableLocation(QStandardPaths::DesktopLocation),
-		tr("Text Files (*.txt)")
+		tr("Text Files (*.txt)") + ";;" + binary_filter,
+		&selected_filter
 	);
+	if (file_path.isEmpty()) return;
+
+	if (selected_filter == binary_filter || file_path.endsWith(".orbtraj")) {
+		try {
+			orbsim::write_trajectory(file_path.toStdString(),
+				orbsim::TrajectoryHeader{
+					this->sat.get_integ_name(),
+					this->sat.get_cel_obj(),
+					this->sat.get_t_start(),
+					this->sim_data.get_steps()
+				},
+				sim_data.get_time_arr(), sim_data.get_pos_arr(), sim_data.get_vel_arr());
+		} catch (const std::exception &e) {
+			QMessageBox err_msg;
+			err_msg.setText(e.what());
+			err_msg.exec();
+		}
+		return;
+	}
 
 	std::string output;
-	for (int i = 0; i < sim_data.steps - 1; i++) {
-		output += sim_data.pos_arr[i].to_str() + " " + sim_data.vel_arr[i].to_str() + "\n";
+	for (int i = 0; i < sim_data.get_steps() - 1; i++) {
+		output += sim_data.get_pos_arr()[i].to_str() + " " + sim_data.get_vel_arr()[i].to_str() + "\n";
 	}
 
 	std::ofstream o(file_path.toStdString());
@@ -135,8 +160,8 @@ void MainWindow::simulate() {
 	this->sim_data = this->sat.propagate();
 
 	QString output;
-	for (int i = 0; i < sim_data.steps - 1; i++) {
-		output += sim_data.pos_arr[i].to_str() + " " + sim_data.vel_arr[i].to_str() + "\n";
+	for (int i = 0; i < sim_data.get_steps() - 1; i++) {
+		output += sim_data.get_pos_arr()[i].to_str() + " " + sim_data.get_vel_arr()[i].to_str() + "\n";
 	}
 
 	ui->OutputConsole->setText(output);
@@ -146,6 +171,7 @@ void MainWindow::simulate() {
 void MainWindow::load_example_values() {
 
 	this->sat = orbsim::Satellite();
+	this->sat.set_incremental(true);
 
 	sync_cart_gui();
 	sync_kepl_gui();
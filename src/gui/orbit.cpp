@@ -70,17 +70,17 @@ void Orbit::render() {
 	this->shader_program->release();
 }
 
-void Orbit::update_points(orbsim::SimData sim_data) {
+void Orbit::update_points(const orbsim::SimData &sim_data) {
 
 	if (this->data) delete[] this->data;
-	this->points = 3 * sim_data.steps;
+	this->points = 3 * sim_data.get_steps();
 	this->data = new float[this->points];
 
-    for (int i = 0; i < sim_data.steps; i++) {
+    for (int i = 0; i < sim_data.get_steps(); i++) {
 		// y and z are swapped because OpenGL has the z axis pointing up
-		this->data[3*i + 0] = 0.6 * sim_data.pos_arr[i].x / 10000;		// temporary
-		this->data[3*i + 1] = 0.6 * sim_data.pos_arr[i].z / 10000;		// can't use norm tho
-		this->data[3*i + 2] = 0.6 * sim_data.pos_arr[i].y / 10000;
+		this->data[3*i + 0] = 0.6 * sim_data.get_pos_arr()[i].x / 10000;		// temporary
+		this->data[3*i + 1] = 0.6 * sim_data.get_pos_arr()[i].z / 10000;		// can't use norm tho
+		this->data[3*i + 2] = 0.6 * sim_data.get_pos_arr()[i].y / 10000;
 		// std::cout << data_f[3*i + 0] << " " << data_f[3*i + 1] << " " << data_f[3*i + 2] << "\n";
     }
 
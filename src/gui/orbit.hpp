@@ -20,7 +20,7 @@ public:
 	void create() override;
 	void render() override;
 
-	void update_points(orbsim::SimData sim_data);
+	void update_points(const orbsim::SimData &sim_data);
 
 private:
 	float *data;
@@ -28,7 +28,7 @@ OutputWindow::~OutputWindow() {
 	// makeCurrent();
 }
 
-void OutputWindow::update_sim_data(orbsim::SimData new_data) {
+void OutputWindow::update_sim_data(const orbsim::SimData &new_data) {
 
 	this->orbit.update_points(new_data);
 
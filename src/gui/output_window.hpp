@@ -23,7 +23,7 @@ public:
 	explicit OutputWindow(QWidget *parent = nullptr);
 	~OutputWindow();
 
-	void update_sim_data(orbsim::SimData new_data);
+	void update_sim_data(const orbsim::SimData &new_data);
 
 protected:
     void initializeGL() override;
@@ -14,7 +14,15 @@ const CelestialObj Earth{
 	6378.137	// radius in [km]
 };
 
-// const double M_Sun = 1.989e30;		// Sun Mass in [kg]
+const CelestialObj Sun{
+	1.989e30,	// mass in [kg]
+	696000	// radius in [km]
+};
+
+const CelestialObj Moon{
+	7.342e22,	// mass in [kg]
+	1737.4	// radius in [km]
+};
 
 } // namespace orbsim
 
@@ -0,0 +1,257 @@
+#include "conjunction.hpp"
+
+#include "math_obj.hpp"
+#include "satellite.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace orbsim {
+
+namespace {
+
+// Steps in a window of the thread pool
+const int window_steps = 64;
+
+// Cell coordinates packed into one key, 21 bits each
+std::uint64_t cell_key(std::int64_t ix, std::int64_t iy, std::int64_t iz) {
+	const std::int64_t bias = 1 << 20;
+	const std::uint64_t mask = (1 << 21) - 1;
+	return ((std::uint64_t) (ix + bias) & mask) << 42
+		 | ((std::uint64_t) (iy + bias) & mask) << 21
+		 | ((std::uint64_t) (iz + bias) & mask);
+}
+
+// Relative position on [t0, t1] as a cubic Hermite polynomial in s = 0 ... 1
+struct Hermite {
+	Vec3 p0, m0, p1, m1;
+
+	Vec3 at(double s) const {
+		double s2 = s * s, s3 = s2 * s;
+		double h00 = 2 * s3 - 3 * s2 + 1;
+		double h10 = s3 - 2 * s2 + s;
+		double h01 = -2 * s3 + 3 * s2;
+		double h11 = s3 - s2;
+		return Vec3{
+			h00 * p0.x + h10 * m0.x + h01 * p1.x + h11 * m1.x,
+			h00 * p0.y + h10 * m0.y + h01 * p1.y + h11 * m1.y,
+			h00 * p0.z + h10 * m0.z + h01 * p1.z + h11 * m1.z
+		};
+	}
+};
+
+} // namespace
+
+ConjunctionScreen::ConjunctionScreen(double threshold, unsigned threads)
+	: threshold(threshold), pool(threads) {
+
+	if (threshold <= 0) {
+		throw std::domain_error("Threshold must be a positive number!");
+	}
+}
+
+double ConjunctionScreen::get_threshold() const { return this->threshold; }
+unsigned ConjunctionScreen::get_threads() const { return this->pool.get_threads(); }
+
+std::vector<Conjunction> ConjunctionScreen::screen(const std::vector<SimData> &trajectories) {
+	if (trajectories.size() < 2) return {};
+
+	// Every object is compared at the times of the first one
+	int steps = trajectories[0].get_steps();
+	const double *time_arr = trajectories[0].get_time_arr();
+	double time_tol = 1e-9 * std::max(1.0, std::fabs(time_arr[steps - 1]));
+	for (const SimData &sim_data : trajectories) {
+		if (sim_data.get_steps() != steps) {
+			throw std::domain_error("All trajectories must have the same time steps!");
+		}
+		for (int i = 0; i < steps; i++) {
+			if (std::fabs(sim_data.get_time_arr()[i] - time_arr[i]) > time_tol) {
+				throw std::domain_error("All trajectories must have the same time steps!");
+			}
+		}
+	}
+
+	// Two objects get closer by at most twice the top speed between samples
+	double max_speed = 0;
+	for (const SimData &sim_data : trajectories) {
+		for (int i = 0; i < steps; i++) {
+			max_speed = std::max(max_speed, sim_data.get_vel_arr()[i].len());
+		}
+	}
+	double max_dt = 0;
+	for (int i = 1; i < steps; i++) {
+		max_dt = std::max(max_dt, time_arr[i] - time_arr[i - 1]);
+	}
+	double distance = this->threshold + max_speed * max_dt;
+
+	// Candidates of every window, no locking needed
+	int windows = (steps + window_steps - 1) / window_steps;
+	std::vector<std::vector<Candidate>> found(windows);
+	this->pool.parallel_for(windows, [&](std::size_t window) {
+		int end = std::min(steps, (int) (window + 1) * window_steps);
+		for (int step = (int) window * window_steps; step < end; step++) {
+			screen_step(trajectories, step, distance, found[window]);
+		}
+	});
+
+	std::vector<Candidate> candidates;
+	for (const std::vector<Candidate> &window : found) {
+		candidates.insert(candidates.end(), window.begin(), window.end());
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+		if (a.first != b.first) return a.first < b.first;
+		if (a.second != b.second) return a.second < b.second;
+		return a.step < b.step;
+	});
+
+	// Consecutive steps of a pair are one encounter
+	struct Encounter {
+		std::size_t first, second;
+		int step_begin, step_end;
+	};
+	std::vector<Encounter> encounters;
+	for (const Candidate &c : candidates) {
+		if (!encounters.empty()) {
+			Encounter &last = encounters.back();
+			if (last.first == c.first && last.second == c.second && c.step <= last.step_end + 1) {
+				last.step_end = c.step;
+				continue;
+			}
+		}
+		encounters.push_back(Encounter{c.first, c.second, c.step, c.step});
+	}
+
+	std::vector<Conjunction> refined(encounters.size());
+	this->pool.parallel_for(encounters.size(), [&](std::size_t i) {
+		const Encounter &e = encounters[i];
+		refined[i] = refine(trajectories, e.first, e.second,
+							std::max(0, e.step_begin - 1), std::min(steps - 1, e.step_end + 1));
+	});
+
+	std::vector<Conjunction> conjunctions;
+	for (const Conjunction &c : refined) {
+		if (c.miss_distance < this->threshold) conjunctions.push_back(c);
+	}
+	std::sort(conjunctions.begin(), conjunctions.end(), [](const Conjunction &a, const Conjunction &b) {
+		if (a.tca != b.tca) return a.tca < b.tca;
+		if (a.first != b.first) return a.first < b.first;
+		return a.second < b.second;
+	});
+	return conjunctions;
+}
+
+void ConjunctionScreen::screen_step(const std::vector<SimData> &trajectories, int step,
+									double distance, std::vector<Candidate> &candidates) const {
+	// Objects sorted by cell, a cell is a range of the array
+	std::vector<std::pair<std::uint64_t, std::size_t>> cells(trajectories.size());
+	for (std::size_t i = 0; i < trajectories.size(); i++) {
+		const Vec3 &p = trajectories[i].get_pos_arr()[step];
+		cells[i] = {cell_key((std::int64_t) std::floor(p.x / distance),
+							 (std::int64_t) std::floor(p.y / distance),
+							 (std::int64_t) std::floor(p.z / distance)), i};
+	}
+	std::sort(cells.begin(), cells.end());
+
+	double distance2 = distance * distance;
+	auto check = [&](std::size_t i, std::size_t j) {
+		const Vec3 &a = trajectories[i].get_pos_arr()[step];
+		const Vec3 &b = trajectories[j].get_pos_arr()[step];
+		double dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+		if (dx*dx + dy*dy + dz*dz < distance2) {
+			candidates.push_back(Candidate{std::min(i, j), std::max(i, j), step});
+		}
+	};
+
+	for (std::size_t begin = 0; begin < cells.size();) {
+		std::size_t end = begin;
+		while (end < cells.size() && cells[end].first == cells[begin].first) end++;
+
+		// Pairs inside the cell
+		for (std::size_t a = begin; a < end; a++) {
+			for (std::size_t b = a + 1; b < end; b++) check(cells[a].second, cells[b].second);
+		}
+
+		// Half of the 26 neighbours, the other half finds this cell in turn
+		const Vec3 &p = trajectories[cells[begin].second].get_pos_arr()[step];
+		std::int64_t ix = (std::int64_t) std::floor(p.x / distance);
+		std::int64_t iy = (std::int64_t) std::floor(p.y / distance);
+		std::int64_t iz = (std::int64_t) std::floor(p.z / distance);
+		for (int dx = -1; dx <= 1; dx++) {
+			for (int dy = -1; dy <= 1; dy++) {
+				for (int dz = -1; dz <= 1; dz++) {
+					if (dx * 9 + dy * 3 + dz <= 0) continue;
+					std::uint64_t key = cell_key(ix + dx, iy + dy, iz + dz);
+					auto lo = std::lower_bound(cells.begin(), cells.end(), std::make_pair(key, (std::size_t) 0));
+					for (auto it = lo; it != cells.end() && it->first == key; ++it) {
+						for (std::size_t a = begin; a < end; a++) check(cells[a].second, it->second);
+					}
+				}
+			}
+		}
+		begin = end;
+	}
+}
+
+Conjunction ConjunctionScreen::refine(const std::vector<SimData> &trajectories, std::size_t first_idx,
+									  std::size_t second_idx, int step_begin, int step_end) const {
+	const SimData &first = trajectories[first_idx];
+	const SimData &second = trajectories[second_idx];
+	Conjunction best{first_idx, second_idx, first.get_time_arr()[step_begin],
+					 (first.get_pos_arr()[step_begin] - second.get_pos_arr()[step_begin]).len()};
+
+	for (int i = step_begin; i < step_end; i++) {
+		double t0 = first.get_time_arr()[i];
+		double dt = first.get_time_arr()[i + 1] - t0;
+		Hermite rel{
+			first.get_pos_arr()[i] - second.get_pos_arr()[i],
+			(first.get_vel_arr()[i] - second.get_vel_arr()[i]) * dt,
+			first.get_pos_arr()[i + 1] - second.get_pos_arr()[i + 1],
+			(first.get_vel_arr()[i + 1] - second.get_vel_arr()[i + 1]) * dt
+		};
+
+		// Golden section search, the distance has one minimum within a step
+		const double ratio = 0.5 * (std::sqrt(5.0) - 1);
+		double lo = 0, hi = 1;
+		double s1 = hi - ratio * (hi - lo), s2 = lo + ratio * (hi - lo);
+		double d1 = rel.at(s1).len(), d2 = rel.at(s2).len();
+		while (hi - lo > 1e-9) {
+			if (d1 < d2) {
+				hi = s2;
+				s2 = s1;
+				d2 = d1;
+				s1 = hi - ratio * (hi - lo);
+				d1 = rel.at(s1).len();
+			} else {
+				lo = s1;
+				s1 = s2;
+				d1 = d2;
+				s2 = lo + ratio * (hi - lo);
+				d2 = rel.at(s2).len();
+			}
+		}
+
+		double s = 0.5 * (lo + hi);
+		double d = rel.at(s).len();
+		for (double end : {0.0, 1.0}) {
+			double d_end = rel.at(end).len();
+			if (d_end < d) {
+				d = d_end;
+				s = end;
+			}
+		}
+		if (d < best.miss_distance) {
+			best.tca = t0 + s * dt;
+			best.miss_distance = d;
+		}
+	}
+	return best;
+}
+
+} // namespace orbsim
@@ -0,0 +1,61 @@
+#ifndef CONJUNCTION_HPP
+#define CONJUNCTION_HPP
+
+#include "simulation/satellite.hpp"
+#include "simulation/thread_pool.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace orbsim {
+
+struct Conjunction {
+	std::size_t first;	// indices of the objects, first < second
+	std::size_t second;
+	double tca;	// time of closest approach [s]
+	double miss_distance;	// [km]
+};
+
+/**
+ * @brief Finds the close approaches between many trajectories
+ *
+ * At every step the positions go into a uniform spatial hash with cells as
+ * big as the screening distance, so only objects in neighbouring cells are
+ * compared. The screening distance adds to the threshold how far two objects
+ * can get closer between samples. The candidates are refined to the time of
+ * closest approach on the cubic Hermite interpolant of the relative motion.
+ *
+ * All trajectories need the same time steps, screen() throws otherwise. The
+ * steps are split into windows screened on the threads of a pool.
+ */
+class ConjunctionScreen {
+
+public:
+	explicit ConjunctionScreen(double threshold, unsigned threads = 0);
+
+	double get_threshold() const;
+	unsigned get_threads() const;
+
+	std::vector<Conjunction> screen(const std::vector<SimData> &trajectories);
+
+private:
+	struct Candidate {
+		std::size_t first;
+		std::size_t second;
+		int step;
+	};
+
+	void screen_step(const std::vector<SimData> &trajectories, int step, double distance,
+					 std::vector<Candidate> &candidates) const;
+	Conjunction refine(const std::vector<SimData> &trajectories, std::size_t first,
+					   std::size_t second, int step_begin, int step_end) const;
+
+	double threshold;	// [km]
+	ThreadPool pool;
+};
+
+} // namespace orbsim
+
+
+#endif	// CONJUNCTION_HPP
@@ -0,0 +1,167 @@
+#include "constellation.hpp"
+
+#include "integrators/rk4_simd.hpp"
+#include "celestial_obj.hpp"
+#include "math_obj.hpp"
+#include "orbital_elements.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+
+namespace orbsim {
+
+namespace {
+
+// -x/|x|^3 in dimensionless units, kept inline so the loops below vectorize
+inline void point_mass_accel(double x, double y, double z,
+							 double &ax, double &ay, double &az) {
+	double r2 = x*x + y*y + z*z;
+	double inv_r3 = 1 / (r2 * std::sqrt(r2));
+	ax = - x * inv_r3;
+	ay = - y * inv_r3;
+	az = - z * inv_r3;
+}
+
+} // namespace
+
+Constellation::Constellation(std::string integ_name, CelestialObj cel_obj,
+							 double t_start, double t_end, int t_steps)
+	: integ_name(integ_name), cel_obj(cel_obj),
+	  t_start(t_start), t_end(t_end), t_steps(t_steps) {
+
+	if (integ_name != "Euler" && integ_name != "Verlet" && integ_name != "RK4") {
+		throw std::domain_error("Invalid integrator! Should be one of: Euler, Verlet and RK4");
+	}
+	if (t_start < 0) {
+		throw std::domain_error("Start time must be a positive integer!");
+	}
+	if (t_start >= t_end) {
+		throw std::domain_error("Start time must be smaller than end time!");
+	}
+	if (t_steps <= 0) {
+		throw std::domain_error("Steps must be a positive integer!");
+	}
+
+	// Same norming constants as Integrator
+	this->R_dim = cel_obj.radius;	// [km]
+	this->V_dim = std::sqrt((cel_obj.mass * G)/(1000*cel_obj.radius))/1000;	// [km/sec]
+	this->T_dim = R_dim / V_dim;	// [sec]
+}
+
+std::size_t Constellation::size() const { return this->x0.size(); }
+std::string Constellation::get_integ_name() const { return this->integ_name; }
+double Constellation::get_t_start() const { return this->t_start; }
+double Constellation::get_t_end() const { return this->t_end; }
+int Constellation::get_t_steps() const { return this->t_steps; }
+
+void Constellation::add_sat(CartElem cart_elem) {
+	this->x0.push_back(cart_elem.pos.x);
+	this->y0.push_back(cart_elem.pos.y);
+	this->z0.push_back(cart_elem.pos.z);
+	this->vx0.push_back(cart_elem.vel.x);
+	this->vy0.push_back(cart_elem.vel.y);
+	this->vz0.push_back(cart_elem.vel.z);
+
+	this->x.push_back(cart_elem.pos.x / R_dim);
+	this->y.push_back(cart_elem.pos.y / R_dim);
+	this->z.push_back(cart_elem.pos.z / R_dim);
+	this->vx.push_back(cart_elem.vel.x / V_dim);
+	this->vy.push_back(cart_elem.vel.y / V_dim);
+	this->vz.push_back(cart_elem.vel.z / V_dim);
+}
+
+void Constellation::add_sat(KeplElem kepl_elem) {
+	if (kepl_elem.ecc < 0 || kepl_elem.ecc >= 1) {
+		throw std::domain_error("Eccentricity must be a number between 0 and 1");
+	}
+	add_sat(kepl_to_cart(kepl_elem, this->cel_obj));
+}
+
+CartElem Constellation::get_cart_elem(std::size_t idx) const {
+	return CartElem{
+		Vec3{this->x[idx], this->y[idx], this->z[idx]} * R_dim,
+		Vec3{this->vx[idx], this->vy[idx], this->vz[idx]} * V_dim
+	};
+}
+
+void Constellation::propagate(std::function<void(int step, const Constellation &)> on_step) {
+	// Start over from the initial states
+	for (std::size_t i = 0; i < size(); i++) {
+		this->x[i] = this->x0[i] / R_dim;
+		this->y[i] = this->y0[i] / R_dim;
+		this->z[i] = this->z0[i] / R_dim;
+		this->vx[i] = this->vx0[i] / V_dim;
+		this->vy[i] = this->vy0[i] / V_dim;
+		this->vz[i] = this->vz0[i] / V_dim;
+	}
+
+	double delta_t = (this->t_end - this->t_start) / (this->t_steps - 1) / T_dim;
+
+	if (on_step) on_step(0, *this);
+	for (int i = 1; i < this->t_steps; i++) {
+		if (this->integ_name == "Euler") {
+			step_euler(delta_t);
+		} else if (this->integ_name == "Verlet") {
+			step_verlet(delta_t);
+		} else {
+			step_rk4(delta_t);
+		}
+		if (on_step) on_step(i, *this);
+	}
+}
+
+void Constellation::step_euler(double dt) {
+	double *x = this->x.data(), *y = this->y.data(), *z = this->z.data();
+	double *vx = this->vx.data(), *vy = this->vy.data(), *vz = this->vz.data();
+	std::size_t n = size();
+
+	for (std::size_t i = 0; i < n; i++) {
+		double ax, ay, az;
+		point_mass_accel(x[i], y[i], z[i], ax, ay, az);
+
+		x[i] += vx[i] * dt;
+		y[i] += vy[i] * dt;
+		z[i] += vz[i] * dt;
+		vx[i] += ax * dt;
+		vy[i] += ay * dt;
+		vz[i] += az * dt;
+	}
+}
+
+void Constellation::step_verlet(double dt) {
+	double *x = this->x.data(), *y = this->y.data(), *z = this->z.data();
+	double *vx = this->vx.data(), *vy = this->vy.data(), *vz = this->vz.data();
+	std::size_t n = size();
+
+	for (std::size_t i = 0; i < n; i++) {
+		double ax, ay, az;
+		point_mass_accel(x[i], y[i], z[i], ax, ay, az);
+
+		// Kick - drift - kick
+		double vx_half = vx[i] + ax * (dt/2);
+		double vy_half = vy[i] + ay * (dt/2);
+		double vz_half = vz[i] + az * (dt/2);
+		x[i] += vx_half * dt;
+		y[i] += vy_half * dt;
+		z[i] += vz_half * dt;
+
+		point_mass_accel(x[i], y[i], z[i], ax, ay, az);
+		vx[i] = vx_half + ax * (dt/2);
+		vy[i] = vy_half + ay * (dt/2);
+		vz[i] = vz_half + az * (dt/2);
+	}
+}
+
+void Constellation::step_rk4(double dt) {
+	SoAState state{
+		this->x.data(), this->y.data(), this->z.data(),
+		this->vx.data(), this->vy.data(), this->vz.data()
+	};
+	rk4_step_soa(state, size(), dt);
+}
+
+} // namespace orbsim
@@ -0,0 +1,69 @@
+#ifndef CONSTELLATION_HPP
+#define CONSTELLATION_HPP
+
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace orbsim {
+
+/**
+ * @brief Group of satellites propagated together
+ *
+ * The states are kept in structure-of-arrays form (one contiguous array per
+ * coordinate) so every step streams through memory without touching a
+ * separate integrator per satellite. RK4 steps go through the SIMD kernels
+ * in rk4_simd.hpp.
+ */
+class Constellation {
+
+public:
+	Constellation(std::string integ_name = "RK4", CelestialObj cel_obj = Earth,
+				  double t_start = 0, double t_end = 86400, int t_steps = 8640);
+
+	std::size_t size() const;
+	std::string get_integ_name() const;
+	double get_t_start() const;
+	double get_t_end() const;
+	int get_t_steps() const;
+
+	void add_sat(CartElem cart_elem);
+	void add_sat(KeplElem kepl_elem);
+
+	CartElem get_cart_elem(std::size_t idx) const;
+
+	void propagate(std::function<void(int step, const Constellation &)> on_step = nullptr);
+
+private:
+	void step_euler(double dt);
+	void step_verlet(double dt);
+	void step_rk4(double dt);
+
+	std::string integ_name;
+	CelestialObj cel_obj;
+	double t_start;
+	double t_end;
+	int t_steps;
+
+	// Initial states [km], [km/s]
+	std::vector<double> x0, y0, z0;
+	std::vector<double> vx0, vy0, vz0;
+
+	// Current states in dimensionless units
+	std::vector<double> x, y, z;
+	std::vector<double> vx, vy, vz;
+
+	double R_dim;
+	double V_dim;
+	double T_dim;
+};
+
+} // namespace orbsim
+
+
+#endif	// CONSTELLATION_HPP
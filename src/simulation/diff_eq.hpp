@@ -30,15 +30,38 @@ public:
 		return this->equations[order];
 	}
 
+	// Right-hand side of the second order equation, as called by the integrators
+	T accel(double, const T &x, const T &) const {
+		return this->equations[2](x);
+	}
+
 private:
 	std::vector<std::function<T(T x)>> equations;
 };
 
-const DESystem<Vec3> orbit_de({
-	[](Vec3 x) { return x; },
-	[](Vec3 v) { return v; },
-	[](Vec3 x) { return - x / std::pow(x.len(), 3); },
-});
+/**
+ * @brief Point-mass gravity (in dimensionless units) known at compile time
+ *
+ * Integrators instantiated with this type call accel() directly instead of
+ * going through a std::function, so it can be inlined into their loops.
+ */
+struct OrbitDE {
+	Vec3 accel(double, const Vec3 &x, const Vec3 &) const {
+		double r = x.len();
+		return - x / (r*r*r);
+	}
+
+	// The same system for code that works with the generic DESystem
+	operator DESystem<Vec3>() const {
+		return DESystem<Vec3>({
+			[](Vec3 x) { return x; },
+			[](Vec3 v) { return v; },
+			[](Vec3 x) { return - x / std::pow(x.len(), 3); },
+		});
+	}
+};
+
+const OrbitDE orbit_de{};
 
 } // namespace orbsim
 
@@ -0,0 +1,186 @@
+#include "events.hpp"
+
+#include "celestial_obj.hpp"
+#include "math_obj.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace orbsim {
+
+namespace {
+
+// State on [t0, t1] from the cubic Hermite polynomial of the samples at its ends
+struct Segment {
+	double t0, h;
+	Vec3 p0, v0, p1, v1;
+
+	void at(double t, Vec3 &pos, Vec3 &vel) const {
+		double s = (t - this->t0) / this->h;
+		double s2 = s * s, s3 = s2 * s;
+		double h00 = 2*s3 - 3*s2 + 1, h10 = (s3 - 2*s2 + s) * this->h;
+		double h01 = -2*s3 + 3*s2, h11 = (s3 - s2) * this->h;
+		double d00 = (6*s2 - 6*s) / this->h, d10 = 3*s2 - 4*s + 1;
+		double d01 = (-6*s2 + 6*s) / this->h, d11 = 3*s2 - 2*s;
+		pos = h00 * this->p0 + h10 * this->v0 + h01 * this->p1 + h11 * this->v1;
+		vel = d00 * this->p0 + d10 * this->v0 + d01 * this->p1 + d11 * this->v1;
+	}
+};
+
+// Whether going from g0 to g1 is a zero in the direction
+bool crosses(double g0, double g1, int direction) {
+	bool rising = g0 < 0 && g1 >= 0;
+	bool falling = g0 > 0 && g1 <= 0;
+	return (direction >= 0 && rising) || (direction <= 0 && falling);
+}
+
+} // namespace
+
+EventFunction periapsis_event(bool terminal) {
+	// The radial velocity goes from negative to positive
+	return EventFunction{"Periapsis", [](double, const Vec3 &pos, const Vec3 &vel) {
+		return pos.dot(vel);
+	}, 1, terminal};
+}
+
+EventFunction apoapsis_event(bool terminal) {
+	return EventFunction{"Apoapsis", [](double, const Vec3 &pos, const Vec3 &vel) {
+		return pos.dot(vel);
+	}, -1, terminal};
+}
+
+EventFunction altitude_event(double altitude, CelestialObj cel_obj, int direction, bool terminal) {
+	if (direction < -1 || direction > 1) {
+		throw std::domain_error("Direction must be -1, 0 or 1!");
+	}
+	double radius = cel_obj.radius + altitude;
+	return EventFunction{"Altitude " + std::to_string(altitude), [radius](double, const Vec3 &pos, const Vec3 &) {
+		return pos.len() - radius;
+	}, direction, terminal};
+}
+
+EventFunction impact_event(CelestialObj cel_obj) {
+	EventFunction impact = altitude_event(0, cel_obj, -1, true);
+	impact.name = "Impact";
+	return impact;
+}
+
+EventFunction ascending_node_event(bool terminal) {
+	return EventFunction{"Ascending node", [](double, const Vec3 &pos, const Vec3 &) {
+		return pos.z;
+	}, 1, terminal};
+}
+
+EventFunction descending_node_event(bool terminal) {
+	return EventFunction{"Descending node", [](double, const Vec3 &pos, const Vec3 &) {
+		return pos.z;
+	}, -1, terminal};
+}
+
+EventDetector::EventDetector(const std::vector<EventFunction> &functions) {
+	for (const EventFunction &function : functions) add(function);
+}
+
+void EventDetector::add(const EventFunction &function) {
+	if (!function.g) {
+		throw std::domain_error("Event function " + function.name + " is empty!");
+	}
+	if (function.direction < -1 || function.direction > 1) {
+		throw std::domain_error("Direction must be -1, 0 or 1!");
+	}
+	this->functions.push_back(function);
+}
+
+std::size_t EventDetector::size() const { return this->functions.size(); }
+const EventFunction &EventDetector::get_function(std::size_t i) const { return this->functions.at(i); }
+const std::vector<Event> &EventDetector::get_events() const { return this->events; }
+bool EventDetector::get_stopped() const { return this->stopped; }
+
+std::vector<Event> EventDetector::get_events(const std::string &name) const {
+	std::vector<Event> named;
+	for (const Event &event : this->events) {
+		if (this->functions[event.function].name == name) named.push_back(event);
+	}
+	return named;
+}
+
+void EventDetector::begin(double t, const Vec3 &pos, const Vec3 &vel) {
+	this->events.clear();
+	this->stopped = false;
+	this->t_prev = t;
+	this->pos_prev = pos;
+	this->vel_prev = vel;
+	this->g_prev.resize(this->functions.size());
+	for (std::size_t i = 0; i < this->functions.size(); i++) {
+		this->g_prev[i] = this->functions[i].g(t, pos, vel);
+	}
+}
+
+bool EventDetector::step(double t, const Vec3 &pos, const Vec3 &vel) {
+	if (this->stopped) return false;
+
+	std::size_t first = this->events.size();
+	for (std::size_t i = 0; i < this->functions.size(); i++) {
+		double g = this->functions[i].g(t, pos, vel);
+		if (crosses(this->g_prev[i], g, this->functions[i].direction)) {
+			this->events.push_back(refine(i, t, pos, vel, g));
+		}
+		this->g_prev[i] = g;
+	}
+	this->t_prev = t;
+	this->pos_prev = pos;
+	this->vel_prev = vel;
+
+	// Events of this step in time order, none after the first terminal one
+	std::sort(this->events.begin() + first, this->events.end(), [](const Event &a, const Event &b) {
+		return a.t < b.t;
+	});
+	for (std::size_t i = first; i < this->events.size(); i++) {
+		if (this->functions[this->events[i].function].terminal) {
+			this->events.resize(i + 1);
+			this->stopped = true;
+			return false;
+		}
+	}
+	return true;
+}
+
+Event EventDetector::refine(std::size_t function, double t, const Vec3 &pos, const Vec3 &vel, double g) const {
+	const EventFunction &f = this->functions[function];
+	Segment segment{this->t_prev, t - this->t_prev, this->pos_prev, this->vel_prev, pos, vel};
+
+	// Illinois method, regula falsi that halves the value kept at a stale end
+	double a = this->t_prev, fa = this->g_prev[function];
+	double b = t, fb = g;
+	double c = b;
+	Vec3 c_pos = pos, c_vel = vel;
+	int side = 0;
+	double tol = 1e-12 * std::max(1.0, std::fabs(t));
+	for (int iter = 0; iter < 100 && b - a > tol; iter++) {
+		c = (a * fb - b * fa) / (fb - fa);
+		segment.at(c, c_pos, c_vel);
+		double fc = f.g(c, c_pos, c_vel);
+		if (fc == 0) break;
+
+		if ((fc > 0) == (fb > 0)) {
+			b = c;
+			fb = fc;
+			if (side == -1) fa /= 2;
+			side = -1;
+		} else {
+			a = c;
+			fa = fc;
+			if (side == 1) fb /= 2;
+			side = 1;
+		}
+		if (std::fabs(fc) <= 1e-15 * std::max(std::fabs(fa), std::fabs(fb))) break;
+	}
+	return Event{function, c, c_pos, c_vel};
+}
+
+} // namespace orbsim
@@ -0,0 +1,88 @@
+#ifndef EVENTS_HPP
+#define EVENTS_HPP
+
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace orbsim {
+
+/**
+ * @brief Function of the state whose zeros are events
+ *
+ * The time is in [s], the state in [km] and [km/s]. A direction of 1 only
+ * counts zeros where the function goes from negative to positive, -1 the
+ * other way and 0 both. A terminal event ends the propagation.
+ */
+struct EventFunction {
+	std::string name;
+	std::function<double(double t, const Vec3 &pos, const Vec3 &vel)> g;
+	int direction;
+	bool terminal;
+};
+
+struct Event {
+	std::size_t function;	// index in the detector
+	double t;	// [s]
+	Vec3 pos;	// [km]
+	Vec3 vel;	// [km/s]
+};
+
+EventFunction periapsis_event(bool terminal = false);
+EventFunction apoapsis_event(bool terminal = false);
+EventFunction altitude_event(double altitude, CelestialObj cel_obj = Earth,
+							 int direction = 0, bool terminal = false);
+EventFunction impact_event(CelestialObj cel_obj = Earth);
+EventFunction ascending_node_event(bool terminal = false);
+EventFunction descending_node_event(bool terminal = false);
+
+/**
+ * @brief Finds the events along a trajectory while it is integrated
+ *
+ * Every stored sample is checked against the previous one. When an event
+ * function changes sign between them, its zero is found with the Illinois
+ * method on the cubic Hermite interpolant of the step, so the integrator
+ * takes no extra steps. The events of a step are kept in time order and a
+ * terminal one drops the events after it.
+ */
+class EventDetector {
+
+public:
+	EventDetector() = default;
+	explicit EventDetector(const std::vector<EventFunction> &functions);
+
+	void add(const EventFunction &function);
+
+	std::size_t size() const;
+	const EventFunction &get_function(std::size_t i) const;
+	const std::vector<Event> &get_events() const;
+	std::vector<Event> get_events(const std::string &name) const;
+	bool get_stopped() const;
+
+	// Called by the integrators with every sample, false after a terminal event
+	void begin(double t, const Vec3 &pos, const Vec3 &vel);
+	bool step(double t, const Vec3 &pos, const Vec3 &vel);
+
+private:
+	Event refine(std::size_t function, double t, const Vec3 &pos, const Vec3 &vel, double g) const;
+
+	std::vector<EventFunction> functions;
+	std::vector<Event> events;
+	bool stopped = false;
+
+	// Previous sample and the values of the functions there
+	double t_prev = 0;
+	Vec3 pos_prev{0, 0, 0};
+	Vec3 vel_prev{0, 0, 0};
+	std::vector<double> g_prev;
+};
+
+} // namespace orbsim
+
+
+#endif	// EVENTS_HPP
@@ -0,0 +1,129 @@
+#include "atmosphere.hpp"
+#include "hash.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace orbsim {
+
+namespace {
+
+// Piecewise exponential atmosphere, base altitude [km], density [kg/m^3], scale height [km]
+const double exp_altitudes[] = {
+	0, 25, 30, 40, 50, 60, 70, 80, 90, 100, 110, 120, 130, 140,
+	150, 180, 200, 250, 300, 350, 400, 450, 500, 600, 700, 800, 900, 1000
+};
+const double exp_densities[] = {
+	1.225, 3.899e-2, 1.774e-2, 3.972e-3, 1.057e-3, 3.206e-4, 8.770e-5, 1.905e-5, 3.396e-6, 5.297e-7,
+	9.661e-8, 2.438e-8, 8.484e-9, 3.845e-9, 2.070e-9, 5.464e-10, 2.789e-10, 7.248e-11, 2.418e-11,
+	9.518e-12, 3.725e-12, 1.585e-12, 6.967e-13, 1.454e-13, 3.614e-14, 1.170e-14, 5.245e-15, 3.019e-15
+};
+const double exp_scale_heights[] = {
+	7.249, 6.349, 6.682, 7.554, 8.382, 7.714, 6.549, 5.799, 5.382, 5.877, 7.263, 9.473, 12.636,
+	16.149, 22.523, 29.740, 37.105, 45.546, 53.628, 53.298, 58.515, 60.828, 63.822, 71.835,
+	88.667, 124.64, 181.05, 268.00
+};
+
+// The last band of the exponential model goes on up to here [km]
+const double exp_max_altitude = 1500;
+
+} // namespace
+
+Atmosphere::Atmosphere(double step) {
+	std::vector<double> altitudes(std::begin(exp_altitudes), std::end(exp_altitudes));
+	std::vector<double> densities(std::begin(exp_densities), std::end(exp_densities));
+	std::vector<double> scale_heights(std::begin(exp_scale_heights), std::end(exp_scale_heights));
+	build(altitudes, densities, scale_heights, exp_max_altitude, step);
+}
+
+Atmosphere::Atmosphere(const std::vector<double> &altitudes, const std::vector<double> &densities,
+					   double step) {
+	if (altitudes.size() < 2 || altitudes.size() != densities.size()) {
+		throw std::domain_error("Need at least two altitudes, each with a density!");
+	}
+
+	// Scale heights between the given points
+	std::vector<double> scale_heights(altitudes.size() - 1);
+	for (std::size_t i = 0; i + 1 < altitudes.size(); i++) {
+		if (altitudes[i + 1] <= altitudes[i]) {
+			throw std::domain_error("Altitudes must be increasing!");
+		}
+		if (densities[i] <= 0 || densities[i + 1] <= 0) {
+			throw std::domain_error("Densities must be positive numbers!");
+		}
+		scale_heights[i] = (altitudes[i + 1] - altitudes[i]) / std::log(densities[i] / densities[i + 1]);
+	}
+
+	std::vector<double> bands(altitudes.begin(), altitudes.end() - 1);
+	std::vector<double> band_densities(densities.begin(), densities.end() - 1);
+	build(bands, band_densities, scale_heights, altitudes.back(), step);
+}
+
+Atmosphere::Atmosphere(const std::string &filename, double step) {
+	std::ifstream file(filename);
+	if (!file) {
+		throw std::runtime_error("Could not open " + filename + "!");
+	}
+
+	// Lines of "altitude density", anything else is skipped
+	std::vector<double> altitudes, densities;
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream fields(line);
+		double altitude, density;
+		if (fields >> altitude >> density) {
+			altitudes.push_back(altitude);
+			densities.push_back(density);
+		}
+	}
+
+	*this = Atmosphere(altitudes, densities, step);
+}
+
+double Atmosphere::get_min_altitude() const { return this->min_altitude; }
+double Atmosphere::get_max_altitude() const { return this->min_altitude + this->table.size() * this->step; }
+double Atmosphere::get_step() const { return this->step; }
+std::uint64_t Atmosphere::get_hash() const { return this->hash; }
+
+void Atmosphere::build(const std::vector<double> &altitudes, const std::vector<double> &densities,
+					   const std::vector<double> &scale_heights, double max_altitude, double step) {
+	if (step <= 0) {
+		throw std::domain_error("Step must be a positive number!");
+	}
+
+	// Density of the exponential bands
+	auto model = [&](double altitude) {
+		std::size_t band = std::upper_bound(altitudes.begin(), altitudes.end(), altitude) - altitudes.begin();
+		band = band == 0 ? 0 : band - 1;
+		return densities[band] * std::exp(-(altitude - altitudes[band]) / scale_heights[band]);
+	};
+
+	this->min_altitude = altitudes.front();
+	this->step = step;
+	this->inv_step = 1 / step;
+
+	int cells = (int) std::ceil((max_altitude - this->min_altitude) / step);
+	this->table.resize(cells);
+	for (int i = 0; i < cells; i++) {
+		double bottom = this->min_altitude + i * step;
+		double top = std::min(bottom + step, max_altitude);
+		double rho_bottom = model(bottom);
+		double rho_top = model(top - 1e-9 * step);
+		this->table[i] = Cell{rho_bottom, std::log(rho_bottom / rho_top) / (top - bottom)};
+	}
+
+	Fnv1a fnv;
+	fnv.add(this->min_altitude);
+	fnv.add(this->step);
+	fnv.add(this->table.data(), this->table.size() * sizeof(Cell));
+	this->hash = fnv.value;
+}
+
+} // namespace orbsim
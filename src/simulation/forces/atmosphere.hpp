@@ -0,0 +1,67 @@
+#ifndef ATMOSPHERE_HPP
+#define ATMOSPHERE_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace orbsim {
+
+/**
+ * @brief Atmospheric density as a function of altitude, from a lookup table
+ *
+ * The density model is only evaluated when the table is built. The table has
+ * cells of equal height, so a lookup is an index computation and one
+ * exponential within the cell. Each cell holds its density and scale height
+ * next to each other.
+ *
+ * The models are the piecewise exponential atmosphere (Vallado, Fundamentals
+ * of Astrodynamics, table 8-4) or densities at given altitudes, which are
+ * interpolated exponentially.
+ */
+class Atmosphere {
+
+public:
+	explicit Atmosphere(double step = 1);
+	Atmosphere(const std::vector<double> &altitudes, const std::vector<double> &densities,
+			   double step = 1);
+	Atmosphere(const std::string &filename, double step = 1);
+
+	double get_min_altitude() const;
+	double get_max_altitude() const;
+	double get_step() const;
+	std::uint64_t get_hash() const;
+
+	// Altitude in [km], density in [kg/m^3], none above the table
+	double density(double altitude) const {
+		double pos = (altitude - this->min_altitude) * this->inv_step;
+		if (pos >= this->table.size()) return 0;
+		if (pos < 0) pos = 0;
+
+		int idx = (int) pos;
+		const Cell &cell = this->table[idx];
+		return cell.density * std::exp(-(pos - idx) * this->step * cell.inv_scale_height);
+	}
+
+private:
+	struct Cell {
+		double density;	// at the bottom of the cell
+		double inv_scale_height;	// [1/km]
+	};
+
+	void build(const std::vector<double> &altitudes, const std::vector<double> &densities,
+			   const std::vector<double> &scale_heights, double max_altitude, double step);
+
+	double min_altitude;
+	double step;
+	double inv_step;
+	std::vector<Cell> table;
+	std::uint64_t hash;
+};
+
+} // namespace orbsim
+
+
+#endif	// ATMOSPHERE_HPP
@@ -0,0 +1,121 @@
+#include "force_model.hpp"
+#include "atmosphere.hpp"
+#include "geopotential.hpp"
+#include "third_body.hpp"
+#include "celestial_obj.hpp"
+#include "hash.hpp"
+#include "math_obj.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+
+namespace orbsim {
+
+ForceModelDE::ForceModelDE(CelestialObj cel_obj)
+	: cel_obj(cel_obj), geopotential(nullptr), rotation_rate(0), rotation_angle(0),
+	  atmosphere(nullptr), ballistic_coeff(0), atmosphere_rotation_rate(0),
+	  ephemeris(nullptr), mu_sun(G * Sun.mass / 1e9), mu_moon(G * Moon.mass / 1e9) {
+
+	// Same units as the integrators
+	this->R_dim = cel_obj.radius;	// [km]
+	this->V_dim = std::sqrt((cel_obj.mass * G)/(1000*cel_obj.radius))/1000;	// [km/sec]
+	this->T_dim = this->R_dim / this->V_dim;	// [sec]
+	this->A_dim = this->V_dim / this->T_dim;	// [km/sec^2]
+}
+
+const Geopotential *ForceModelDE::get_geopotential() const { return this->geopotential; }
+const Atmosphere *ForceModelDE::get_atmosphere() const { return this->atmosphere; }
+double ForceModelDE::get_ballistic_coeff() const { return this->ballistic_coeff; }
+const Ephemeris *ForceModelDE::get_ephemeris() const { return this->ephemeris; }
+
+std::uint64_t ForceModelDE::hash() const {
+	Fnv1a fnv;
+	fnv.add(this->cel_obj.mass);
+	fnv.add(this->cel_obj.radius);
+	if (this->geopotential != nullptr) {
+		fnv.add(this->geopotential->get_hash());
+		fnv.add(this->rotation_rate);
+		fnv.add(this->rotation_angle);
+	}
+	if (this->atmosphere != nullptr) {
+		fnv.add(this->atmosphere->get_hash());
+		fnv.add(this->ballistic_coeff);
+		fnv.add(this->atmosphere_rotation_rate);
+	}
+	if (this->ephemeris != nullptr) {
+		fnv.add(this->ephemeris->get_hash());
+	}
+	return fnv.value;
+}
+
+void ForceModelDE::set_geopotential(const Geopotential *geopotential,
+									double rotation_rate, double rotation_angle) {
+	this->geopotential = geopotential;
+	this->rotation_rate = rotation_rate;
+	this->rotation_angle = rotation_angle;
+}
+
+void ForceModelDE::set_drag(const Atmosphere *atmosphere, double ballistic_coeff,
+							double rotation_rate) {
+	if (ballistic_coeff < 0) {
+		throw std::domain_error("Ballistic coefficient must be a positive number!");
+	}
+	this->atmosphere = atmosphere;
+	this->ballistic_coeff = ballistic_coeff;
+	this->atmosphere_rotation_rate = rotation_rate;
+}
+
+void ForceModelDE::set_third_body(const Ephemeris *ephemeris) {
+	this->ephemeris = ephemeris;
+}
+
+Vec3 ForceModelDE::accel(double t, const Vec3 &x, const Vec3 &v) const {
+	Vec3 a;
+	if (this->geopotential == nullptr) {
+		double r = x.len();
+		a = - x / (r*r*r);
+	} else {
+		// Into the rotating body-fixed frame and back
+		double angle = this->rotation_angle + this->rotation_rate * t * this->T_dim;
+		Mat3 rot = rot_z(angle);
+		Vec3 g = this->geopotential->accel(rot.transpose() * x * this->R_dim);
+		a = rot * g / this->A_dim;
+	}
+
+	if (this->atmosphere != nullptr) {
+		double altitude = (x.len() - 1) * this->R_dim;
+		double rho = this->atmosphere->density(altitude);	// [kg/m^3]
+		if (rho > 0) {
+			// Velocity relative to the atmosphere [km/s]
+			double w = this->atmosphere_rotation_rate * this->R_dim;
+			Vec3 v_rel{
+				v.x * this->V_dim + w * x.y,
+				v.y * this->V_dim - w * x.x,
+				v.z * this->V_dim
+			};
+			// -1/2 rho B |v| v, with v in [m/s] and the result in [km/s^2]
+			double k = -0.5e3 * rho * this->ballistic_coeff * v_rel.len();
+			a += v_rel * (k / this->A_dim);
+		}
+	}
+
+	if (this->ephemeris != nullptr) {
+		// Pull on the satellite minus the pull on the central body
+		double t_sec = t * this->T_dim;
+		Vec3 r = x * this->R_dim;
+		auto third_body = [&](const Vec3 &s, double mu) {
+			Vec3 d = s - r;
+			double d3 = std::pow(d.dot(d), 1.5);
+			double s3 = std::pow(s.dot(s), 1.5);
+			return d / (d3 / mu) - s / (s3 / mu);
+		};
+		Vec3 g = third_body(this->ephemeris->sun(t_sec), this->mu_sun)
+			   + third_body(this->ephemeris->moon(t_sec), this->mu_moon);
+		a += g / this->A_dim;
+	}
+	return a;
+}
+
+} // namespace orbsim
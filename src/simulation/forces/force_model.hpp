@@ -0,0 +1,67 @@
+#ifndef FORCE_MODEL_HPP
+#define FORCE_MODEL_HPP
+
+#include "simulation/forces/atmosphere.hpp"
+#include "simulation/forces/geopotential.hpp"
+#include "simulation/forces/third_body.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <cstdint>
+
+
+namespace orbsim {
+
+/**
+ * @brief Equations of motion with force models (in dimensionless units)
+ *
+ * Used by the integrators in place of OrbitDE. The models are not owned and
+ * can be shared by any number of satellites and threads. Without any of
+ * them this is point-mass gravity again.
+ *
+ * Drag uses the ballistic coefficient Cd * A / m [m^2/kg] of the satellite,
+ * with an atmosphere that rotates together with the body. The Sun and the
+ * Moon pull with their masses from CelestialObj, the central body should be
+ * the Earth for them.
+ */
+class ForceModelDE {
+
+public:
+	explicit ForceModelDE(CelestialObj cel_obj = Earth);
+
+	const Geopotential *get_geopotential() const;
+	const Atmosphere *get_atmosphere() const;
+	double get_ballistic_coeff() const;
+	const Ephemeris *get_ephemeris() const;
+	std::uint64_t hash() const;
+
+	void set_geopotential(const Geopotential *geopotential,
+						  double rotation_rate = 7.2921150e-5, double rotation_angle = 0);
+	void set_drag(const Atmosphere *atmosphere, double ballistic_coeff,
+				  double rotation_rate = 7.2921150e-5);
+	void set_third_body(const Ephemeris *ephemeris);
+
+	Vec3 accel(double t, const Vec3 &x, const Vec3 &v) const;
+
+private:
+	CelestialObj cel_obj;
+	const Geopotential *geopotential;
+	double rotation_rate;	// of the body-fixed frame [rad/s]
+	double rotation_angle;	// at t = 0 [rad]
+	const Atmosphere *atmosphere;
+	double ballistic_coeff;	// [m^2/kg]
+	double atmosphere_rotation_rate;	// [rad/s]
+	const Ephemeris *ephemeris;
+	double mu_sun;	// [km^3/s^2]
+	double mu_moon;	// [km^3/s^2]
+
+	double R_dim;
+	double V_dim;	// [km/s]
+	double T_dim;
+	double A_dim;	// acceleration [km/s^2]
+};
+
+} // namespace orbsim
+
+
+#endif	// FORCE_MODEL_HPP
@@ -0,0 +1,241 @@
+#include "geopotential.hpp"
+#include "celestial_obj.hpp"
+#include "hash.hpp"
+#include "math_obj.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace orbsim {
+
+namespace {
+
+// Scratch for the V and W terms, grows to the largest field used on the thread
+std::vector<double> &scratch(std::size_t size) {
+	thread_local std::vector<double> buffer;
+	if (buffer.size() < size) buffer.resize(size);
+	return buffer;
+}
+
+// Factor that turns a fully normalized coefficient into an unnormalized one
+double norm_factor(int n, int m) {
+	// sqrt((2 - d_0m) (2n + 1) (n - m)! / (n + m)!), the factorials as a product
+	double f = (m == 0 ? 1 : 2) * (2.0 * n + 1);
+	for (int k = n - m + 1; k <= n + m; k++) f /= k;
+	return std::sqrt(f);
+}
+
+} // namespace
+
+Geopotential::Geopotential(const std::string &filename, int degree, int order,
+						   CelestialObj cel_obj)
+	: degree(degree), order(order), ref_radius(cel_obj.radius),
+	  gm(G * cel_obj.mass / 1e9) {
+
+	if (degree < 0 || degree > max_degree) {
+		throw std::domain_error("Degree must be between 0 and " + std::to_string(max_degree) + "!");
+	}
+	if (order < 0 || order > degree) {
+		throw std::domain_error("Order must be between 0 and the degree!");
+	}
+
+	const int stride = degree + 2;
+	this->C.assign(stride * (order + 1), 0);
+	this->S.assign(stride * (order + 1), 0);
+	this->C[0] = 1;
+
+	bool normalized = true;
+	load(filename, normalized);
+	if (normalized) {
+		for (int m = 0; m <= order; m++) {
+			for (int n = m; n <= degree; n++) {
+				this->C[m * stride + n] *= norm_factor(n, m);
+				this->S[m * stride + n] *= norm_factor(n, m);
+			}
+		}
+	}
+
+	// Factors of the V and W recursion, up to degree + 1 and order + 1
+	this->rec_a.assign(stride * (order + 2), 0);
+	this->rec_b.assign(stride * (order + 2), 0);
+	for (int m = 0; m <= order + 1; m++) {
+		for (int n = m + 2; n <= degree + 1; n++) {
+			this->rec_a[m * stride + n] = (2.0 * n - 1) / (n - m);
+			this->rec_b[m * stride + n] = (n + m - 1.0) / (n - m);
+		}
+	}
+
+	Fnv1a fnv;
+	fnv.add((std::uint64_t) degree);
+	fnv.add((std::uint64_t) order);
+	fnv.add(this->ref_radius);
+	fnv.add(this->gm);
+	fnv.add(this->C.data(), this->C.size() * sizeof(double));
+	fnv.add(this->S.data(), this->S.size() * sizeof(double));
+	this->hash = fnv.value;
+}
+
+int Geopotential::get_degree() const { return this->degree; }
+int Geopotential::get_order() const { return this->order; }
+double Geopotential::get_ref_radius() const { return this->ref_radius; }
+double Geopotential::get_gm() const { return this->gm; }
+std::uint64_t Geopotential::get_hash() const { return this->hash; }
+
+void Geopotential::load(const std::string &filename, bool &normalized) {
+	std::ifstream file(filename);
+	if (!file) {
+		throw std::runtime_error("Could not open " + filename + "!");
+	}
+
+	int max_n = 0;
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream fields(line);
+		std::string key;
+		if (!(fields >> key)) continue;
+
+		// ICGEM header, in SI units
+		if (key == "earth_gravity_constant" || key == "gravity_constant") {
+			fields >> this->gm;
+			this->gm /= 1e9;
+			continue;
+		}
+		if (key == "radius") {
+			fields >> this->ref_radius;
+			this->ref_radius /= 1000;
+			continue;
+		}
+		if (key == "norm") {
+			std::string norm;
+			fields >> norm;
+			normalized = norm != "unnormalized";
+			continue;
+		}
+
+		// Coefficient lines, with or without the gfc key
+		int n, m;
+		double c, s;
+		if (key == "gfc" || key == "gfct") {
+			if (!(fields >> n >> m >> c >> s)) continue;
+		} else {
+			std::istringstream numbers(line);
+			if (!(numbers >> n >> m >> c >> s)) continue;
+		}
+		if (n < 0 || m < 0 || m > n) {
+			throw std::runtime_error(filename + " has an invalid coefficient " +
+									 std::to_string(n) + " " + std::to_string(m) + "!");
+		}
+		if (n > max_n) max_n = n;
+		if (n > this->degree || m > this->order) continue;
+
+		this->C[m * (this->degree + 2) + n] = c;
+		this->S[m * (this->degree + 2) + n] = s;
+	}
+
+	if (max_n < this->degree) {
+		throw std::domain_error(filename + " only goes up to degree " + std::to_string(max_n) + "!");
+	}
+}
+
+void Geopotential::compute_vw(const Vec3 &r, int n_max, int m_max, double *V, double *W) const {
+	// V[n][m] and W[n][m] as in Montenbruck & Gill, stored by column of m
+	const int stride = this->degree + 2;
+
+	double R = this->ref_radius;
+	double r2 = r.dot(r);
+	double rho = R * R / r2;
+	double x0 = R * r.x / r2;
+	double y0 = R * r.y / r2;
+	double z0 = R * r.z / r2;
+
+	V[0] = R / std::sqrt(r2);
+	W[0] = 0;
+	for (int m = 0; m <= m_max; m++) {
+		double *Vm = V + m * stride;
+		double *Wm = W + m * stride;
+
+		// Sectorial term from the previous column
+		if (m > 0) {
+			const double *Vp = Vm - stride;
+			const double *Wp = Wm - stride;
+			Vm[m] = (2 * m - 1) * (x0 * Vp[m - 1] - y0 * Wp[m - 1]);
+			Wm[m] = (2 * m - 1) * (x0 * Wp[m - 1] + y0 * Vp[m - 1]);
+		}
+		if (m + 1 <= n_max) {
+			Vm[m + 1] = (2 * m + 1) * z0 * Vm[m];
+			Wm[m + 1] = (2 * m + 1) * z0 * Wm[m];
+		}
+
+		// Down the column, with the factors of the recursion computed in advance
+		const double *a = this->rec_a.data() + m * stride;
+		const double *b = this->rec_b.data() + m * stride;
+		for (int n = m + 2; n <= n_max; n++) {
+			Vm[n] = a[n] * z0 * Vm[n - 1] - b[n] * rho * Vm[n - 2];
+			Wm[n] = a[n] * z0 * Wm[n - 1] - b[n] * rho * Wm[n - 2];
+		}
+	}
+}
+
+Vec3 Geopotential::accel(const Vec3 &r) const {
+	// The acceleration of degree n needs the terms of degree n + 1
+	const int stride = this->degree + 2;
+	std::vector<double> &buffer = scratch(2 * (std::size_t) stride * (this->order + 2));
+	double *V = buffer.data();
+	double *W = V + stride * (this->order + 2);
+	compute_vw(r, this->degree + 1, this->order + 1, V, W);
+
+	// Zonal terms
+	double ax = 0, ay = 0, az = 0;
+	for (int n = 0; n <= this->degree; n++) {
+		double C = this->C[n];
+		ax -= C * V[stride + n + 1];
+		ay -= C * W[stride + n + 1];
+		az -= (n + 1) * C * V[n + 1];
+	}
+
+	// Tesseral and sectorial terms
+	for (int m = 1; m <= this->order; m++) {
+		const double *Cm = this->C.data() + m * stride;
+		const double *Sm = this->S.data() + m * stride;
+		const double *Vl = V + (m - 1) * stride, *Wl = W + (m - 1) * stride;
+		const double *Vm = V + m * stride, *Wm = W + m * stride;
+		const double *Vh = V + (m + 1) * stride, *Wh = W + (m + 1) * stride;
+
+		for (int n = m; n <= this->degree; n++) {
+			double C = Cm[n];
+			double S = Sm[n];
+			double fac = 0.5 * (n - m + 1) * (n - m + 2);
+			ax += 0.5 * (-C * Vh[n + 1] - S * Wh[n + 1]) + fac * (C * Vl[n + 1] + S * Wl[n + 1]);
+			ay += 0.5 * (-C * Wh[n + 1] + S * Vh[n + 1]) + fac * (-C * Wl[n + 1] + S * Vl[n + 1]);
+			az += (n - m + 1) * (-C * Vm[n + 1] - S * Wm[n + 1]);
+		}
+	}
+
+	double scale = this->gm / (this->ref_radius * this->ref_radius);
+	return Vec3{ax * scale, ay * scale, az * scale};
+}
+
+double Geopotential::potential(const Vec3 &r) const {
+	const int stride = this->degree + 2;
+	std::vector<double> &buffer = scratch(2 * (std::size_t) stride * (this->order + 1));
+	double *V = buffer.data();
+	double *W = V + stride * (this->order + 1);
+	compute_vw(r, this->degree, this->order, V, W);
+
+	double sum = 0;
+	for (int m = 0; m <= this->order; m++) {
+		for (int n = m; n <= this->degree; n++) {
+			sum += this->C[m * stride + n] * V[m * stride + n] + this->S[m * stride + n] * W[m * stride + n];
+		}
+	}
+	return this->gm / this->ref_radius * sum;
+}
+
+} // namespace orbsim
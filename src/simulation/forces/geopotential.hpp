@@ -0,0 +1,65 @@
+#ifndef GEOPOTENTIAL_HPP
+#define GEOPOTENTIAL_HPP
+
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace orbsim {
+
+/**
+ * @brief Spherical harmonic gravity field up to a chosen degree and order
+ *
+ * The coefficients are read from a text file, either in the ICGEM format
+ * (gfc lines, the header gives the reference radius and GM) or as plain
+ * "n m C S" lines, fully normalized unless the header says otherwise.
+ *
+ * The acceleration is computed with the Cunningham recursion for the V and
+ * W terms (Montenbruck & Gill, Satellite Orbits, 3.2), which only needs
+ * multiplications and additions. The recursion works in a scratch buffer
+ * that each thread allocates once and then reuses.
+ */
+class Geopotential {
+
+public:
+	static const int max_degree = 100;
+
+	Geopotential(const std::string &filename, int degree, int order,
+				 CelestialObj cel_obj = Earth);
+
+	int get_degree() const;
+	int get_order() const;
+	double get_ref_radius() const;
+	double get_gm() const;
+	std::uint64_t get_hash() const;
+
+	// Position in the body-fixed frame [km], acceleration in [km/s^2]
+	Vec3 accel(const Vec3 &r) const;
+	// Potential in [km^2/s^2], positive
+	double potential(const Vec3 &r) const;
+
+private:
+	void load(const std::string &filename, bool &normalized);
+	void compute_vw(const Vec3 &r, int n_max, int m_max, double *V, double *W) const;
+
+	int degree;
+	int order;
+	double ref_radius;	// [km]
+	double gm;	// [km^3/s^2]
+	std::uint64_t hash;
+
+	// Unnormalized coefficients by column of m, C[m * (degree + 2) + n]
+	std::vector<double> C;
+	std::vector<double> S;
+	std::vector<double> rec_a;	// (2n - 1) / (n - m)
+	std::vector<double> rec_b;	// (n + m - 1) / (n - m)
+};
+
+} // namespace orbsim
+
+
+#endif	// GEOPOTENTIAL_HPP
@@ -0,0 +1,158 @@
+#include "third_body.hpp"
+#include "hash.hpp"
+#include "math_obj.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+namespace orbsim {
+
+namespace {
+
+const double deg = PI / 180;
+const double arcsec = deg / 3600;
+const double obliquity = 23.43929111 * deg;	// of the ecliptic at J2000
+
+// Ecliptic to equatorial coordinates
+Vec3 equatorial(double r, double lon, double lat) {
+	double x = r * std::cos(lon) * std::cos(lat);
+	double y = r * std::sin(lon) * std::cos(lat);
+	double z = r * std::sin(lat);
+	return Vec3{
+		x,
+		std::cos(obliquity) * y - std::sin(obliquity) * z,
+		std::sin(obliquity) * y + std::cos(obliquity) * z
+	};
+}
+
+// Segments and degrees of the fits, well below the error of the series
+const double sun_segment = 8 * 86400;
+const int sun_degree = 10;
+const double moon_segment = 86400;
+const int moon_degree = 12;
+
+} // namespace
+
+// Series from Montenbruck & Gill, Satellite Orbits, section 3.3.2
+Vec3 sun_position(double jd) {
+	double T = (jd - J2000) / 36525;
+	double M = (357.5256 + 35999.049 * T) * deg;
+	double lon = 282.9400 * deg + M + 6892 * arcsec * std::sin(M) + 72 * arcsec * std::sin(2 * M);
+	double r = (149.619 - 2.499 * std::cos(M) - 0.021 * std::cos(2 * M)) * 1e6;
+	return equatorial(r, lon, 0);
+}
+
+Vec3 moon_position(double jd) {
+	double T = (jd - J2000) / 36525;
+	double L0 = (218.31617 + 481267.88088 * T - 1.3972 * T) * deg;
+	double l = (134.96292 + 477198.86753 * T) * deg;
+	double lp = (357.52543 + 35999.04944 * T) * deg;
+	double F = (93.27283 + 483202.01873 * T) * deg;
+	double D = (297.85027 + 445267.11135 * T) * deg;
+
+	double lon = L0 + (22640 * std::sin(l) + 769 * std::sin(2 * l)
+		- 4586 * std::sin(l - 2 * D) + 2370 * std::sin(2 * D)
+		- 668 * std::sin(lp) - 412 * std::sin(2 * F)
+		- 212 * std::sin(2 * l - 2 * D) - 206 * std::sin(l + lp - 2 * D)
+		+ 192 * std::sin(l + 2 * D) - 165 * std::sin(lp - 2 * D)
+		+ 148 * std::sin(l - lp) - 125 * std::sin(D)
+		- 110 * std::sin(l + lp) - 55 * std::sin(2 * F - 2 * D)) * arcsec;
+	double lat = (18520 * std::sin(F + lon - L0 + (412 * std::sin(2 * F) + 541 * std::sin(lp)) * arcsec)
+		- 526 * std::sin(F - 2 * D) + 44 * std::sin(l + F - 2 * D)
+		- 31 * std::sin(-l + F - 2 * D) - 25 * std::sin(-2 * l + F)
+		- 23 * std::sin(lp + F - 2 * D) + 21 * std::sin(-l + F)
+		+ 11 * std::sin(-lp + F - 2 * D)) * arcsec;
+	double r = 385000 - 20905 * std::cos(l) - 3699 * std::cos(2 * D - l)
+		- 2956 * std::cos(2 * D) - 570 * std::cos(2 * l)
+		+ 246 * std::cos(2 * l - 2 * D) - 205 * std::cos(lp - 2 * D)
+		- 171 * std::cos(l + 2 * D) - 152 * std::cos(l + lp - 2 * D);
+	return equatorial(r, lon, lat);
+}
+
+Ephemeris::Ephemeris(double t_start, double t_end, double epoch)
+	: epoch(epoch), t_start(t_start), t_end(t_end) {
+
+	if (t_end < t_start) {
+		throw std::domain_error("End time must be after the start time!");
+	}
+
+	this->sun_series = Series{sun_segment, sun_degree, {}};
+	this->moon_series = Series{moon_segment, moon_degree, {}};
+	fit(this->sun_series, sun_position);
+	fit(this->moon_series, moon_position);
+
+	Fnv1a fnv;
+	fnv.add(epoch);
+	fnv.add(t_start);
+	fnv.add(t_end);
+	fnv.add(this->sun_series.coeffs.data(), this->sun_series.coeffs.size() * sizeof(double));
+	fnv.add(this->moon_series.coeffs.data(), this->moon_series.coeffs.size() * sizeof(double));
+	this->hash = fnv.value;
+}
+
+double Ephemeris::get_epoch() const { return this->epoch; }
+double Ephemeris::get_t_start() const { return this->t_start; }
+double Ephemeris::get_t_end() const { return this->t_end; }
+std::uint64_t Ephemeris::get_hash() const { return this->hash; }
+
+Vec3 Ephemeris::sun(double t) const { return eval(this->sun_series, t); }
+Vec3 Ephemeris::moon(double t) const { return eval(this->moon_series, t); }
+
+void Ephemeris::fit(Series &series, Vec3 (*position)(double)) const {
+	int segments = std::max(1, (int) std::ceil((this->t_end - this->t_start) / series.length));
+	int n = series.degree + 1;
+	series.coeffs.assign(3 * n * (std::size_t) segments, 0);
+
+	// Interpolation at the Chebyshev nodes of each segment
+	std::vector<Vec3> values(n);
+	for (int seg = 0; seg < segments; seg++) {
+		double mid = this->t_start + (seg + 0.5) * series.length;
+		for (int k = 0; k < n; k++) {
+			double node = std::cos(PI * (k + 0.5) / n);
+			values[k] = position(this->epoch + (mid + 0.5 * series.length * node) / 86400);
+		}
+
+		double *c = series.coeffs.data() + 3 * n * (std::size_t) seg;
+		for (int j = 0; j < n; j++) {
+			Vec3 sum{0, 0, 0};
+			for (int k = 0; k < n; k++) {
+				sum = sum + values[k] * std::cos(PI * j * (k + 0.5) / n);
+			}
+			double f = (j == 0 ? 1.0 : 2.0) / n;
+			c[j] = f * sum.x;
+			c[n + j] = f * sum.y;
+			c[2 * n + j] = f * sum.z;
+		}
+	}
+}
+
+Vec3 Ephemeris::eval(const Series &series, double t) const {
+	int n = series.degree + 1;
+	int segments = (int) (series.coeffs.size() / (3 * n));
+	int seg = (int) std::floor((t - this->t_start) / series.length);
+	seg = std::clamp(seg, 0, segments - 1);
+
+	// Clenshaw recurrence for the three coordinates at once
+	double mid = this->t_start + (seg + 0.5) * series.length;
+	double s = 2 * (t - mid) / series.length;
+	const double *c = series.coeffs.data() + 3 * n * (std::size_t) seg;
+	double bx = 0, by = 0, bz = 0, bx1 = 0, by1 = 0, bz1 = 0;
+	for (int j = n - 1; j >= 1; j--) {
+		double x = 2 * s * bx - bx1 + c[j];
+		double y = 2 * s * by - by1 + c[n + j];
+		double z = 2 * s * bz - bz1 + c[2 * n + j];
+		bx1 = bx; by1 = by; bz1 = bz;
+		bx = x; by = y; bz = z;
+	}
+	return Vec3{
+		s * bx - bx1 + c[0],
+		s * by - by1 + c[n],
+		s * bz - bz1 + c[2 * n]
+	};
+}
+
+} // namespace orbsim
@@ -0,0 +1,62 @@
+#ifndef THIRD_BODY_HPP
+#define THIRD_BODY_HPP
+
+#include "simulation/math_obj.hpp"
+
+#include <cstdint>
+#include <vector>
+
+
+namespace orbsim {
+
+const double J2000 = 2451545.0;	// Julian date of the J2000 epoch
+
+/** @brief Low precision geocentric position of the Sun in [km], equator and equinox of J2000 */
+Vec3 sun_position(double jd);
+
+/** @brief Low precision geocentric position of the Moon in [km], equator and equinox of J2000 */
+Vec3 moon_position(double jd);
+
+/**
+ * @brief Sun and Moon positions over a time span, as Chebyshev segments
+ *
+ * The analytic series are only evaluated when the segments are fitted, after
+ * that a position is a few multiply-adds. The ephemeris is read only and
+ * meant to be shared by all the satellites of a run. Times are seconds from
+ * the epoch, outside the span the first or last segment is extrapolated.
+ */
+class Ephemeris {
+
+public:
+	Ephemeris(double t_start, double t_end, double epoch = J2000);
+
+	double get_epoch() const;
+	double get_t_start() const;
+	double get_t_end() const;
+	std::uint64_t get_hash() const;
+
+	Vec3 sun(double t) const;
+	Vec3 moon(double t) const;
+
+private:
+	struct Series {
+		double length;	// of a segment [s]
+		int degree;
+		std::vector<double> coeffs;	// x, y and z of each segment
+	};
+
+	void fit(Series &series, Vec3 (*position)(double)) const;
+	Vec3 eval(const Series &series, double t) const;
+
+	double epoch;	// Julian date at t = 0
+	double t_start;
+	double t_end;
+	Series sun_series;
+	Series moon_series;
+	std::uint64_t hash;
+};
+
+} // namespace orbsim
+
+
+#endif	// THIRD_BODY_HPP
@@ -0,0 +1,37 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace orbsim {
+
+/**
+ * @brief 64-bit FNV-1a hash, built up one value at a time
+ */
+struct Fnv1a {
+	std::uint64_t value = 14695981039346656037ull;
+
+	void add(const void *data, std::size_t size) {
+		const unsigned char *bytes = static_cast<const unsigned char *>(data);
+		for (std::size_t i = 0; i < size; i++) {
+			this->value ^= bytes[i];
+			this->value *= 1099511628211ull;
+		}
+	}
+
+	void add(double value) {
+		if (value == 0) value = 0;	// -0 and +0 are the same
+		add(&value, sizeof(value));
+	}
+
+	void add(std::uint64_t value) {
+		add(&value, sizeof(value));
+	}
+};
+
+} // namespace orbsim
+
+
+#endif	// HASH_HPP
@@ -0,0 +1,13 @@
+#include "dopri5.hpp"
+#include "diff_eq.hpp"
+#include "forces/force_model.hpp"
+#include "math_obj.hpp"
+
+
+namespace orbsim {
+
+template class BasicDOPRI5<OrbitDE>;
+template class BasicDOPRI5<DESystem<Vec3>>;
+template class BasicDOPRI5<ForceModelDE>;
+
+} // namespace orbsim
@@ -0,0 +1,61 @@
+#ifndef DOPRI5_HPP
+#define DOPRI5_HPP
+
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
+#include "simulation/math_obj.hpp"
+
+
+namespace orbsim {
+
+/**
+ * @brief Dormand-Prince 5(4) integrator with adaptive step size
+ *
+ * The internal steps are chosen from the local error estimate, so they get
+ * short only near periapsis. The requested time grid is filled in with the
+ * method's 4th order dense output, it doesn't limit the step size.
+ */
+template <typename DE>
+class BasicDOPRI5 : public Integrator {
+
+public:
+	BasicDOPRI5(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+				double t_i, double t_f, int steps,
+				double rel_tol = 1e-9, double abs_tol = 1e-12);
+
+	BasicDOPRI5 *copy() const override;
+
+	void integrate() override;
+	bool has_stm() const override;
+
+	double get_rel_tol() const;
+	double get_abs_tol() const;
+	int get_accepted_steps() const;
+	int get_rejected_steps() const;
+
+	void set_tolerances(double rel_tol, double abs_tol);
+
+private:
+	template <typename State, typename F>
+	void run(const F &f, State y);
+
+	DE de_system;
+	double rel_tol;
+	double abs_tol;	// in dimensionless units
+	int accepted_steps;
+	int rejected_steps;
+};
+
+using DOPRI5 = BasicDOPRI5<OrbitDE>;
+
+extern template class BasicDOPRI5<OrbitDE>;
+extern template class BasicDOPRI5<DESystem<Vec3>>;
+extern template class BasicDOPRI5<ForceModelDE>;
+
+} // namespace orbsim
+
+#include "simulation/integrators/dopri5.ipp"
+
+
+#endif	// DOPRI5_HPP
@@ -0,0 +1,187 @@
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/integrators/phase_state.hpp"
+#include "simulation/integrators/variational.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+
+namespace orbsim {
+
+namespace dopri5 {
+
+// Butcher tableau (Dormand & Prince 1980)
+inline constexpr double c2 = 1.0/5, c3 = 3.0/10, c4 = 4.0/5, c5 = 8.0/9;
+
+inline constexpr double a21 = 1.0/5;
+inline constexpr double a31 = 3.0/40, a32 = 9.0/40;
+inline constexpr double a41 = 44.0/45, a42 = -56.0/15, a43 = 32.0/9;
+inline constexpr double a51 = 19372.0/6561, a52 = -25360.0/2187, a53 = 64448.0/6561, a54 = -212.0/729;
+inline constexpr double a61 = 9017.0/3168, a62 = -355.0/33, a63 = 46732.0/5247, a64 = 49.0/176, a65 = -5103.0/18656;
+inline constexpr double a71 = 35.0/384, a73 = 500.0/1113, a74 = 125.0/192, a75 = -2187.0/6784, a76 = 11.0/84;
+
+// 5th order solution minus the embedded 4th order one
+inline constexpr double e1 = 71.0/57600, e3 = -71.0/16695, e4 = 71.0/1920, e5 = -17253.0/339200, e6 = 22.0/525, e7 = -1.0/40;
+
+// Dense output (Hairer, Norsett & Wanner, Solving ODEs I)
+inline constexpr double d1 = -12715105075.0/11282082432, d3 = 87487479700.0/32700410799,
+						d4 = -10690763975.0/1880347072, d5 = 701980252875.0/199316789632,
+						d6 = -1453857185.0/822651844, d7 = 69997945.0/29380423;
+
+// Step size controller
+inline constexpr double safety = 0.9;
+inline constexpr double fac_min = 0.2;
+inline constexpr double fac_max = 5;
+
+} // namespace dopri5
+
+template <typename DE>
+BasicDOPRI5<DE>::BasicDOPRI5(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+							 double t_i, double t_f, int steps,
+							 double rel_tol, double abs_tol)
+	: Integrator(M, R0, x0, v0, t_i, t_f, steps), de_system(de_system),
+	  accepted_steps(0), rejected_steps(0) {
+
+	set_tolerances(rel_tol, abs_tol);
+	this->two_body = std::is_same_v<DE, OrbitDE>;
+}
+
+template <typename DE>
+BasicDOPRI5<DE> *BasicDOPRI5<DE>::copy() const { return new BasicDOPRI5(*this); }
+
+template <typename DE>
+double BasicDOPRI5<DE>::get_rel_tol() const { return this->rel_tol; }
+template <typename DE>
+double BasicDOPRI5<DE>::get_abs_tol() const { return this->abs_tol; }
+template <typename DE>
+int BasicDOPRI5<DE>::get_accepted_steps() const { return this->accepted_steps; }
+template <typename DE>
+int BasicDOPRI5<DE>::get_rejected_steps() const { return this->rejected_steps; }
+
+template <typename DE>
+void BasicDOPRI5<DE>::set_tolerances(double rel_tol, double abs_tol) {
+	if (rel_tol <= 0 || abs_tol <= 0) {
+		throw std::domain_error("Tolerances must be positive numbers!");
+	}
+	this->rel_tol = rel_tol;
+	this->abs_tol = abs_tol;
+}
+
+template <typename DE>
+template <typename State, typename F>
+void BasicDOPRI5<DE>::run(const F &f, State y) {
+	using namespace dopri5;
+
+	auto err_norm = [this](const State &err, const State &y0, const State &y1) {
+		return orbsim::err_norm(err, y0, y1, this->rel_tol, this->abs_tol);
+	};
+
+	double grid_dt = this->delta_t / this->T_dim;
+	double t0 = this->t_start / this->T_dim;
+	double t_end = t0 + (this->steps - 1) * grid_dt;
+
+	double t = t0;
+	this->store(0, y);
+	State k1 = f(t, y);
+
+	// Initial step size guess (Hairer, Norsett & Wanner, Solving ODEs I, II.4)
+	double norm_y = err_norm(y, y, y);
+	double norm_f = err_norm(k1, y, y);
+	double h = (norm_y < 1e-5 || norm_f < 1e-5) ? 1e-6 : 0.01 * norm_y / norm_f;
+	h = std::min(h, t_end - t0);
+	State k2 = f(t + h, y + h * k1);
+	double norm_df = err_norm((1 / h) * (k2 - k1), y, y);
+	double norm_max = std::max(norm_f, norm_df);
+	double h1 = norm_max <= 1e-15 ? std::max(1e-6, h * 1e-3) : std::pow(0.01 / norm_max, 1.0 / 5);
+	h = std::min({100 * h, h1, t_end - t0});
+
+	int next = 1;	// next sample of the output grid
+	bool running = true;	// until a terminal event
+	while (running && next < this->steps) {
+		bool last = false;
+		if (t + h >= t_end) {
+			h = t_end - t;
+			last = true;
+		}
+		if (h <= 1e-14 * std::max(1.0, std::fabs(t))) {
+			throw std::runtime_error("DOPRI5 step size became too small!");
+		}
+
+		k2 = f(t + c2*h, y + h * (a21*k1));
+		State k3 = f(t + c3*h, y + h * (a31*k1 + a32*k2));
+		State k4 = f(t + c4*h, y + h * (a41*k1 + a42*k2 + a43*k3));
+		State k5 = f(t + c5*h, y + h * (a51*k1 + a52*k2 + a53*k3 + a54*k4));
+		State k6 = f(t + h, y + h * (a61*k1 + a62*k2 + a63*k3 + a64*k4 + a65*k5));
+		State y_new = y + h * (a71*k1 + a73*k3 + a74*k4 + a75*k5 + a76*k6);
+		State k7 = f(t + h, y_new);
+
+		State err = h * (e1*k1 + e3*k3 + e4*k4 + e5*k5 + e6*k6 + e7*k7);
+		double err_val = err_norm(err, y, y_new);
+		double fac = err_val == 0 ? fac_max
+								  : std::clamp(safety * std::pow(err_val, -1.0 / 5), fac_min, fac_max);
+
+		if (err_val > 1) {
+			this->rejected_steps++;
+			h *= std::min(1.0, fac);
+			continue;
+		}
+		this->accepted_steps++;
+
+		// Fill in the grid samples this step went past
+		State y_diff = y_new - y;
+		State bspl = h * k1 - y_diff;
+		State rc4 = y_diff - h * k7 - bspl;
+		State rc5 = h * (d1*k1 + d3*k3 + d4*k4 + d5*k5 + d6*k6 + d7*k7);
+
+		double t_new = last ? t_end : t + h;
+		while (next < this->steps && (last || t0 + next * grid_dt <= t_new)) {
+			double theta = std::clamp((t0 + next * grid_dt - t) / h, 0.0, 1.0);
+			double theta1 = 1 - theta;
+			State y_out = y + theta * (y_diff + theta1 * (bspl + theta * (rc4 + theta1 * rc5)));
+
+			running = this->store(next, y_out);
+			if (!running) break;
+			next++;
+		}
+
+		t = t_new;
+		y = y_new;
+		k1 = k7;	// First same as last
+		h *= fac;
+	}
+
+	this->end_integration();
+}
+
+template <typename DE>
+void BasicDOPRI5<DE>::integrate() {
+	this->rhs_evals = 0;
+	this->accepted_steps = 0;
+	this->rejected_steps = 0;
+
+	// Norm the initial conditions
+	this->begin_integration();
+	PhaseState y{this->x0 / this->R_dim, this->v0 / this->V_dim};
+
+	if (this->stm) {
+		run([this](double t, const StmState &s) {
+			this->rhs_evals++;
+			return stm_rhs(this->de_system, t, s);
+		}, StmState::identity(y));
+	} else {
+		run([this](double t, const PhaseState &y) {
+			this->rhs_evals++;
+			return PhaseState{y.vel, this->de_system.accel(t, y.pos, y.vel)};
+		}, y);
+	}
+}
+
+template <typename DE>
+bool BasicDOPRI5<DE>::has_stm() const { return true; }
+
+} // namespace orbsim
@@ -3,6 +3,7 @@
 
 #include "simulation/integrators/integrator.hpp"
 #include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
 #include "simulation/math_obj.hpp"
 
 
@@ -11,18 +12,30 @@ namespace orbsim {
 /**
  * @brief Euler integrator
  */
-class Euler : public Integrator {
+template <typename DE>
+class BasicEuler : public Integrator {
 
 public:
-	Euler(DESystem<Vec3> de_system, double M, double R0, Vec3 x0, Vec3 v0,
-		  double t_i, double t_f, int steps);
+	BasicEuler(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+			   double t_i, double t_f, int steps);
 
-	Euler *copy() const override;
+	BasicEuler *copy() const override;
 
 	void integrate() override;
+
+private:
+	DE de_system;
 };
 
+using Euler = BasicEuler<OrbitDE>;
+
+extern template class BasicEuler<OrbitDE>;
+extern template class BasicEuler<DESystem<Vec3>>;
+extern template class BasicEuler<ForceModelDE>;
+
 } // namespace orbsim
 
+#include "simulation/integrators/euler.ipp"
+
 
 #endif	// EULER_HPP
@@ -0,0 +1,46 @@
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <type_traits>
+
+
+namespace orbsim {
+
+template <typename DE>
+BasicEuler<DE>::BasicEuler(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+						   double t_i, double t_f, int steps)
+	: Integrator(M, R0, x0, v0, t_i, t_f, steps), de_system(de_system) {
+
+	this->two_body = std::is_same_v<DE, OrbitDE>;
+}
+
+template <typename DE>
+BasicEuler<DE> *BasicEuler<DE>::copy() const { return new BasicEuler(*this); }
+
+template <typename DE>
+void BasicEuler<DE>::integrate() {
+	// Norm the initial conditions
+	this->begin_integration();
+	Vec3 pos = this->x0 / this->R_dim;
+	Vec3 vel = this->v0 / this->V_dim;
+	double dt = this->delta_t / this->T_dim;
+	double t0 = this->t_start / this->T_dim;
+	this->store(0, pos, vel);
+
+	for (int i = 0; i < this->steps - 1; i++) {
+		double t = t0 + i * dt;
+		Vec3 acc = this->de_system.accel(t, pos, vel);
+		pos += vel * dt;
+		vel += acc * dt;
+
+		if (!this->store(i + 1, pos, vel)) break;
+	}
+
+	this->rhs_evals = (long long) this->sample_count - 1;
+
+	this->end_integration();
+}
+
+} // namespace orbsim
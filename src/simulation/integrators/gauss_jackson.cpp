@@ -0,0 +1,87 @@
+#include "gauss_jackson.hpp"
+#include "diff_eq.hpp"
+#include "forces/force_model.hpp"
+#include "math_obj.hpp"
+
+
+namespace orbsim {
+
+namespace gauss_jackson {
+
+namespace {
+
+// Series of 1 / (-ln(1-t)/t)^power, optionally divided by (1-t)
+void series(double *out, int len, int power, bool explicit_form) {
+	// -ln(1-t)/t = 1 + t/2 + t^2/3 + ...
+	double lg[points + 2];
+	for (int k = 0; k < len; k++) lg[k] = 1.0 / (k + 1);
+
+	// Reciprocal of the series
+	double inv[points + 2];
+	for (int k = 0; k < len; k++) {
+		double sum = k == 0 ? 1 : 0;
+		for (int j = 1; j <= k; j++) sum -= lg[j] * inv[k - j];
+		inv[k] = sum;
+	}
+
+	for (int k = 0; k < len; k++) out[k] = inv[k];
+	if (power == 2) {
+		for (int k = 0; k < len; k++) {
+			out[k] = 0;
+			for (int j = 0; j <= k; j++) out[k] += inv[j] * inv[k - j];
+		}
+	}
+
+	// Dividing by (1-t) turns the coefficients into partial sums
+	if (explicit_form) {
+		for (int k = 1; k < len; k++) out[k] += out[k - 1];
+	}
+}
+
+// Rewrites sum(coef[k] * nabla^k f_n), k = 0..points-1, in terms of f_{n-i}
+void to_ordinates(const double *coef, double *c) {
+	for (int i = 0; i < points; i++) {
+		c[i] = 0;
+		double binom = 1;	// C(k, i), starting from k = i
+		for (int k = i; k < points; k++) {
+			c[i] += coef[k] * binom * (i % 2 ? -1 : 1);
+			binom = binom * (k + 1) / (k + 1 - i);
+		}
+	}
+}
+
+SummedFormula summed_formula(int order, bool explicit_form) {
+	double coef[points + 2];
+	series(coef, points + order, order, explicit_form);
+
+	// The first 'order' terms act on the sums, the rest on the differences
+	SummedFormula formula{};
+	formula.s2 = order == 2 ? coef[0] : 0;
+	formula.s1 = coef[order - 1];
+	to_ordinates(coef + order, formula.c);
+	return formula;
+}
+
+Coeffs compute_coeffs() {
+	return Coeffs{
+		summed_formula(2, true),	// Stormer
+		summed_formula(1, true),	// Adams-Bashforth
+		summed_formula(2, false),	// Cowell
+		summed_formula(1, false),	// Adams-Moulton
+	};
+}
+
+} // namespace
+
+const Coeffs &get_coeffs() {
+	static const Coeffs coeffs = compute_coeffs();
+	return coeffs;
+}
+
+} // namespace gauss_jackson
+
+template class BasicGaussJackson<OrbitDE>;
+template class BasicGaussJackson<DESystem<Vec3>>;
+template class BasicGaussJackson<ForceModelDE>;
+
+} // namespace orbsim
@@ -0,0 +1,46 @@
+#ifndef GAUSS_JACKSON_HPP
+#define GAUSS_JACKSON_HPP
+
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
+#include "simulation/math_obj.hpp"
+
+
+namespace orbsim {
+
+/**
+ * @brief Gauss-Jackson 8th order predictor-corrector integrator
+ *
+ * Multistep method in summed form for second order equations. The first 9
+ * samples are computed with RK87, after that every step evaluates the
+ * right-hand side only once (PEC mode). The step size is the one of the
+ * time grid, so the grid should resolve the orbit.
+ */
+template <typename DE>
+class BasicGaussJackson : public Integrator {
+
+public:
+	BasicGaussJackson(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+					  double t_i, double t_f, int steps);
+
+	BasicGaussJackson *copy() const override;
+
+	void integrate() override;
+
+private:
+	DE de_system;
+};
+
+using GaussJackson = BasicGaussJackson<OrbitDE>;
+
+extern template class BasicGaussJackson<OrbitDE>;
+extern template class BasicGaussJackson<DESystem<Vec3>>;
+extern template class BasicGaussJackson<ForceModelDE>;
+
+} // namespace orbsim
+
+#include "simulation/integrators/gauss_jackson.ipp"
+
+
+#endif	// GAUSS_JACKSON_HPP
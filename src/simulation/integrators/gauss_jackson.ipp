@@ -0,0 +1,140 @@
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/integrators/rk87.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+
+namespace orbsim {
+
+namespace gauss_jackson {
+
+// Number of back values (the order of the method + 1)
+inline constexpr int points = 9;
+
+/**
+ * Ordinate form of the summed Stormer-Cowell and Adams formulas, i.e.
+ *
+ *     x_n = h^2 (s2 * SS_n + s1 * S_n + sum(c[i] * f_{n-i}))
+ *     v_n = h   (            s1 * S_n + sum(c[i] * f_{n-i}))
+ *
+ * where S and SS are the first and second sums of the accelerations.
+ */
+struct SummedFormula {
+	double s2;
+	double s1;
+	double c[points];
+};
+
+struct Coeffs {
+	SummedFormula pred_pos;	// x_{n+1} from the values at n
+	SummedFormula pred_vel;	// v_{n+1} from the values at n
+	SummedFormula corr_pos;	// x_n
+	SummedFormula corr_vel;	// v_n
+};
+
+// The coefficients only depend on the order, they are computed once
+const Coeffs &get_coeffs();
+
+inline Vec3 apply(const SummedFormula &formula, const Vec3 &sum2, const Vec3 &sum1,
+				  const Vec3 *f, int newest) {
+	Vec3 res = formula.s2 * sum2 + formula.s1 * sum1;
+	for (int i = 0; i < points; i++) {
+		res = fmadd(formula.c[i], f[(newest - i + points) % points], res);
+	}
+	return res;
+}
+
+} // namespace gauss_jackson
+
+template <typename DE>
+BasicGaussJackson<DE>::BasicGaussJackson(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+										 double t_i, double t_f, int steps)
+	: Integrator(M, R0, x0, v0, t_i, t_f, steps), de_system(de_system) {
+
+	this->two_body = std::is_same_v<DE, OrbitDE>;
+}
+
+template <typename DE>
+BasicGaussJackson<DE> *BasicGaussJackson<DE>::copy() const { return new BasicGaussJackson(*this); }
+
+template <typename DE>
+void BasicGaussJackson<DE>::integrate() {
+	using namespace gauss_jackson;
+	const Coeffs &coeffs = get_coeffs();
+
+	this->rhs_evals = 0;
+	this->begin_integration();
+
+	// Start up with a tight single step method
+	int start_steps = std::min(this->steps, points);
+	if (start_steps < 2) {
+		this->store(0, this->x0 / this->R_dim, this->v0 / this->V_dim);
+		this->end_integration();
+		return;
+	}
+	BasicRK87<DE> starter(this->de_system, this->M, this->R0, this->x0, this->v0,
+						  this->t_start, this->t_start + (start_steps - 1) * this->delta_t,
+						  start_steps, 1e-13, 1e-15);
+	starter.integrate();
+	this->rhs_evals += starter.get_rhs_evals();
+
+	Vec3 start_pos[points];
+	Vec3 start_vel[points];
+	for (int i = 0; i < start_steps; i++) {
+		start_pos[i] = starter.get_pos_arr()[i] / this->R_dim;
+		start_vel[i] = starter.get_vel_arr()[i] / this->V_dim;
+		if (!this->store(i, start_pos[i], start_vel[i])) {
+			this->end_integration();
+			return;
+		}
+	}
+	if (this->steps <= points) {
+		this->end_integration();
+		return;
+	}
+
+	double h = this->delta_t / this->T_dim;
+	double t0 = this->t_start / this->T_dim;
+
+	// Accelerations at the last 'points' samples, f[newest] is the latest one
+	Vec3 f[points];
+	for (int i = 0; i < points; i++) {
+		f[i] = this->de_system.accel(t0 + i * h, start_pos[i], start_vel[i]);
+	}
+	this->rhs_evals += points;
+	int newest = points - 1;
+
+	// Pick the constants of the sums so the correctors reproduce the last start up sample
+	Vec3 zero{0, 0, 0};
+	Vec3 x = start_pos[newest];
+	Vec3 v = start_vel[newest];
+	Vec3 sum1 = (v / h - apply(coeffs.corr_vel, zero, zero, f, newest)) / coeffs.corr_vel.s1;
+	Vec3 sum2 = (x / (h*h) - apply(coeffs.corr_pos, zero, sum1, f, newest)) / coeffs.corr_pos.s2;
+
+	for (int i = points; i < this->steps; i++) {
+		// Predict
+		x = h*h * apply(coeffs.pred_pos, sum2, sum1, f, newest);
+		v = h * apply(coeffs.pred_vel, sum2, sum1, f, newest);
+
+		// Evaluate
+		newest = (newest + 1) % points;
+		f[newest] = this->de_system.accel(t0 + i * h, x, v);
+		this->rhs_evals++;
+		sum1 = sum1 + f[newest];
+		sum2 = sum2 + sum1;
+
+		// Correct
+		x = h*h * apply(coeffs.corr_pos, sum2, sum1, f, newest);
+		v = h * apply(coeffs.corr_vel, sum2, sum1, f, newest);
+
+		if (!this->store(i, x, v)) break;
+	}
+
+	this->end_integration();
+}
+
+} // namespace orbsim
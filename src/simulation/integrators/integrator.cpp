@@ -1,21 +1,29 @@
 #include "integrator.hpp"
-#include "diff_eq.hpp"
+#include "phase_state.hpp"
+#include "variational.hpp"
+#include "events.hpp"
 #include "math_obj.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
+#include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 
 namespace orbsim {
 
-Integrator::Integrator(DESystem<Vec3> de_system, double M, double R0,
+Integrator::Integrator(double M, double R0,
 					   Vec3 x0, Vec3 v0,
 					   double t_i, double t_f, int steps)
-	: de_system(de_system), steps(steps), delta_t((t_f - t_i) / (steps - 1)),
-	  time_arr(new double[steps]{}),
-	  pos_arr(new Vec3[steps]{}), vel_arr(new Vec3[steps]{}) {
+	: t_start(t_i), steps(steps), delta_t((t_f - t_i) / (steps - 1)),
+	  x0(x0), v0(v0), capacity(1), rhs_evals(0), valid_steps(0),
+	  sink(nullptr), window(0), events(nullptr), sample_count(0), stm(false),
+	  two_body(false) {
 	
 	if (t_i < 0) {
 		throw std::domain_error("Start time must be a positive integer!");
@@ -30,9 +38,12 @@ Integrator::Integrator(DESystem<Vec3> de_system, double M, double R0,
 		throw std::domain_error("Steps must be a positive integer!");
 	}
 
-	// this->time_arr = ?
-	this->pos_arr[0] = x0;
-	this->vel_arr[0] = v0;
+	// Only the initial state until the integration, which knows how much room
+	// it needs
+	this->buffer.reserve(1);
+	this->buffer.get_time_arr()[0] = t_i;
+	this->buffer.get_pos_arr()[0] = x0;
+	this->buffer.get_vel_arr()[0] = v0;
 	this->M = M;
 	this->R0 = R0;
 
@@ -43,50 +54,156 @@ Integrator::Integrator(DESystem<Vec3> de_system, double M, double R0,
 }
 
 Integrator::Integrator(const Integrator &other)
-	: de_system(other.de_system), steps(other.steps), delta_t(other.delta_t),
-	  time_arr(new double[other.steps]{}),
-	  pos_arr(new Vec3[other.steps]{}), vel_arr(new Vec3[other.steps]{}) {
+	: t_start(other.t_start), steps(other.steps), delta_t(other.delta_t),
+	  x0(other.x0), v0(other.v0), capacity(other.capacity), buffer(other.buffer),
+	  rhs_evals(other.rhs_evals), valid_steps(other.valid_steps),
+	  sink(other.sink), window(other.window), events(other.events),
+	  sample_count(other.sample_count), stm(other.stm), stm_arr(other.stm_arr),
+	  two_body(other.two_body) {
 
 	this->M = other.M;
 	this->R0 = other.R0;
-	for (int i = 0; i < other.steps; i++) {
-		this->time_arr[i] = other.time_arr[i];
-		this->pos_arr[i] = other.pos_arr[i];
-		this->vel_arr[i] = other.vel_arr[i];
-	}
+	this->R_dim = other.R_dim;
+	this->V_dim = other.V_dim;
+	this->T_dim = other.T_dim;
 }
 
 Integrator &Integrator::operator=(const Integrator &other) {
 	Integrator *integ_copy = other.copy();
-	std::swap(this->de_system, integ_copy->de_system);
 	std::swap(this->M, integ_copy->M);
 	std::swap(this->R0, integ_copy->R0);
+	std::swap(this->t_start, integ_copy->t_start);
 	std::swap(this->steps, integ_copy->steps);
 	std::swap(this->delta_t, integ_copy->delta_t);
-	std::swap(this->time_arr, integ_copy->time_arr);
-	std::swap(this->pos_arr, integ_copy->pos_arr);
-	std::swap(this->vel_arr, integ_copy->vel_arr);
+	std::swap(this->x0, integ_copy->x0);
+	std::swap(this->v0, integ_copy->v0);
+	std::swap(this->capacity, integ_copy->capacity);
+	this->buffer.swap(integ_copy->buffer);
+	std::swap(this->rhs_evals, integ_copy->rhs_evals);
+	std::swap(this->valid_steps, integ_copy->valid_steps);
+	std::swap(this->sink, integ_copy->sink);
+	std::swap(this->window, integ_copy->window);
+	std::swap(this->events, integ_copy->events);
+	std::swap(this->sample_count, integ_copy->sample_count);
+	std::swap(this->stm, integ_copy->stm);
+	std::swap(this->stm_arr, integ_copy->stm_arr);
+	std::swap(this->two_body, integ_copy->two_body);
+	std::swap(this->R_dim, integ_copy->R_dim);
+	std::swap(this->V_dim, integ_copy->V_dim);
+	std::swap(this->T_dim, integ_copy->T_dim);
+	delete integ_copy;
 
 	return *this;
 }
 
-Integrator::~Integrator() {
-	delete[] this->time_arr;
-	delete[] this->pos_arr;
-	delete[] this->vel_arr;
-}
+Integrator::~Integrator() {}
 
 int Integrator::get_steps() const { return this->steps; }
 double Integrator::get_delta_t() const { return this->delta_t; }
-double *Integrator::get_time_arr() const { return this->time_arr; }
-Vec3 *Integrator::get_pos_arr() const { return this->pos_arr; }
-Vec3 *Integrator::get_vel_arr() const { return this->vel_arr; }
+long long Integrator::get_rhs_evals() const { return this->rhs_evals; }
+int Integrator::get_valid_steps() const { return this->valid_steps; }
+int Integrator::get_sample_count() const { return this->sample_count; }
+bool Integrator::has_stm() const { return false; }
+bool Integrator::get_stm() const { return this->stm; }
+const Mat6 *Integrator::get_stm_arr() const { return this->stm ? this->stm_arr.data() : nullptr; }
+double *Integrator::get_time_arr() const { return this->buffer.get_time_arr(); }
+Vec3 *Integrator::get_pos_arr() const { return this->buffer.get_pos_arr(); }
+Vec3 *Integrator::get_vel_arr() const { return this->buffer.get_vel_arr(); }
+TrajectorySink *Integrator::get_sink() const { return this->sink; }
+const TrajectoryBuffer &Integrator::get_buffer() const { return this->buffer; }
+EventDetector *Integrator::get_events() const { return this->events; }
+
+double Integrator::get_energy_error() const {
+	if (!this->two_body) {
+		throw std::domain_error("The energy error is only defined for point-mass gravity (OrbitDE)!");
+	}
+	if (this->valid_steps == 0) {
+		throw std::domain_error("The trajectory isn't in memory, integrate() without a sink first!");
+	}
+
+	// Specific orbital energy of the two-body problem
+	double mu = G * this->M / 1e9;	// [km^3/s^2]
+	auto energy = [mu](const Vec3 &pos, const Vec3 &vel) {
+		return vel.dot(vel) / 2 - mu / pos.len();
+	};
+
+	// Largest relative drift from the initial energy
+	const Vec3 *pos_arr = this->buffer.get_pos_arr();
+	const Vec3 *vel_arr = this->buffer.get_vel_arr();
+	double e0 = energy(pos_arr[0], vel_arr[0]);
+	double max_err = 0;
+	for (int i = 1; i < this->valid_steps; i++) {
+		double err = std::fabs((energy(pos_arr[i], vel_arr[i]) - e0) / e0);
+		if (err > max_err) max_err = err;
+	}
+	return max_err;
+}
+
+void Integrator::extend() {
+	if (!std::isfinite(this->delta_t)) {
+		throw std::domain_error("Can't extend a trajectory without a step size!");
+	}
+
+	// Nothing to continue from, the samples went to a sink or the events and
+	// the state transition matrix need the whole trajectory
+	if (this->sink != nullptr || this->valid_steps == 0 || this->events != nullptr || this->stm) {
+		integrate();
+		return;
+	}
+	if (this->steps <= this->valid_steps) {
+		this->sample_count = this->steps;
+		return;
+	}
+
+	// Integrate the new interval with a copy of this integrator that starts from
+	// the last valid sample. The copy is made without the buffer.
+	int last = this->valid_steps - 1;
+	TrajectoryBuffer kept(this->buffer.get_arena());
+	kept.swap(this->buffer);
+	std::unique_ptr<Integrator> tail(copy());
+	kept.swap(this->buffer);
+
+	tail->t_start = this->t_start + last * this->delta_t;
+	tail->steps = this->steps - last;
+	tail->x0 = this->buffer.get_pos_arr()[last];
+	tail->v0 = this->buffer.get_vel_arr()[last];
+	tail->integrate();
+
+	this->buffer.reserve(this->steps);
+	this->capacity = this->steps;
+	for (int i = 1; i < tail->steps; i++) {
+		this->buffer.get_time_arr()[last + i] = this->t_start + (last + i) * this->delta_t;
+		this->buffer.get_pos_arr()[last + i] = tail->buffer.get_pos_arr()[i];
+		this->buffer.get_vel_arr()[last + i] = tail->buffer.get_vel_arr()[i];
+	}
+	this->rhs_evals = tail->rhs_evals;
+	this->valid_steps = this->steps;
+	this->sample_count = this->steps;
+}
 
 void Integrator::set_steps(int steps) {
 	if (steps <= 0) {
 		throw std::domain_error("Steps must be a positive integer!");
 	}
+	if (steps == this->steps) return;
+
+	// Same time span, divided into the new number of steps
+	if (this->steps > 1 && steps > 1) {
+		this->delta_t = this->delta_t * (this->steps - 1) / (steps - 1);
+	}
+	this->steps = steps;
+	this->valid_steps = 0;
+}
+
+void Integrator::resize(int steps) {
+	if (steps <= 0) {
+		throw std::domain_error("Steps must be a positive integer!");
+	}
+
+	// Same step size, the samples computed so far stay valid up to the new end
 	this->steps = steps;
+	this->valid_steps = std::min(this->valid_steps, steps);
+	this->sample_count = std::min(this->sample_count, steps);
 }
 
 void Integrator::set_delta_t(int t_start, int t_end) {
@@ -99,22 +216,192 @@ void Integrator::set_delta_t(int t_start, int t_end) {
 	if (t_end <= t_start) {
 		throw std::domain_error("End time must be larger than start time!");
 	}
+	this->t_start = t_start;
 	this->delta_t = (t_end - t_start) / (this->steps - 1);
+	this->valid_steps = 0;
 }
 
 void Integrator::set_x0(Vec3 x0) {
-	this->pos_arr[0] = x0;
+	if (x0 != this->x0) this->valid_steps = 0;
+	this->x0 = x0;
+	this->buffer.get_pos_arr()[0] = x0;
 }
 
 void Integrator::set_v0(Vec3 v0) {
-	this->vel_arr[0] = v0;
+	if (v0 != this->v0) this->valid_steps = 0;
+	this->v0 = v0;
+	this->buffer.get_vel_arr()[0] = v0;
+}
+
+void Integrator::set_sink(TrajectorySink *sink, int window) {
+	if (window <= 0) {
+		throw std::domain_error("Window must be a positive integer!");
+	}
+	this->sink = sink;
+	this->window = window;
+}
+
+void Integrator::set_arena(TrajectoryArena *arena) {
+	this->buffer.set_arena(arena);
+}
+
+void Integrator::set_events(EventDetector *events) {
+	this->events = events;
+	this->valid_steps = 0;
+}
+
+void Integrator::set_stm(bool stm) {
+	if (stm && !has_stm()) {
+		throw std::domain_error("Only the RK4, DOPRI5 and RK87 integrators propagate the state transition matrix!");
+	}
+	if (stm != this->stm) this->valid_steps = 0;
+	this->stm = stm;
+}
+
+void Integrator::swap_buffer(Integrator &other) {
+	this->buffer.swap(other.buffer);
+	std::swap(this->capacity, other.capacity);
+	this->valid_steps = 0;
+	other.valid_steps = 0;
+
+	// The initial state stays with each integrator
+	for (Integrator *integ : {this, &other}) {
+		integ->buffer.get_time_arr()[0] = integ->t_start;
+		integ->buffer.get_pos_arr()[0] = integ->x0;
+		integ->buffer.get_vel_arr()[0] = integ->v0;
+	}
+}
+
+void Integrator::load_samples(const double *time_arr, const Vec3 *pos_arr, const Vec3 *vel_arr) {
+	// Results of an earlier integration with the same settings
+	this->buffer.reserve(this->steps);
+	this->capacity = this->steps;
+	std::copy(time_arr, time_arr + this->steps, this->buffer.get_time_arr());
+	std::copy(pos_arr, pos_arr + this->steps, this->buffer.get_pos_arr());
+	std::copy(vel_arr, vel_arr + this->steps, this->buffer.get_vel_arr());
+	this->rhs_evals = 0;
+	this->valid_steps = this->steps;
+	this->sample_count = this->steps;
+}
+
+void Integrator::begin_integration() {
+	// Whole trajectory in memory, or just one window of it for the sink
+	int needed = this->sink != nullptr ? std::min(this->window, this->steps) : this->steps;
+	this->valid_steps = 0;
+	this->sample_count = this->steps;
+
+	// The buffer only grows, a whole trajectory left from an earlier run is
+	// given back before streaming
+	if (this->sink != nullptr && this->buffer.get_capacity() > needed) {
+		TrajectoryBuffer(this->buffer.get_arena()).swap(this->buffer);
+		std::vector<Mat6>().swap(this->stm_arr);
+	}
+	this->buffer.reserve(needed);
+	this->capacity = needed;
+	if (this->stm && (int) this->stm_arr.size() < needed) this->stm_arr.resize(needed);
+
+	if (this->sink != nullptr) this->sink->begin(this->steps);
+}
+
+void Integrator::write(int i, const Vec3 &pos, const Vec3 &vel) {
+	int slot = i % this->capacity;
+	this->buffer.get_time_arr()[slot] = this->t_start + i * this->delta_t;
+
+	// Convert back to kilometers
+	this->buffer.get_pos_arr()[slot] = pos * this->R_dim;
+	this->buffer.get_vel_arr()[slot] = vel * this->V_dim;
+}
+
+void Integrator::flush(int first, int count) {
+	if (this->sink == nullptr) return;
+
+	int slot = first % this->capacity;
+	this->sink->consume(TrajectoryBlock{
+		first, count, this->buffer.get_time_arr() + slot,
+		this->buffer.get_pos_arr() + slot, this->buffer.get_vel_arr() + slot,
+		this->stm ? this->stm_arr.data() + slot : nullptr
+	});
+}
+
+bool Integrator::detect(int i) {
+	if (this->events == nullptr) return true;
+
+	int slot = i % this->capacity;
+	double &t = this->buffer.get_time_arr()[slot];
+	Vec3 &pos = this->buffer.get_pos_arr()[slot];
+	Vec3 &vel = this->buffer.get_vel_arr()[slot];
+	if (i == 0) {
+		this->events->begin(t, pos, vel);
+		return true;
+	}
+	if (this->events->step(t, pos, vel)) return true;
+
+	// The trajectory ends at the terminal event, the matrix is interpolated linearly
+	const Event &event = this->events->get_events().back();
+	if (this->stm && this->capacity > 1) {
+		const Mat6 &prev = this->stm_arr[(i - 1) % this->capacity];
+		Mat6 &matrix = this->stm_arr[slot];
+		double t_prev = this->buffer.get_time_arr()[(i - 1) % this->capacity];
+		double s = (event.t - t_prev) / (t - t_prev);
+		for (int k = 0; k < 36; k++) matrix[k] = prev[k] + s * (matrix[k] - prev[k]);
+	}
+	t = event.t;
+	pos = event.pos;
+	vel = event.vel;
+	this->sample_count = i + 1;
+	return false;
+}
+
+bool Integrator::store(int i, const Vec3 &pos, const Vec3 &vel) {
+	write(i, pos, vel);
+	bool running = detect(i);
+
+	// Hand the window over once it is full
+	int slot = i % this->capacity;
+	if (slot == this->capacity - 1 || i == this->steps - 1 || !running) {
+		flush(i - slot, slot + 1);
+	}
+	return running;
+}
+
+bool Integrator::store(int i, const PhaseState &y) {
+	return store(i, y.pos, y.vel);
+}
+
+bool Integrator::store(int i, const StmState &s) {
+	// Back to dimensional units, the blocks of the matrix scale with time
+	Mat6 &matrix = this->stm_arr[i % this->capacity];
+	for (int k = 0; k < 6; k++) {
+		const PhaseState &col = s.phi[k];
+		double pos_scale = k < 3 ? 1 : this->T_dim;
+		double vel_scale = k < 3 ? 1 / this->T_dim : 1;
+		matrix[0 * 6 + k] = col.pos.x * pos_scale;
+		matrix[1 * 6 + k] = col.pos.y * pos_scale;
+		matrix[2 * 6 + k] = col.pos.z * pos_scale;
+		matrix[3 * 6 + k] = col.vel.x * vel_scale;
+		matrix[4 * 6 + k] = col.vel.y * vel_scale;
+		matrix[5 * 6 + k] = col.vel.z * vel_scale;
+	}
+	return store(i, s.y.pos, s.y.vel);
+}
+
+void Integrator::end_integration() {
+	if (this->sink != nullptr) {
+		this->sink->end(this->sample_count);
+	} else {
+		this->valid_steps = this->sample_count;
+	}
 }
 
 void Integrator::save_to_file(const char *filename) const
 {
+	if (this->valid_steps == 0) {
+		throw std::domain_error("The trajectory isn't in memory, integrate() without a sink first!");
+	}
+
 	std::ofstream of(filename);
-	for (int i = 0; i < this->steps; i++) {
-		of << pos_arr[i].to_str() << " " << vel_arr[i].to_str() << "\n";
+	for (int i = 0; i < this->valid_steps; i++) {
+		of << get_pos_arr()[i].to_str() << " " << get_vel_arr()[i].to_str() << "\n";
 	}
 }
 
@@ -1,51 +1,121 @@
 #ifndef INTEGRATOR_HPP
 #define INTEGRATOR_HPP
 
-#include "simulation/diff_eq.hpp"
+#include "simulation/integrators/phase_state.hpp"
+#include "simulation/integrators/variational.hpp"
+#include "simulation/events.hpp"
 #include "simulation/math_obj.hpp"
+#include "simulation/trajectory_buffer.hpp"
+#include "simulation/trajectory_sink.hpp"
+
+#include <vector>
 
 
 namespace orbsim {
 
 /**
  * @brief Generic integrator
+ *
+ * Doesn't know about the equations being solved, those are given to the
+ * derived integrators as a template parameter (see diff_eq.hpp). Any type
+ * with an accel(t, x, v) member works, the library only has OrbitDE,
+ * DESystem<Vec3> and ForceModelDE built in.
+ *
+ * By default the whole trajectory is kept in the arrays. With a sink they
+ * only hold a window of samples which is passed on to the sink every time
+ * it fills up, so the memory doesn't grow with the number of steps.
+ *
+ * The arrays only grow, repeated integrations reuse them. After resize()
+ * extend() only integrates the steps that were added since the last
+ * in-memory integration.
+ *
+ * With an event detector every stored sample is checked for events. A
+ * terminal event ends the integration early, the last sample is then the
+ * state at the event and get_sample_count() is less than the steps.
+ *
+ * Integrators that support it can also propagate the state transition
+ * matrix from the initial state to every sample. It is kept next to the
+ * samples, one fixed-size matrix per step, and passed on to the sink.
+ *
+ * get_energy_error() and save_to_file() read the samples kept in memory,
+ * so they need an integration without a sink. The energy error is the one
+ * of the two-body problem and is only available with OrbitDE.
  */
 class Integrator {
 
 public:
-	Integrator(DESystem<Vec3> de_system, double M, double R0, Vec3 x0, Vec3 v0,
+	Integrator(double M, double R0, Vec3 x0, Vec3 v0,
 			   double t_i, double t_f, int steps);
 	Integrator(const Integrator &other);
 	Integrator &operator=(const Integrator &other);
 
 	virtual Integrator *copy() const = 0;
 
-	~Integrator();
+	virtual ~Integrator();
 
 	virtual void integrate() = 0;
+	void extend();
 
 	int get_steps() const;
 	double get_delta_t() const;
+	long long get_rhs_evals() const;
+	int get_valid_steps() const;
+	int get_sample_count() const;
+	virtual bool has_stm() const;
+	bool get_stm() const;
+	const Mat6 *get_stm_arr() const;
+	double get_energy_error() const;
 	double *get_time_arr() const;
 	Vec3 *get_pos_arr() const;
 	Vec3 *get_vel_arr() const;
+	TrajectorySink *get_sink() const;
+	const TrajectoryBuffer &get_buffer() const;
+	EventDetector *get_events() const;
 
 	void set_steps(int steps);
+	void resize(int steps);
 	void set_delta_t(int t_start, int t_end);
 	void set_x0(Vec3 x0);
 	void set_v0(Vec3 v0);
+	void set_sink(TrajectorySink *sink, int window = 1024);
+	void set_arena(TrajectoryArena *arena);
+	void set_events(EventDetector *events);
+	void set_stm(bool stm);
+
+	void swap_buffer(Integrator &other);
+	void load_samples(const double *time_arr, const Vec3 *pos_arr, const Vec3 *vel_arr);
 
 	void save_to_file(const char *filename) const;
 
 protected:
+	// Called by the derived integrate(), the states are in dimensionless units
+	void begin_integration();
+	void write(int i, const Vec3 &pos, const Vec3 &vel);
+	void flush(int first, int count);
+	bool detect(int i);
+	bool store(int i, const Vec3 &pos, const Vec3 &vel);
+	bool store(int i, const PhaseState &y);
+	bool store(int i, const StmState &s);
+	void end_integration();
+
 	double M;	// [kg]
 	double R0;	// [km]
-	DESystem<Vec3> de_system;
+	double t_start;	// [s]
 	int steps;
 	double delta_t;
-	double *time_arr;
-	Vec3 *pos_arr;	// [km]
-	Vec3 *vel_arr;	// [km/s]
+	Vec3 x0;	// [km]
+	Vec3 v0;	// [km/s]
+	int capacity;	// samples kept in the buffer, it may have room for more
+	TrajectoryBuffer buffer;
+	long long rhs_evals;	// in the last integrate()
+	int valid_steps;	// samples in the buffer that match the current settings
+	TrajectorySink *sink;	// not owned, may be null
+	int window;
+	EventDetector *events;	// not owned, may be null
+	int sample_count;	// in the last integrate()
+	bool stm;
+	std::vector<Mat6> stm_arr;	// as many as the buffer, in [1], [s] and [1/s]
+	bool two_body;	// set by the derived integrators for point-mass gravity
 
 	double R_dim;
 	double V_dim;
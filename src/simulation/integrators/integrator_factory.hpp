@@ -4,6 +4,7 @@
 #include "simulation/celestial_obj.hpp"
 #include "simulation/integrators/integrator.hpp"
 #include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
 #include "simulation/math_obj.hpp"
 
 #include <string>
@@ -11,17 +12,21 @@
 
 namespace orbsim {
 
+/**
+ * @brief Creates integrators by name for the system of equations DE
+ */
+template <typename DE>
 class IntegratorFactory {
 
 public:
-	IntegratorFactory(DESystem<Vec3> de_system, CelestialObj cel_obj,
+	IntegratorFactory(DE de_system, CelestialObj cel_obj,
 					  Vec3 x0, Vec3 v0,
 					  double t_start, double t_end, int t_steps);
 
 	Integrator *create(std::string type);
 
 private:
-	DESystem<Vec3> de_system;
+	DE de_system;
 	CelestialObj cel_obj;
 	Vec3 x0;
 	Vec3 v0;
@@ -30,7 +35,13 @@ private:
 	double t_steps;
 };
 
+extern template class IntegratorFactory<OrbitDE>;
+extern template class IntegratorFactory<DESystem<Vec3>>;
+extern template class IntegratorFactory<ForceModelDE>;
+
 } // namespace orbsim
 
+#include "simulation/integrators/integrator_factory.ipp"
+
 
 #endif	// INTEGRATOR_FACTORY_HPP
@@ -0,0 +1,60 @@
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/integrators/euler.hpp"
+#include "simulation/integrators/verlet.hpp"
+#include "simulation/integrators/rk4.hpp"
+#include "simulation/integrators/dopri5.hpp"
+#include "simulation/integrators/rk87.hpp"
+#include "simulation/integrators/gauss_jackson.hpp"
+#include "simulation/integrators/yoshida.hpp"
+#include "simulation/integrators/kepler.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
+
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+
+
+namespace orbsim {
+
+template <typename DE>
+IntegratorFactory<DE>::IntegratorFactory(DE de_system, CelestialObj cel_obj,
+										 Vec3 x0, Vec3 v0,
+										 double t_start, double t_end, int t_steps)
+	: de_system(de_system), cel_obj(cel_obj), x0(x0), v0(v0),
+	  t_start(t_start), t_end(t_end), t_steps(t_steps) {}
+
+template <typename DE>
+Integrator *IntegratorFactory<DE>::create(std::string type) {
+	if (type == "Euler") {
+		return new BasicEuler<DE>(de_system, cel_obj.mass, cel_obj.radius, x0, v0, t_start, t_end, t_steps);
+	} else if (type == "Verlet") {
+		return new BasicVerlet<DE>(de_system, cel_obj.mass, cel_obj.radius, x0, v0, t_start, t_end, t_steps);
+	} else if (type == "RK4") {
+		return new BasicRK4<DE>(de_system, cel_obj.mass, cel_obj.radius, x0, v0, t_start, t_end, t_steps);
+	} else if (type == "DOPRI5") {
+		return new BasicDOPRI5<DE>(de_system, cel_obj.mass, cel_obj.radius, x0, v0, t_start, t_end, t_steps);
+	} else if (type == "RK87") {
+		return new BasicRK87<DE>(de_system, cel_obj.mass, cel_obj.radius, x0, v0, t_start, t_end, t_steps);
+	} else if (type == "GaussJackson") {
+		return new BasicGaussJackson<DE>(de_system, cel_obj.mass, cel_obj.radius, x0, v0, t_start, t_end, t_steps);
+	} else if (type == "Yoshida4") {
+		return new BasicYoshida<DE, 4>(de_system, cel_obj.mass, cel_obj.radius, x0, v0, t_start, t_end, t_steps);
+	} else if (type == "Yoshida6") {
+		return new BasicYoshida<DE, 6>(de_system, cel_obj.mass, cel_obj.radius, x0, v0, t_start, t_end, t_steps);
+	} else if (type == "Yoshida8") {
+		return new BasicYoshida<DE, 8>(de_system, cel_obj.mass, cel_obj.radius, x0, v0, t_start, t_end, t_steps);
+	} else if (type == "Kepler") {
+		// The closed form solution only exists for point-mass gravity
+		if constexpr (std::is_same_v<DE, OrbitDE>) {
+			return new Kepler(de_system, cel_obj.mass, cel_obj.radius, x0, v0, t_start, t_end, t_steps);
+		} else {
+			throw std::domain_error("Kepler propagation only works with point-mass gravity (OrbitDE)!");
+		}
+	} else {
+		throw std::domain_error("Invalid integrator! Should be one of: Euler, Verlet, RK4, DOPRI5, RK87, GaussJackson, Yoshida4, Yoshida6, Yoshida8 and Kepler");
+	}
+}
+
+} // namespace orbsim
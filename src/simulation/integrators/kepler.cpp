@@ -0,0 +1,179 @@
+#include "kepler.hpp"
+#include "integrator.hpp"
+#include "diff_eq.hpp"
+#include "math_obj.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+
+namespace orbsim {
+
+namespace {
+
+// Samples per parallel task
+const int block_size = 4096;
+
+// Stumpff functions c2(z) and c3(z)
+void stumpff(double z, double &c2, double &c3) {
+	if (z > 1e-6) {
+		double sz = std::sqrt(z);
+		c2 = (1 - std::cos(sz)) / z;
+		c3 = (sz - std::sin(sz)) / (z * sz);
+	} else if (z < -1e-6) {
+		double sz = std::sqrt(-z);
+		c2 = (std::cosh(sz) - 1) / -z;
+		c3 = (std::sinh(sz) - sz) / (-z * sz);
+	} else {
+		c2 = 1.0/2 - z/24 + z*z/720;
+		c3 = 1.0/6 - z/120 + z*z/5040;
+	}
+}
+
+// Initial state and the constants of its orbit, in dimensionless units (mu = 1)
+struct TwoBody {
+	Vec3 r0;
+	Vec3 v0;
+	double r0_len;
+	double sigma0;	// r0 . v0
+	double alpha;	// 1 / semi-major axis
+	double period;	// 0 unless elliptic
+
+	TwoBody(Vec3 r0, Vec3 v0) : r0(r0), v0(v0) {
+		this->r0_len = r0.len();
+		this->sigma0 = r0.dot(v0);
+		this->alpha = 2 / this->r0_len - v0.dot(v0);
+		this->period = this->alpha > 1e-12 ? 2 * PI / (this->alpha * std::sqrt(this->alpha)) : 0;
+	}
+
+	// Initial guess for the universal anomaly (Vallado, Fundamentals of Astrodynamics, algorithm 8)
+	double guess(double dt) const {
+		if (this->alpha > 1e-12) {
+			return dt * this->alpha;
+		}
+		if (this->alpha < -1e-12 && dt != 0) {
+			double a = 1 / this->alpha;
+			double s = dt > 0 ? 1 : -1;
+			double arg = -2 * this->alpha * dt / (this->sigma0 + s * std::sqrt(-a) * (1 - this->r0_len * this->alpha));
+			if (arg > 0) return s * std::sqrt(-a) * std::log(arg);
+		}
+		return dt / this->r0_len;
+	}
+
+	/**
+	 * State after time dt. The universal Kepler equation is solved with the
+	 * Laguerre-Conway iteration starting from chi, which converges even from
+	 * a rough guess. On return chi is the solution.
+	 */
+	void state_at(double dt, double &chi, Vec3 &r, Vec3 &v) const {
+		const double n = 5;
+		double chi2, z, c2, c3;
+		for (int iter = 0; iter < 50; iter++) {
+			chi2 = chi * chi;
+			z = this->alpha * chi2;
+			stumpff(z, c2, c3);
+
+			double F = this->sigma0 * chi2 * c2 + (1 - this->alpha * this->r0_len) * chi2 * chi * c3
+					   + this->r0_len * chi - dt;
+			if (std::fabs(F) <= 1e-14 * std::max(1.0, std::fabs(dt))) break;
+
+			double dF = chi2 * c2 + this->sigma0 * chi * (1 - z * c3) + this->r0_len * (1 - z * c2);
+			double ddF = this->sigma0 * (1 - z * c2) + (1 - this->alpha * this->r0_len) * chi * (1 - z * c3);
+
+			double root = std::sqrt(std::fabs((n - 1) * (n - 1) * dF * dF - n * (n - 1) * F * ddF));
+			chi -= n * F / (dF + (dF >= 0 ? root : -root));
+		}
+
+		// Lagrange coefficients
+		double f = 1 - chi2 / this->r0_len * c2;
+		double g = dt - chi2 * chi * c3;
+		r = f * this->r0 + g * this->v0;
+
+		double r_len = r.len();
+		double df = chi / (r_len * this->r0_len) * (this->alpha * chi2 * c3 - 1);
+		double dg = 1 - chi2 / r_len * c2;
+		v = df * this->r0 + dg * this->v0;
+	}
+};
+
+} // namespace
+
+Kepler::Kepler(OrbitDE, double M, double R0, Vec3 x0, Vec3 v0,
+			   double t_i, double t_f, int steps)
+	: Integrator(M, R0, x0, v0, t_i, t_f, steps), pool(nullptr) {
+
+	this->two_body = true;
+}
+
+Kepler *Kepler::copy() const { return new Kepler(*this); }
+
+void Kepler::set_thread_pool(ThreadPool *pool) { this->pool = pool; }
+
+void Kepler::integrate() {
+	// Norm the initial conditions
+	this->begin_integration();
+	TwoBody orbit(this->x0 / this->R_dim, this->v0 / this->V_dim);
+	double dt = this->delta_t / this->T_dim;
+
+	auto fill = [&](int first, int last) {
+		double chi = 0;
+		double prev_t = 0;
+		double prev_r = 0;
+		bool warm = false;
+
+		for (int i = first; i < last; i++) {
+			// Whole revolutions don't change the state
+			double t = i * dt;
+			if (orbit.period != 0) t -= std::floor(t / orbit.period) * orbit.period;
+
+			// Since dchi/dt = 1/r the previous sample gives a close guess
+			if (warm && t > prev_t) {
+				chi += (t - prev_t) / prev_r;
+			} else {
+				chi = orbit.guess(t);
+			}
+
+			Vec3 r, v;
+			orbit.state_at(t, chi, r, v);
+			prev_t = t;
+			prev_r = r.len();
+			warm = true;
+
+			this->write(i, r, v);
+		}
+	};
+
+	// One window of the arrays at a time, that is all of them without a sink
+	for (int first = 0; first < this->steps; first += this->capacity) {
+		int last = std::min(this->steps, first + this->capacity);
+
+		if (this->pool != nullptr && last - first > block_size) {
+			int blocks = (last - first + block_size - 1) / block_size;
+			this->pool->parallel_for(blocks, [&](std::size_t b) {
+				int block_first = first + (int) b * block_size;
+				fill(block_first, std::min(last, block_first + block_size));
+			});
+		} else {
+			fill(first, last);
+		}
+
+		// Events are found in order once the window is filled
+		int count = last - first;
+		for (int i = first; i < last; i++) {
+			if (!this->detect(i)) {
+				count = i + 1 - first;
+				break;
+			}
+		}
+		this->flush(first, count);
+		if (count < last - first) break;
+	}
+
+	this->rhs_evals = 0;
+
+	this->end_integration();
+}
+
+} // namespace orbsim
@@ -0,0 +1,43 @@
+#ifndef KEPLER_HPP
+#define KEPLER_HPP
+
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/thread_pool.hpp"
+
+#include <cstddef>
+
+
+namespace orbsim {
+
+/**
+ * @brief Analytic two-body propagator using universal variables
+ *
+ * Solves the universal Kepler equation for every output sample directly
+ * from the initial state, so no steps are taken and each sample costs the
+ * same no matter how far away it is. Works for elliptic, parabolic and
+ * hyperbolic orbits. Only valid for point-mass gravity, hence the OrbitDE.
+ */
+class Kepler : public Integrator {
+
+public:
+	Kepler(OrbitDE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+		   double t_i, double t_f, int steps);
+
+	Kepler *copy() const override;
+
+	void integrate() override;
+
+	// The samples are independent, with a pool they are computed in parallel.
+	// Inside a task of the same pool they are computed on the calling thread.
+	void set_thread_pool(ThreadPool *pool);
+
+private:
+	ThreadPool *pool;	// not owned, may be null
+};
+
+} // namespace orbsim
+
+
+#endif	// KEPLER_HPP
@@ -0,0 +1,45 @@
+#ifndef PHASE_STATE_HPP
+#define PHASE_STATE_HPP
+
+#include "simulation/math_obj.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace orbsim {
+
+/**
+ * @brief Position and velocity treated as one vector by the RK integrators
+ *
+ * The same 6-vector as the Cartesian state, in the dimensionless units of
+ * the integrators.
+ */
+using PhaseState = CartElem;
+
+/**
+ * @brief Weighted RMS norm of a local error estimate, used for step size control
+ *
+ * Every component is scaled by abs_tol + rel_tol * max(|y0|, |y1|), so a
+ * value <= 1 means the step is accurate enough.
+ */
+inline double err_norm(const PhaseState &err, const PhaseState &y0, const PhaseState &y1,
+					   double rel_tol, double abs_tol) {
+	double sum = 0;
+	auto add = [&](double e, double a, double b) {
+		double sc = abs_tol + rel_tol * std::max(std::fabs(a), std::fabs(b));
+		sum += (e / sc) * (e / sc);
+	};
+	add(err.pos.x, y0.pos.x, y1.pos.x);
+	add(err.pos.y, y0.pos.y, y1.pos.y);
+	add(err.pos.z, y0.pos.z, y1.pos.z);
+	add(err.vel.x, y0.vel.x, y1.vel.x);
+	add(err.vel.y, y0.vel.y, y1.vel.y);
+	add(err.vel.z, y0.vel.z, y1.vel.z);
+	return std::sqrt(sum / 6);
+}
+
+} // namespace orbsim
+
+
+#endif	// PHASE_STATE_HPP
@@ -3,6 +3,7 @@
 
 #include "simulation/integrators/integrator.hpp"
 #include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
 #include "simulation/math_obj.hpp"
 
 
@@ -11,18 +12,33 @@ namespace orbsim {
 /**
  * @brief RK4 (Runge-Kutta 4th order) integrator
  */
-class RK4 : public Integrator {
+template <typename DE>
+class BasicRK4 : public Integrator {
 
 public:
-	RK4(DESystem<Vec3> de_system, double M, double R0, Vec3 x0, Vec3 v0,
-		double t_i, double t_f, int steps);
+	BasicRK4(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+			 double t_i, double t_f, int steps);
 
-	RK4 *copy() const override;
+	BasicRK4 *copy() const override;
 
 	void integrate() override;
+	bool has_stm() const override;
+
+private:
+	void integrate_stm();
+
+	DE de_system;
 };
 
+using RK4 = BasicRK4<OrbitDE>;
+
+extern template class BasicRK4<OrbitDE>;
+extern template class BasicRK4<DESystem<Vec3>>;
+extern template class BasicRK4<ForceModelDE>;
+
 } // namespace orbsim
 
+#include "simulation/integrators/rk4.ipp"
+
 
 #endif	// RK4_HPP
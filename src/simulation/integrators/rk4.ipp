@@ -0,0 +1,111 @@
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/integrators/phase_state.hpp"
+#include "simulation/integrators/variational.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <type_traits>
+
+
+namespace orbsim {
+
+template <typename DE>
+BasicRK4<DE>::BasicRK4(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+					   double t_i, double t_f, int steps)
+	: Integrator(M, R0, x0, v0, t_i, t_f, steps), de_system(de_system) {
+
+	this->two_body = std::is_same_v<DE, OrbitDE>;
+}
+
+template <typename DE>
+BasicRK4<DE> *BasicRK4<DE>::copy() const { return new BasicRK4(*this); }
+
+template <typename DE>
+bool BasicRK4<DE>::has_stm() const { return true; }
+
+template <typename DE>
+void BasicRK4<DE>::integrate() {
+	if (this->stm) {
+		integrate_stm();
+		return;
+	}
+
+	// Norm the initial conditions
+	this->begin_integration();
+	Vec3 pos = this->x0 / this->R_dim;
+	Vec3 vel = this->v0 / this->V_dim;
+	double dt = this->delta_t / this->T_dim;
+	double t0 = this->t_start / this->T_dim;
+	this->store(0, pos, vel);
+
+	struct {
+		Vec3 pos;
+		Vec3 vel;
+	} rk_slopes[4];
+
+	Vec3 pos_temp;
+	Vec3 vel_temp;
+
+	for (int i = 0; i < this->steps - 1; i++) {
+		double t = t0 + i * dt;
+
+		rk_slopes[0].pos = vel;
+		rk_slopes[0].vel = this->de_system.accel(t, pos, vel);
+
+		pos_temp = fmadd(dt/2, rk_slopes[0].pos, pos);
+		vel_temp = fmadd(dt/2, rk_slopes[0].vel, vel);
+
+		rk_slopes[1].pos = vel_temp;
+		rk_slopes[1].vel = this->de_system.accel(t + dt/2, pos_temp, vel_temp);
+
+		pos_temp = fmadd(dt/2, rk_slopes[1].pos, pos);
+		vel_temp = fmadd(dt/2, rk_slopes[1].vel, vel);
+
+		rk_slopes[2].pos = vel_temp;
+		rk_slopes[2].vel = this->de_system.accel(t + dt/2, pos_temp, vel_temp);
+
+		pos_temp = fmadd(dt, rk_slopes[2].pos, pos);
+		vel_temp = fmadd(dt, rk_slopes[2].vel, vel);
+
+		rk_slopes[3].pos = vel_temp;
+		rk_slopes[3].vel = this->de_system.accel(t + dt, pos_temp, vel_temp);
+
+		// Final next step estimation
+		pos += (rk_slopes[0].pos + 2*rk_slopes[1].pos + 2*rk_slopes[2].pos + rk_slopes[3].pos)/6 * dt;
+		vel += (rk_slopes[0].vel + 2*rk_slopes[1].vel + 2*rk_slopes[2].vel + rk_slopes[3].vel)/6 * dt;
+
+		if (!this->store(i + 1, pos, vel)) break;
+	}
+
+	this->rhs_evals = 4 * ((long long) this->sample_count - 1);
+
+	this->end_integration();
+}
+
+template <typename DE>
+void BasicRK4<DE>::integrate_stm() {
+	// The same steps with the variational equations alongside
+	this->begin_integration();
+	StmState s = StmState::identity(PhaseState{this->x0 / this->R_dim, this->v0 / this->V_dim});
+	double dt = this->delta_t / this->T_dim;
+	double t0 = this->t_start / this->T_dim;
+	this->store(0, s);
+
+	for (int i = 0; i < this->steps - 1; i++) {
+		double t = t0 + i * dt;
+		StmState k1 = stm_rhs(this->de_system, t, s);
+		StmState k2 = stm_rhs(this->de_system, t + dt/2, s + (dt/2) * k1);
+		StmState k3 = stm_rhs(this->de_system, t + dt/2, s + (dt/2) * k2);
+		StmState k4 = stm_rhs(this->de_system, t + dt, s + dt * k3);
+		s += (dt/6) * (k1 + 2 * k2 + 2 * k3 + k4);
+
+		if (!this->store(i + 1, s)) break;
+	}
+
+	this->rhs_evals = 4 * ((long long) this->sample_count - 1);
+
+	this->end_integration();
+}
+
+} // namespace orbsim
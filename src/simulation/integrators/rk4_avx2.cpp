@@ -0,0 +1,43 @@
+#include "rk4_simd_kernel.hpp"
+#include "rk4_simd.hpp"
+
+#include <cstddef>
+
+#ifdef ORBSIM_SIMD_X86
+#include <immintrin.h>
+#endif
+
+
+namespace orbsim {
+
+#ifdef ORBSIM_SIMD_X86
+
+namespace {
+
+struct Avx2Lanes {
+	static constexpr std::size_t width = 4;
+	__m256d v;
+
+	Avx2Lanes() = default;
+	Avx2Lanes(__m256d v) : v(v) {}
+	explicit Avx2Lanes(double d) : v(_mm256_set1_pd(d)) {}
+
+	static Avx2Lanes load(const double *p) { return _mm256_loadu_pd(p); }
+	static void store(double *p, Avx2Lanes a) { _mm256_storeu_pd(p, a.v); }
+};
+
+inline Avx2Lanes operator+(Avx2Lanes a, Avx2Lanes b) { return _mm256_add_pd(a.v, b.v); }
+inline Avx2Lanes operator*(Avx2Lanes a, Avx2Lanes b) { return _mm256_mul_pd(a.v, b.v); }
+inline Avx2Lanes operator/(Avx2Lanes a, Avx2Lanes b) { return _mm256_div_pd(a.v, b.v); }
+inline Avx2Lanes sqrt(Avx2Lanes a) { return _mm256_sqrt_pd(a.v); }
+inline Avx2Lanes fmadd(Avx2Lanes a, Avx2Lanes b, Avx2Lanes c) { return _mm256_fmadd_pd(a.v, b.v, c.v); }
+
+} // namespace
+
+std::size_t rk4_step_soa_avx2(SoAState state, std::size_t n, double dt) {
+	return rk4_kernel<Avx2Lanes>(state, n, dt);
+}
+
+#endif	// ORBSIM_SIMD_X86
+
+} // namespace orbsim
@@ -0,0 +1,44 @@
+#include "rk4_simd_kernel.hpp"
+#include "rk4_simd.hpp"
+
+#include <cstddef>
+
+#ifdef ORBSIM_SIMD_X86
+#include <immintrin.h>
+#endif
+
+
+namespace orbsim {
+
+#ifdef ORBSIM_SIMD_X86
+
+namespace {
+
+struct Avx512Lanes {
+	static constexpr std::size_t width = 8;
+	__m512d v;
+
+	Avx512Lanes() = default;
+	Avx512Lanes(__m512d v) : v(v) {}
+	explicit Avx512Lanes(double d) : v(_mm512_set1_pd(d)) {}
+
+	static Avx512Lanes load(const double *p) { return _mm512_loadu_pd(p); }
+	static void store(double *p, Avx512Lanes a) { _mm512_storeu_pd(p, a.v); }
+};
+
+inline Avx512Lanes operator+(Avx512Lanes a, Avx512Lanes b) { return _mm512_add_pd(a.v, b.v); }
+inline Avx512Lanes operator*(Avx512Lanes a, Avx512Lanes b) { return _mm512_mul_pd(a.v, b.v); }
+inline Avx512Lanes operator/(Avx512Lanes a, Avx512Lanes b) { return _mm512_div_pd(a.v, b.v); }
+// The unmasked form starts from an undefined register, which GCC warns about
+inline Avx512Lanes sqrt(Avx512Lanes a) { return _mm512_mask_sqrt_pd(a.v, 0xFF, a.v); }
+inline Avx512Lanes fmadd(Avx512Lanes a, Avx512Lanes b, Avx512Lanes c) { return _mm512_fmadd_pd(a.v, b.v, c.v); }
+
+} // namespace
+
+std::size_t rk4_step_soa_avx512(SoAState state, std::size_t n, double dt) {
+	return rk4_kernel<Avx512Lanes>(state, n, dt);
+}
+
+#endif	// ORBSIM_SIMD_X86
+
+} // namespace orbsim
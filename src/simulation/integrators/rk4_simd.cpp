@@ -0,0 +1,172 @@
+#include "rk4_simd.hpp"
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(ORBSIM_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+namespace orbsim {
+
+#ifdef ORBSIM_SIMD_X86
+// Defined in rk4_sse2.cpp, rk4_avx2.cpp and rk4_avx512.cpp
+std::size_t rk4_step_soa_sse2(SoAState state, std::size_t n, double dt);
+std::size_t rk4_step_soa_avx2(SoAState state, std::size_t n, double dt);
+std::size_t rk4_step_soa_avx512(SoAState state, std::size_t n, double dt);
+#endif
+
+namespace {
+
+inline void accel(double x, double y, double z, double &ax, double &ay, double &az) {
+	double r2 = x*x + y*y + z*z;
+	double minus_inv_r3 = -1 / (r2 * std::sqrt(r2));
+	ax = x * minus_inv_r3;
+	ay = y * minus_inv_r3;
+	az = z * minus_inv_r3;
+}
+
+// Same steps as rk4_kernel(), one state at a time
+void rk4_step_soa_scalar(SoAState s, std::size_t first, std::size_t n, double dt) {
+	double h2 = dt / 2;
+	double h6 = dt / 6;
+
+	for (std::size_t i = first; i < n; i++) {
+		double x = s.x[i], y = s.y[i], z = s.z[i];
+		double vx = s.vx[i], vy = s.vy[i], vz = s.vz[i];
+
+		// k1 (the position slopes are just the velocities)
+		double a1x, a1y, a1z;
+		accel(x, y, z, a1x, a1y, a1z);
+
+		// k2
+		double k2x = vx + a1x * h2, k2y = vy + a1y * h2, k2z = vz + a1z * h2;
+		double a2x, a2y, a2z;
+		accel(x + vx * h2, y + vy * h2, z + vz * h2, a2x, a2y, a2z);
+
+		// k3
+		double k3x = vx + a2x * h2, k3y = vy + a2y * h2, k3z = vz + a2z * h2;
+		double a3x, a3y, a3z;
+		accel(x + k2x * h2, y + k2y * h2, z + k2z * h2, a3x, a3y, a3z);
+
+		// k4
+		double k4x = vx + a3x * dt, k4y = vy + a3y * dt, k4z = vz + a3z * dt;
+		double a4x, a4y, a4z;
+		accel(x + k3x * dt, y + k3y * dt, z + k3z * dt, a4x, a4y, a4z);
+
+		// Final next step estimation
+		s.x[i] = x + (vx + 2*(k2x + k3x) + k4x) * h6;
+		s.y[i] = y + (vy + 2*(k2y + k3y) + k4y) * h6;
+		s.z[i] = z + (vz + 2*(k2z + k3z) + k4z) * h6;
+		s.vx[i] = vx + (a1x + 2*(a2x + a3x) + a4x) * h6;
+		s.vy[i] = vy + (a1y + 2*(a2y + a3y) + a4y) * h6;
+		s.vz[i] = vz + (a1z + 2*(a2z + a3z) + a4z) * h6;
+	}
+}
+
+#ifdef ORBSIM_SIMD_X86
+bool cpu_has(SimdLevel level) {
+#ifdef _MSC_VER
+	int regs[4];
+	__cpuid(regs, 0);
+	int max_leaf = regs[0];
+
+	__cpuid(regs, 1);
+	bool sse2 = regs[3] & (1 << 26);
+	bool fma = regs[2] & (1 << 12);
+	bool osxsave = regs[2] & (1 << 27);
+	if (level == SimdLevel::SSE2) return sse2;
+	if (!osxsave || max_leaf < 7) return false;
+
+	// The OS must also save the wider registers on context switches
+	unsigned long long xcr0 = _xgetbv(0);
+	bool ymm_saved = (xcr0 & 0x6) == 0x6;
+	bool zmm_saved = (xcr0 & 0xe6) == 0xe6;
+
+	__cpuidex(regs, 7, 0);
+	bool avx2 = regs[1] & (1 << 5);
+	bool avx512f = regs[1] & (1 << 16);
+	if (level == SimdLevel::AVX2) return avx2 && fma && ymm_saved;
+	if (level == SimdLevel::AVX512) return avx512f && zmm_saved;
+	return false;
+#else
+	__builtin_cpu_init();
+	switch (level) {
+	case SimdLevel::SSE2: return __builtin_cpu_supports("sse2");
+	case SimdLevel::AVX2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	case SimdLevel::AVX512: return __builtin_cpu_supports("avx512f");
+	default: return false;
+	}
+#endif
+}
+#endif
+
+SimdLevel detect_simd_level() {
+	if (simd_level_supported(SimdLevel::AVX512)) return SimdLevel::AVX512;
+	if (simd_level_supported(SimdLevel::AVX2)) return SimdLevel::AVX2;
+	if (simd_level_supported(SimdLevel::SSE2)) return SimdLevel::SSE2;
+	return SimdLevel::Scalar;
+}
+
+} // namespace
+
+const char *simd_level_name(SimdLevel level) {
+	switch (level) {
+	case SimdLevel::SSE2: return "SSE2";
+	case SimdLevel::AVX2: return "AVX2";
+	case SimdLevel::AVX512: return "AVX-512";
+	default: return "Scalar";
+	}
+}
+
+bool simd_level_supported(SimdLevel level) {
+	if (level == SimdLevel::Scalar) {
+		return true;
+	}
+#ifdef ORBSIM_SIMD_X86
+	// Querying the CPU is slow on some platforms, so only do it once
+	static const bool supported[] = {
+		true,
+		cpu_has(SimdLevel::SSE2),
+		cpu_has(SimdLevel::AVX2),
+		cpu_has(SimdLevel::AVX512)
+	};
+	return supported[static_cast<int>(level)];
+#else
+	return false;
+#endif
+}
+
+SimdLevel rk4_simd_level() {
+	// Detected once, on first use
+	static const SimdLevel level = detect_simd_level();
+	return level;
+}
+
+void rk4_step_soa(SoAState state, std::size_t n, double dt) {
+	rk4_step_soa(state, n, dt, rk4_simd_level());
+}
+
+void rk4_step_soa(SoAState state, std::size_t n, double dt, SimdLevel level) {
+	std::size_t done = 0;
+
+#ifdef ORBSIM_SIMD_X86
+	if (!simd_level_supported(level)) {
+		level = SimdLevel::Scalar;
+	}
+	switch (level) {
+	case SimdLevel::SSE2: done = rk4_step_soa_sse2(state, n, dt); break;
+	case SimdLevel::AVX2: done = rk4_step_soa_avx2(state, n, dt); break;
+	case SimdLevel::AVX512: done = rk4_step_soa_avx512(state, n, dt); break;
+	default: break;
+	}
+#else
+	(void) level;
+#endif
+
+	// Whatever doesn't fill a whole lane group
+	rk4_step_soa_scalar(state, done, n, dt);
+}
+
+} // namespace orbsim
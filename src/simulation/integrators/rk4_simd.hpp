@@ -0,0 +1,42 @@
+#ifndef RK4_SIMD_HPP
+#define RK4_SIMD_HPP
+
+#include <cstddef>
+
+
+namespace orbsim {
+
+/**
+ * @brief Pointers to two-body states stored as structure-of-arrays
+ */
+struct SoAState {
+	double *x;
+	double *y;
+	double *z;
+	double *vx;
+	double *vy;
+	double *vz;
+};
+
+enum class SimdLevel {
+	Scalar,
+	SSE2,	// 2 states per lane group
+	AVX2,	// 4 states per lane group (with FMA)
+	AVX512	// 8 states per lane group
+};
+
+const char *simd_level_name(SimdLevel level);
+bool simd_level_supported(SimdLevel level);
+SimdLevel rk4_simd_level();
+
+/**
+ * @brief Advances n independent states (dimensionless units, mu = 1) by one
+ * RK4 step, using the widest kernel the CPU supports
+ */
+void rk4_step_soa(SoAState state, std::size_t n, double dt);
+void rk4_step_soa(SoAState state, std::size_t n, double dt, SimdLevel level);
+
+} // namespace orbsim
+
+
+#endif	// RK4_SIMD_HPP
@@ -0,0 +1,80 @@
+#ifndef RK4_SIMD_KERNEL_HPP
+#define RK4_SIMD_KERNEL_HPP
+
+// Internal header, only included by the rk4_<isa>.cpp files. Each of them is
+// compiled with its own instruction set flags, so everything here is kept in
+// an anonymous namespace to avoid mixing instantiations between them.
+
+#include "rk4_simd.hpp"
+
+#include <cstddef>
+
+
+namespace orbsim {
+
+namespace {
+
+// -x/|x|^3 for a whole lane group
+template <typename V>
+inline void accel_lanes(V x, V y, V z, V &ax, V &ay, V &az) {
+	V r2 = fmadd(x, x, fmadd(y, y, z * z));
+	V minus_inv_r3 = V(-1.0) / (r2 * sqrt(r2));
+	ax = x * minus_inv_r3;
+	ay = y * minus_inv_r3;
+	az = z * minus_inv_r3;
+}
+
+/**
+ * @brief RK4 step for as many full lane groups as fit in n
+ *
+ * @return number of states advanced, the rest is left to the scalar kernel
+ */
+template <typename V>
+std::size_t rk4_kernel(SoAState s, std::size_t n, double dt) {
+	const V h(dt);
+	const V h2(dt / 2);
+	const V h6(dt / 6);
+	const V two(2.0);
+
+	std::size_t i = 0;
+	for (; i + V::width <= n; i += V::width) {
+		V x = V::load(s.x + i), y = V::load(s.y + i), z = V::load(s.z + i);
+		V vx = V::load(s.vx + i), vy = V::load(s.vy + i), vz = V::load(s.vz + i);
+
+		// k1 (the position slopes are just the velocities)
+		V a1x, a1y, a1z;
+		accel_lanes(x, y, z, a1x, a1y, a1z);
+
+		// k2
+		V k2x = fmadd(a1x, h2, vx), k2y = fmadd(a1y, h2, vy), k2z = fmadd(a1z, h2, vz);
+		V a2x, a2y, a2z;
+		accel_lanes(fmadd(vx, h2, x), fmadd(vy, h2, y), fmadd(vz, h2, z), a2x, a2y, a2z);
+
+		// k3
+		V k3x = fmadd(a2x, h2, vx), k3y = fmadd(a2y, h2, vy), k3z = fmadd(a2z, h2, vz);
+		V a3x, a3y, a3z;
+		accel_lanes(fmadd(k2x, h2, x), fmadd(k2y, h2, y), fmadd(k2z, h2, z), a3x, a3y, a3z);
+
+		// k4
+		V k4x = fmadd(a3x, h, vx), k4y = fmadd(a3y, h, vy), k4z = fmadd(a3z, h, vz);
+		V a4x, a4y, a4z;
+		accel_lanes(fmadd(k3x, h, x), fmadd(k3y, h, y), fmadd(k3z, h, z), a4x, a4y, a4z);
+
+		// Final next step estimation
+		V::store(s.x + i, fmadd(fmadd(two, k2x + k3x, vx + k4x), h6, x));
+		V::store(s.y + i, fmadd(fmadd(two, k2y + k3y, vy + k4y), h6, y));
+		V::store(s.z + i, fmadd(fmadd(two, k2z + k3z, vz + k4z), h6, z));
+		V::store(s.vx + i, fmadd(fmadd(two, a2x + a3x, a1x + a4x), h6, vx));
+		V::store(s.vy + i, fmadd(fmadd(two, a2y + a3y, a1y + a4y), h6, vy));
+		V::store(s.vz + i, fmadd(fmadd(two, a2z + a3z, a1z + a4z), h6, vz));
+	}
+
+	return i;
+}
+
+} // namespace
+
+} // namespace orbsim
+
+
+#endif	// RK4_SIMD_KERNEL_HPP
@@ -0,0 +1,44 @@
+#include "rk4_simd_kernel.hpp"
+#include "rk4_simd.hpp"
+
+#include <cstddef>
+
+#ifdef ORBSIM_SIMD_X86
+#include <emmintrin.h>
+#endif
+
+
+namespace orbsim {
+
+#ifdef ORBSIM_SIMD_X86
+
+namespace {
+
+struct Sse2Lanes {
+	static constexpr std::size_t width = 2;
+	__m128d v;
+
+	Sse2Lanes() = default;
+	Sse2Lanes(__m128d v) : v(v) {}
+	explicit Sse2Lanes(double d) : v(_mm_set1_pd(d)) {}
+
+	static Sse2Lanes load(const double *p) { return _mm_loadu_pd(p); }
+	static void store(double *p, Sse2Lanes a) { _mm_storeu_pd(p, a.v); }
+};
+
+inline Sse2Lanes operator+(Sse2Lanes a, Sse2Lanes b) { return _mm_add_pd(a.v, b.v); }
+inline Sse2Lanes operator*(Sse2Lanes a, Sse2Lanes b) { return _mm_mul_pd(a.v, b.v); }
+inline Sse2Lanes operator/(Sse2Lanes a, Sse2Lanes b) { return _mm_div_pd(a.v, b.v); }
+inline Sse2Lanes sqrt(Sse2Lanes a) { return _mm_sqrt_pd(a.v); }
+// No FMA in SSE2, so this rounds twice
+inline Sse2Lanes fmadd(Sse2Lanes a, Sse2Lanes b, Sse2Lanes c) { return a * b + c; }
+
+} // namespace
+
+std::size_t rk4_step_soa_sse2(SoAState state, std::size_t n, double dt) {
+	return rk4_kernel<Sse2Lanes>(state, n, dt);
+}
+
+#endif	// ORBSIM_SIMD_X86
+
+} // namespace orbsim
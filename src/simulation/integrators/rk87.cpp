@@ -0,0 +1,13 @@
+#include "rk87.hpp"
+#include "diff_eq.hpp"
+#include "forces/force_model.hpp"
+#include "math_obj.hpp"
+
+
+namespace orbsim {
+
+template class BasicRK87<OrbitDE>;
+template class BasicRK87<DESystem<Vec3>>;
+template class BasicRK87<ForceModelDE>;
+
+} // namespace orbsim
@@ -0,0 +1,61 @@
+#ifndef RK87_HPP
+#define RK87_HPP
+
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
+#include "simulation/math_obj.hpp"
+
+
+namespace orbsim {
+
+/**
+ * @brief Runge-Kutta-Fehlberg 8(7) integrator with adaptive step size
+ *
+ * 13 stages per step. The 8th order solution is propagated and the embedded
+ * 7th order one only estimates the error. The steps are shortened to land
+ * exactly on the requested time grid.
+ */
+template <typename DE>
+class BasicRK87 : public Integrator {
+
+public:
+	BasicRK87(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+			  double t_i, double t_f, int steps,
+			  double rel_tol = 1e-9, double abs_tol = 1e-12);
+
+	BasicRK87 *copy() const override;
+
+	void integrate() override;
+	bool has_stm() const override;
+
+	double get_rel_tol() const;
+	double get_abs_tol() const;
+	int get_accepted_steps() const;
+	int get_rejected_steps() const;
+
+	void set_tolerances(double rel_tol, double abs_tol);
+
+private:
+	template <typename State, typename F>
+	void run(const F &f, State y);
+
+	DE de_system;
+	double rel_tol;
+	double abs_tol;	// in dimensionless units
+	int accepted_steps;
+	int rejected_steps;
+};
+
+using RK87 = BasicRK87<OrbitDE>;
+
+extern template class BasicRK87<OrbitDE>;
+extern template class BasicRK87<DESystem<Vec3>>;
+extern template class BasicRK87<ForceModelDE>;
+
+} // namespace orbsim
+
+#include "simulation/integrators/rk87.ipp"
+
+
+#endif	// RK87_HPP
@@ -0,0 +1,176 @@
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/integrators/phase_state.hpp"
+#include "simulation/integrators/variational.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+
+namespace orbsim {
+
+namespace rk87 {
+
+inline constexpr int stages = 13;
+
+// Butcher tableau (Fehlberg, NASA TR R-287, 1968)
+inline constexpr double c[stages] = {0, 2.0/27, 1.0/9, 1.0/6, 5.0/12, 1.0/2, 5.0/6, 1.0/6, 2.0/3, 1.0/3, 1, 0, 1};
+
+inline constexpr double a[stages][stages - 1] = {
+	{},
+	{2.0/27},
+	{1.0/36, 1.0/12},
+	{1.0/24, 0, 1.0/8},
+	{5.0/12, 0, -25.0/16, 25.0/16},
+	{1.0/20, 0, 0, 1.0/4, 1.0/5},
+	{-25.0/108, 0, 0, 125.0/108, -65.0/27, 125.0/54},
+	{31.0/300, 0, 0, 0, 61.0/225, -2.0/9, 13.0/900},
+	{2, 0, 0, -53.0/6, 704.0/45, -107.0/9, 67.0/90, 3},
+	{-91.0/108, 0, 0, 23.0/108, -976.0/135, 311.0/54, -19.0/60, 17.0/6, -1.0/12},
+	{2383.0/4100, 0, 0, -341.0/164, 4496.0/1025, -301.0/82, 2133.0/4100, 45.0/82, 45.0/164, 18.0/41},
+	{3.0/205, 0, 0, 0, 0, -6.0/41, -3.0/205, -3.0/41, 3.0/41, 6.0/41, 0},
+	{-1777.0/4100, 0, 0, -341.0/164, 4496.0/1025, -289.0/82, 2193.0/4100, 51.0/82, 33.0/164, 12.0/41, 0, 1},
+};
+
+// 8th order weights
+inline constexpr double b[stages] = {0, 0, 0, 0, 0, 34.0/105, 9.0/35, 9.0/35, 9.0/280, 9.0/280, 0, 41.0/840, 41.0/840};
+
+// The 7th order solution only differs in stages 1, 11, 12 and 13
+inline constexpr double e = 41.0/840;
+
+// Step size controller
+inline constexpr double safety = 0.9;
+inline constexpr double fac_min = 0.2;
+inline constexpr double fac_max = 5;
+
+} // namespace rk87
+
+template <typename DE>
+BasicRK87<DE>::BasicRK87(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+						 double t_i, double t_f, int steps,
+						 double rel_tol, double abs_tol)
+	: Integrator(M, R0, x0, v0, t_i, t_f, steps), de_system(de_system),
+	  accepted_steps(0), rejected_steps(0) {
+
+	set_tolerances(rel_tol, abs_tol);
+	this->two_body = std::is_same_v<DE, OrbitDE>;
+}
+
+template <typename DE>
+BasicRK87<DE> *BasicRK87<DE>::copy() const { return new BasicRK87(*this); }
+
+template <typename DE>
+double BasicRK87<DE>::get_rel_tol() const { return this->rel_tol; }
+template <typename DE>
+double BasicRK87<DE>::get_abs_tol() const { return this->abs_tol; }
+template <typename DE>
+int BasicRK87<DE>::get_accepted_steps() const { return this->accepted_steps; }
+template <typename DE>
+int BasicRK87<DE>::get_rejected_steps() const { return this->rejected_steps; }
+
+template <typename DE>
+void BasicRK87<DE>::set_tolerances(double rel_tol, double abs_tol) {
+	if (rel_tol <= 0 || abs_tol <= 0) {
+		throw std::domain_error("Tolerances must be positive numbers!");
+	}
+	this->rel_tol = rel_tol;
+	this->abs_tol = abs_tol;
+}
+
+template <typename DE>
+template <typename State, typename F>
+void BasicRK87<DE>::run(const F &f, State y) {
+	using namespace rk87;
+
+	double grid_dt = this->delta_t / this->T_dim;
+	double t0 = this->t_start / this->T_dim;
+
+	double t = t0;
+	this->store(0, y);
+	State k[stages];
+
+	// Start with one grid step, the controller adjusts it from there
+	double h = grid_dt;
+
+	for (int i = 1; i < this->steps; i++) {
+		double t_target = t0 + i * grid_dt;
+
+		while (t < t_target) {
+			double h_wanted = h;
+			bool last = false;
+			if (t + h >= t_target) {
+				h = t_target - t;
+				last = true;
+			}
+			if (h <= 1e-14 * std::max(1.0, std::fabs(t))) {
+				throw std::runtime_error("RK87 step size became too small!");
+			}
+
+			for (int s = 0; s < stages; s++) {
+				State y_stage = y;
+				for (int j = 0; j < s; j++) {
+					if (a[s][j] != 0) y_stage += (h * a[s][j]) * k[j];
+				}
+				k[s] = f(t + c[s] * h, y_stage);
+			}
+
+			State y_new = y;
+			for (int s = 0; s < stages; s++) {
+				if (b[s] != 0) y_new += (h * b[s]) * k[s];
+			}
+			State err = (h * e) * (k[11] + k[12] - k[0] - k[10]);
+
+			double err_val = err_norm(err, y, y_new, this->rel_tol, this->abs_tol);
+			double fac = err_val == 0 ? fac_max
+									  : std::clamp(safety * std::pow(err_val, -1.0 / 8), fac_min, fac_max);
+
+			if (err_val > 1) {
+				this->rejected_steps++;
+				h *= std::min(1.0, fac);
+				continue;
+			}
+			this->accepted_steps++;
+
+			t = last ? t_target : t + h;
+			y = y_new;
+			// A step cut short by the grid says little about the next one
+			h = last ? std::max(h * fac, h_wanted) : h * fac;
+		}
+
+		if (!this->store(i, y)) break;
+	}
+
+	this->end_integration();
+}
+
+template <typename DE>
+void BasicRK87<DE>::integrate() {
+	this->rhs_evals = 0;
+	this->accepted_steps = 0;
+	this->rejected_steps = 0;
+
+	// Norm the initial conditions
+	this->begin_integration();
+	PhaseState y{this->x0 / this->R_dim, this->v0 / this->V_dim};
+
+	if (this->stm) {
+		run([this](double t, const StmState &s) {
+			this->rhs_evals++;
+			return stm_rhs(this->de_system, t, s);
+		}, StmState::identity(y));
+	} else {
+		run([this](double t, const PhaseState &y) {
+			this->rhs_evals++;
+			return PhaseState{y.vel, this->de_system.accel(t, y.pos, y.vel)};
+		}, y);
+	}
+}
+
+template <typename DE>
+bool BasicRK87<DE>::has_stm() const { return true; }
+
+} // namespace orbsim
@@ -0,0 +1,116 @@
+#ifndef VARIATIONAL_HPP
+#define VARIATIONAL_HPP
+
+#include "simulation/integrators/phase_state.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace orbsim {
+
+/**
+ * @brief Partial derivatives of the acceleration by the position and velocity
+ *
+ * Point-mass gravity has them in closed form. Every other system gets them
+ * from central differences, which cost 12 more evaluations of the
+ * acceleration that aren't counted in the right-hand side evaluations.
+ */
+struct AccelPartials {
+	Mat3 by_pos;
+	Mat3 by_vel;
+
+	// Derivative of a variation of the state, d/dt (dr, dv) = (dv, A_r dr + A_v dv)
+	constexpr PhaseState vary(const PhaseState &d) const noexcept {
+		return PhaseState{d.vel, this->by_pos * d.pos + this->by_vel * d.vel};
+	}
+};
+
+template <typename DE>
+AccelPartials accel_partials(const DE &de_system, double t, const Vec3 &pos, const Vec3 &vel) {
+	AccelPartials partials;
+	double h_pos = 1e-6 * std::max(1.0, pos.len());
+	double h_vel = 1e-6 * std::max(1.0, vel.len());
+	for (int j = 0; j < 3; j++) {
+		Vec3 e{j == 0 ? 1.0 : 0.0, j == 1 ? 1.0 : 0.0, j == 2 ? 1.0 : 0.0};
+		Vec3 d_pos = (de_system.accel(t, pos + h_pos * e, vel) - de_system.accel(t, pos - h_pos * e, vel)) / (2 * h_pos);
+		Vec3 d_vel = (de_system.accel(t, pos, vel + h_vel * e) - de_system.accel(t, pos, vel - h_vel * e)) / (2 * h_vel);
+		partials.by_pos(0, j) = d_pos.x;
+		partials.by_pos(1, j) = d_pos.y;
+		partials.by_pos(2, j) = d_pos.z;
+		partials.by_vel(0, j) = d_vel.x;
+		partials.by_vel(1, j) = d_vel.y;
+		partials.by_vel(2, j) = d_vel.z;
+	}
+	return partials;
+}
+
+// 3 r r^T / r^5 - I / r^3, the acceleration doesn't depend on the velocity
+inline AccelPartials accel_partials(const OrbitDE &, double, const Vec3 &pos, const Vec3 &) {
+	double r2 = pos.dot(pos);
+	double inv_r3 = 1 / (r2 * std::sqrt(r2));
+	double inv_r5 = inv_r3 / r2;
+	return AccelPartials{(3 * inv_r5) * outer(pos, pos) - inv_r3 * Mat3::identity(), Mat3{}};
+}
+
+/**
+ * @brief State with its state transition matrix, integrated as one vector
+ *
+ * The matrix is kept as its six columns, the variations of the state by
+ * each initial component, so it has the same layout and arithmetic as the
+ * state. Step size control only looks at the state.
+ */
+struct StmState {
+	PhaseState y;
+	PhaseState phi[6];
+
+	static StmState identity(const PhaseState &y) {
+		StmState s{y, {}};
+		s.phi[0].pos.x = s.phi[1].pos.y = s.phi[2].pos.z = 1;
+		s.phi[3].vel.x = s.phi[4].vel.y = s.phi[5].vel.z = 1;
+		return s;
+	}
+};
+
+inline StmState &operator+=(StmState &a, const StmState &b) noexcept {
+	a.y += b.y;
+	for (int k = 0; k < 6; k++) a.phi[k] += b.phi[k];
+	return a;
+}
+
+inline StmState &operator-=(StmState &a, const StmState &b) noexcept {
+	a.y -= b.y;
+	for (int k = 0; k < 6; k++) a.phi[k] -= b.phi[k];
+	return a;
+}
+
+inline StmState &operator*=(StmState &a, double scalar) noexcept {
+	a.y *= scalar;
+	for (int k = 0; k < 6; k++) a.phi[k] *= scalar;
+	return a;
+}
+
+inline StmState operator+(StmState a, const StmState &b) noexcept { return a += b; }
+inline StmState operator-(StmState a, const StmState &b) noexcept { return a -= b; }
+inline StmState operator*(double scalar, StmState a) noexcept { return a *= scalar; }
+
+inline double err_norm(const StmState &err, const StmState &y0, const StmState &y1,
+					   double rel_tol, double abs_tol) {
+	return err_norm(err.y, y0.y, y1.y, rel_tol, abs_tol);
+}
+
+// Right-hand side of the state and of the variational equations
+template <typename DE>
+StmState stm_rhs(const DE &de_system, double t, const StmState &s) {
+	AccelPartials partials = accel_partials(de_system, t, s.y.pos, s.y.vel);
+	StmState ds{PhaseState{s.y.vel, de_system.accel(t, s.y.pos, s.y.vel)}, {}};
+	for (int k = 0; k < 6; k++) ds.phi[k] = partials.vary(s.phi[k]);
+	return ds;
+}
+
+} // namespace orbsim
+
+
+#endif	// VARIATIONAL_HPP
@@ -3,6 +3,7 @@
 
 #include "simulation/integrators/integrator.hpp"
 #include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
 #include "simulation/math_obj.hpp"
 
 
@@ -11,18 +12,30 @@ namespace orbsim {
 /**
  * @brief Verlet integrator
  */
-class Verlet : public Integrator {
+template <typename DE>
+class BasicVerlet : public Integrator {
 
 public:
-	Verlet(DESystem<Vec3> de_system, double M, double R0, Vec3 x0, Vec3 v0,
-		   double t_i, double t_f, int steps);
+	BasicVerlet(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+				double t_i, double t_f, int steps);
 
-	Verlet *copy() const override;
+	BasicVerlet *copy() const override;
 
 	void integrate() override;
+
+private:
+	DE de_system;
 };
 
+using Verlet = BasicVerlet<OrbitDE>;
+
+extern template class BasicVerlet<OrbitDE>;
+extern template class BasicVerlet<DESystem<Vec3>>;
+extern template class BasicVerlet<ForceModelDE>;
+
 } // namespace orbsim
 
+#include "simulation/integrators/verlet.ipp"
+
 
 #endif	// VERLET_HPP
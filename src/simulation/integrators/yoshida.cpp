@@ -0,0 +1,58 @@
+#include "yoshida.hpp"
+#include "diff_eq.hpp"
+#include "forces/force_model.hpp"
+#include "math_obj.hpp"
+
+#include <cmath>
+#include <vector>
+
+
+namespace orbsim {
+
+namespace yoshida {
+
+namespace {
+
+// Builds the symmetric sequence w_n ... w_1 w_0 w_1 ... w_n with w_0 = 1 - 2 * sum(w_i)
+std::vector<double> symmetric(const std::vector<double> &w) {
+	double w0 = 1;
+	for (double wi : w) w0 -= 2 * wi;
+
+	std::vector<double> seq(w.rbegin(), w.rend());
+	seq.push_back(w0);
+	seq.insert(seq.end(), w.begin(), w.end());
+	return seq;
+}
+
+} // namespace
+
+// Verlet substep weights of one step
+const std::vector<double> &weights(int order) {
+	// Forest-Ruth
+	static const std::vector<double> w4 = symmetric({1 / (2 - std::cbrt(2.0))});
+	// Yoshida (1990), solution A
+	static const std::vector<double> w6 = symmetric({
+		-1.17767998417887, 0.235573213359357, 0.784513610477560
+	});
+	// Yoshida (1990), solution D
+	static const std::vector<double> w8 = symmetric({
+		0.102799849391985, -1.96061023297549, 1.93813913762276, -0.158240635368243,
+		-1.44485223686048, 0.253693336566229, 0.914844246229740
+	});
+
+	return order == 4 ? w4 : order == 6 ? w6 : w8;
+}
+
+} // namespace yoshida
+
+template class BasicYoshida<OrbitDE, 4>;
+template class BasicYoshida<OrbitDE, 6>;
+template class BasicYoshida<OrbitDE, 8>;
+template class BasicYoshida<DESystem<Vec3>, 4>;
+template class BasicYoshida<DESystem<Vec3>, 6>;
+template class BasicYoshida<DESystem<Vec3>, 8>;
+template class BasicYoshida<ForceModelDE, 4>;
+template class BasicYoshida<ForceModelDE, 6>;
+template class BasicYoshida<ForceModelDE, 8>;
+
+} // namespace orbsim
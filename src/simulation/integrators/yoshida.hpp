@@ -0,0 +1,55 @@
+#ifndef YOSHIDA_HPP
+#define YOSHIDA_HPP
+
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
+#include "simulation/math_obj.hpp"
+
+
+namespace orbsim {
+
+/**
+ * @brief Symplectic Yoshida integrator of 4th, 6th or 8th order
+ *
+ * Every step is a symmetric composition of Verlet (kick-drift-kick) substeps
+ * with the weights from Yoshida (1990). The 4th order one is the Forest-Ruth
+ * scheme. The energy error stays bounded, use get_energy_error() to check it.
+ */
+template <typename DE, int Order>
+class BasicYoshida : public Integrator {
+
+	static_assert(Order == 4 || Order == 6 || Order == 8, "Yoshida integrators are of order 4, 6 or 8");
+
+public:
+	BasicYoshida(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+				 double t_i, double t_f, int steps);
+
+	BasicYoshida *copy() const override;
+
+	void integrate() override;
+
+private:
+	DE de_system;
+};
+
+using Yoshida4 = BasicYoshida<OrbitDE, 4>;
+using Yoshida6 = BasicYoshida<OrbitDE, 6>;
+using Yoshida8 = BasicYoshida<OrbitDE, 8>;
+
+extern template class BasicYoshida<OrbitDE, 4>;
+extern template class BasicYoshida<OrbitDE, 6>;
+extern template class BasicYoshida<OrbitDE, 8>;
+extern template class BasicYoshida<DESystem<Vec3>, 4>;
+extern template class BasicYoshida<DESystem<Vec3>, 6>;
+extern template class BasicYoshida<DESystem<Vec3>, 8>;
+extern template class BasicYoshida<ForceModelDE, 4>;
+extern template class BasicYoshida<ForceModelDE, 6>;
+extern template class BasicYoshida<ForceModelDE, 8>;
+
+} // namespace orbsim
+
+#include "simulation/integrators/yoshida.ipp"
+
+
+#endif	// YOSHIDA_HPP
@@ -0,0 +1,66 @@
+#include "simulation/integrators/integrator.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/forces/force_model.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <type_traits>
+#include <vector>
+
+
+namespace orbsim {
+
+namespace yoshida {
+
+// Verlet substep weights of one step
+const std::vector<double> &weights(int order);
+
+} // namespace yoshida
+
+template <typename DE, int Order>
+BasicYoshida<DE, Order>::BasicYoshida(DE de_system, double M, double R0, Vec3 x0, Vec3 v0,
+									  double t_i, double t_f, int steps)
+	: Integrator(M, R0, x0, v0, t_i, t_f, steps), de_system(de_system) {
+
+	this->two_body = std::is_same_v<DE, OrbitDE>;
+}
+
+template <typename DE, int Order>
+BasicYoshida<DE, Order> *BasicYoshida<DE, Order>::copy() const { return new BasicYoshida(*this); }
+
+template <typename DE, int Order>
+void BasicYoshida<DE, Order>::integrate() {
+	const std::vector<double> &w = yoshida::weights(Order);
+
+	// Norm the initial conditions
+	this->begin_integration();
+	Vec3 pos = this->x0 / this->R_dim;
+	Vec3 vel = this->v0 / this->V_dim;
+	double dt = this->delta_t / this->T_dim;
+	double t0 = this->t_start / this->T_dim;
+	this->store(0, pos, vel);
+
+	// The closing kick of a substep and the opening kick of the next one use
+	// the same acceleration, so every substep costs one evaluation
+	Vec3 acc = this->de_system.accel(t0, pos, vel);
+
+	for (int i = 0; i < this->steps - 1; i++) {
+		double t = t0 + i * dt;
+
+		for (double wk : w) {
+			double h = wk * dt;
+			Vec3 vel_half = vel + acc * (h/2);
+			pos += vel_half * h;
+			t += h;
+			acc = this->de_system.accel(t, pos, vel_half);
+			vel = vel_half + acc * (h/2);
+		}
+
+		if (!this->store(i + 1, pos, vel)) break;
+	}
+
+	this->rhs_evals = 1 + (long long) w.size() * (this->sample_count - 1);
+
+	this->end_integration();
+}
+
+} // namespace orbsim
@@ -1,6 +1,8 @@
 #ifndef MATH_OBJ_HPP
 #define MATH_OBJ_HPP
 
+#include <array>
+#include <cmath>
 #include <string>
 
 
@@ -9,36 +11,196 @@ namespace orbsim {
 const double G = 6.67430e-11;
 const double PI = 3.14159265358979323846;
 
+/**
+ * @brief 3D vector
+ *
+ * Everything but the string conversion is defined here, so the arithmetic
+ * in the integrator loops is inlined without link time optimization.
+ */
 struct Vec3 {
 	double x;
 	double y;
 	double z;
 
-	Vec3 operator+(const Vec3 &rhs) const;
-	Vec3 operator-(const Vec3 &rhs) const;
-	Vec3 operator-() const;
-	Vec3 &operator*=(double scalar);
-	Vec3 operator/(double scalar) const;
-	Vec3 &operator/=(double scalar);
-	bool operator==(const Vec3 &other) const;
-	bool operator!=(const Vec3 &other) const;
-
-	double len() const;
-	Vec3 norm() const;
-	double dot(const Vec3 &other) const;
-	Vec3 cross(const Vec3 &other) const;
+	constexpr Vec3 operator+(const Vec3 &rhs) const noexcept { return Vec3{x + rhs.x, y + rhs.y, z + rhs.z}; }
+	constexpr Vec3 operator-(const Vec3 &rhs) const noexcept { return Vec3{x - rhs.x, y - rhs.y, z - rhs.z}; }
+	constexpr Vec3 operator-() const noexcept { return Vec3{- x, - y, - z}; }
+	constexpr Vec3 operator/(double scalar) const noexcept { return Vec3{x / scalar, y / scalar, z / scalar}; }
+
+	constexpr Vec3 &operator+=(const Vec3 &rhs) noexcept {
+		this->x += rhs.x;
+		this->y += rhs.y;
+		this->z += rhs.z;
+		return *this;
+	}
+
+	constexpr Vec3 &operator-=(const Vec3 &rhs) noexcept {
+		this->x -= rhs.x;
+		this->y -= rhs.y;
+		this->z -= rhs.z;
+		return *this;
+	}
+
+	constexpr Vec3 &operator*=(double scalar) noexcept {
+		this->x *= scalar;
+		this->y *= scalar;
+		this->z *= scalar;
+		return *this;
+	}
+
+	constexpr Vec3 &operator/=(double scalar) noexcept {
+		return *this *= 1/scalar;
+	}
+
+	// Componentwise within 1e-8
+	constexpr bool operator==(const Vec3 &other) const noexcept {
+		const double epsilon = 1e-8;
+		double dx = x - other.x, dy = y - other.y, dz = z - other.z;
+		return (dx < 0 ? -dx : dx) < epsilon &&
+			   (dy < 0 ? -dy : dy) < epsilon &&
+			   (dz < 0 ? -dz : dz) < epsilon;
+	}
+
+	constexpr bool operator!=(const Vec3 &other) const noexcept {
+		return !(*this == other);
+	}
+
+	// use that len = sqrt(dot product with itself)
+	double len() const noexcept { return std::sqrt(this->dot(*this)); }
+	Vec3 norm() const noexcept { return *this / this->len(); }
+
+	constexpr double dot(const Vec3 &other) const noexcept {
+		return x * other.x + y * other.y + z * other.z;
+	}
+
+	constexpr Vec3 cross(const Vec3 &other) const noexcept {
+		return Vec3{
+			y * other.z - z * other.y,
+			z * other.x - x * other.z,
+			x * other.y - y * other.x
+		};
+	}
+
 	std::string to_str() const;
 };
 
-Vec3 operator*(double scalar, const Vec3 &v);
-Vec3 operator*(const Vec3 &v, double scalar);
+constexpr Vec3 operator*(double scalar, const Vec3 &v) noexcept { return Vec3{scalar * v.x, scalar * v.y, scalar * v.z}; }
+constexpr Vec3 operator*(const Vec3 &v, double scalar) noexcept { return scalar * v; }
+
+// a * x + y in one pass, rounded like the expression
+constexpr Vec3 fmadd(double a, const Vec3 &x, const Vec3 &y) noexcept {
+	return Vec3{a * x.x + y.x, a * x.y + y.y, a * x.z + y.z};
+}
+
+/**
+ * @brief 3x3 matrix, row-major
+ */
+struct Mat3 {
+	double m[9];
+
+	static constexpr Mat3 identity() noexcept { return Mat3{{1, 0, 0, 0, 1, 0, 0, 0, 1}}; }
+
+	constexpr double operator()(int i, int j) const noexcept { return m[i * 3 + j]; }
+	constexpr double &operator()(int i, int j) noexcept { return m[i * 3 + j]; }
+
+	constexpr Vec3 row(int i) const noexcept { return Vec3{m[i * 3], m[i * 3 + 1], m[i * 3 + 2]}; }
+	constexpr Vec3 col(int j) const noexcept { return Vec3{m[j], m[3 + j], m[6 + j]}; }
+
+	constexpr Mat3 transpose() const noexcept {
+		return Mat3{{m[0], m[3], m[6], m[1], m[4], m[7], m[2], m[5], m[8]}};
+	}
+
+	constexpr Vec3 operator*(const Vec3 &v) const noexcept {
+		return Vec3{
+			m[0] * v.x + m[1] * v.y + m[2] * v.z,
+			m[3] * v.x + m[4] * v.y + m[5] * v.z,
+			m[6] * v.x + m[7] * v.y + m[8] * v.z
+		};
+	}
+
+	constexpr Mat3 operator*(const Mat3 &rhs) const noexcept {
+		Mat3 r{};
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				r.m[i * 3 + j] = m[i * 3] * rhs.m[j] + m[i * 3 + 1] * rhs.m[3 + j] + m[i * 3 + 2] * rhs.m[6 + j];
+			}
+		}
+		return r;
+	}
+
+	constexpr Mat3 &operator+=(const Mat3 &rhs) noexcept {
+		for (int k = 0; k < 9; k++) m[k] += rhs.m[k];
+		return *this;
+	}
+
+	constexpr Mat3 &operator-=(const Mat3 &rhs) noexcept {
+		for (int k = 0; k < 9; k++) m[k] -= rhs.m[k];
+		return *this;
+	}
+
+	constexpr Mat3 &operator*=(double scalar) noexcept {
+		for (int k = 0; k < 9; k++) m[k] *= scalar;
+		return *this;
+	}
+
+	constexpr Mat3 operator+(const Mat3 &rhs) const noexcept { return Mat3(*this) += rhs; }
+	constexpr Mat3 operator-(const Mat3 &rhs) const noexcept { return Mat3(*this) -= rhs; }
+};
+
+constexpr Mat3 operator*(double scalar, const Mat3 &a) noexcept { return Mat3(a) *= scalar; }
+
+// a b^T
+constexpr Mat3 outer(const Vec3 &a, const Vec3 &b) noexcept {
+	return Mat3{{a.x * b.x, a.x * b.y, a.x * b.z,
+				 a.y * b.x, a.y * b.y, a.y * b.z,
+				 a.z * b.x, a.z * b.y, a.z * b.z}};
+}
+
+// Active rotations about the axes, from the cosine and sine of the angle
+constexpr Mat3 rot_x(double c, double s) noexcept { return Mat3{{1, 0, 0, 0, c, -s, 0, s, c}}; }
+constexpr Mat3 rot_y(double c, double s) noexcept { return Mat3{{c, 0, s, 0, 1, 0, -s, 0, c}}; }
+constexpr Mat3 rot_z(double c, double s) noexcept { return Mat3{{c, -s, 0, s, c, 0, 0, 0, 1}}; }
+
+inline Mat3 rot_x(double angle) noexcept { return rot_x(std::cos(angle), std::sin(angle)); }
+inline Mat3 rot_y(double angle) noexcept { return rot_y(std::cos(angle), std::sin(angle)); }
+inline Mat3 rot_z(double angle) noexcept { return rot_z(std::cos(angle), std::sin(angle)); }
 
 struct CartElem {
 	// Cartesian state vectors
 	Vec3 pos;	// [km]
 	Vec3 vel;	// [km/s]
+
+	constexpr CartElem &operator+=(const CartElem &rhs) noexcept {
+		this->pos += rhs.pos;
+		this->vel += rhs.vel;
+		return *this;
+	}
+
+	constexpr CartElem &operator-=(const CartElem &rhs) noexcept {
+		this->pos -= rhs.pos;
+		this->vel -= rhs.vel;
+		return *this;
+	}
+
+	constexpr CartElem &operator*=(double scalar) noexcept {
+		this->pos *= scalar;
+		this->vel *= scalar;
+		return *this;
+	}
 };
 
+// The state as a 6-vector
+constexpr CartElem operator+(const CartElem &a, const CartElem &b) noexcept { return CartElem{a.pos + b.pos, a.vel + b.vel}; }
+constexpr CartElem operator-(const CartElem &a, const CartElem &b) noexcept { return CartElem{a.pos - b.pos, a.vel - b.vel}; }
+constexpr CartElem operator*(double s, const CartElem &a) noexcept { return CartElem{s * a.pos, s * a.vel}; }
+
+constexpr CartElem fmadd(double a, const CartElem &x, const CartElem &y) noexcept {
+	return CartElem{fmadd(a, x.pos, y.pos), fmadd(a, x.vel, y.vel)};
+}
+
+// 6x6 matrix acting on a state (pos, vel), row-major
+using Mat6 = std::array<double, 36>;
+
 struct KeplElem {
 	// Keplerian orbital elements
 	double ecc;			// [1]
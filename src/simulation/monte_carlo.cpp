@@ -0,0 +1,238 @@
+#include "monte_carlo.hpp"
+
+#include "math_obj.hpp"
+#include "satellite.hpp"
+#include "thread_pool.hpp"
+#include "trajectory_sink.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+namespace orbsim {
+
+namespace {
+
+// Samples accumulated together, the statistics are merged in this order
+const std::size_t chunk_samples = 32;
+
+// Philox4x32-10 (Salmon et al., Parallel Random Numbers: As Easy as 1, 2, 3)
+std::array<std::uint32_t, 4> philox(std::array<std::uint32_t, 4> ctr, std::array<std::uint32_t, 2> key) {
+	for (int round = 0; round < 10; round++) {
+		if (round > 0) {
+			key[0] += 0x9E3779B9;
+			key[1] += 0xBB67AE85;
+		}
+		std::uint64_t p0 = (std::uint64_t) 0xD2511F53 * ctr[0];
+		std::uint64_t p1 = (std::uint64_t) 0xCD9E8D57 * ctr[2];
+		ctr = {(std::uint32_t) (p1 >> 32) ^ ctr[1] ^ key[0], (std::uint32_t) p1,
+			   (std::uint32_t) (p0 >> 32) ^ ctr[3] ^ key[1], (std::uint32_t) p0};
+	}
+	return ctr;
+}
+
+// Uniform in (0, 1) from 53 of the bits
+double uniform(std::uint32_t hi, std::uint32_t lo) {
+	std::uint64_t bits = ((std::uint64_t) hi << 32 | lo) >> 11;
+	return (bits + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// Index of (i, j), i <= j, in the upper triangle of a 6x6 matrix by rows
+int upper(int i, int j) {
+	return i * 6 - i * (i - 1) / 2 + (j - i);
+}
+
+// Mean and sums of squared deviations of a chunk of samples at every epoch
+class MomentSink : public TrajectorySink {
+
+public:
+	void reset() {
+		this->count = 0;
+	}
+
+	void begin(int steps) override {
+		this->time_arr.resize(steps);
+		this->mean.resize(steps);
+		this->m2.resize(steps);
+		if (this->count == 0) {
+			std::fill(this->mean.begin(), this->mean.end(), std::array<double, 6>{});
+			std::fill(this->m2.begin(), this->m2.end(), std::array<double, 21>{});
+		}
+	}
+
+	void consume(const TrajectoryBlock &block) override {
+		double n = this->count + 1;
+		for (int k = 0; k < block.count; k++) {
+			int epoch = block.first + k;
+			const Vec3 &p = block.pos_arr[k], &v = block.vel_arr[k];
+			double x[6] = {p.x, p.y, p.z, v.x, v.y, v.z};
+			this->time_arr[epoch] = block.time_arr[k];
+
+			// Welford's update
+			std::array<double, 6> &mean = this->mean[epoch];
+			std::array<double, 21> &m2 = this->m2[epoch];
+			double delta[6];
+			for (int i = 0; i < 6; i++) {
+				delta[i] = x[i] - mean[i];
+				mean[i] += delta[i] / n;
+			}
+			for (int i = 0; i < 6; i++) {
+				for (int j = i; j < 6; j++) m2[upper(i, j)] += delta[i] * (x[j] - mean[j]);
+			}
+		}
+	}
+
+	void end(int) override {
+		this->count++;
+	}
+
+	double count = 0;
+	std::vector<double> time_arr;
+	std::vector<std::array<double, 6>> mean;
+	std::vector<std::array<double, 21>> m2;
+};
+
+// Adds the statistics of a chunk to the total (Chan et al.)
+void merge(MomentSink &total, const MomentSink &chunk) {
+	if (chunk.count == 0) return;
+	if (total.count == 0) {
+		total = chunk;
+		return;
+	}
+
+	double n_a = total.count, n_b = chunk.count, n = n_a + n_b;
+	for (std::size_t epoch = 0; epoch < total.mean.size(); epoch++) {
+		std::array<double, 6> &mean = total.mean[epoch];
+		std::array<double, 21> &m2 = total.m2[epoch];
+		double delta[6];
+		for (int i = 0; i < 6; i++) {
+			delta[i] = chunk.mean[epoch][i] - mean[i];
+			mean[i] += delta[i] * n_b / n;
+		}
+		for (int i = 0; i < 6; i++) {
+			for (int j = i; j < 6; j++) {
+				m2[upper(i, j)] += chunk.m2[epoch][upper(i, j)] + delta[i] * delta[j] * n_a * n_b / n;
+			}
+		}
+	}
+	total.count = n;
+}
+
+} // namespace
+
+MonteCarlo::MonteCarlo(const Satellite &nominal, const StateCov &covariance,
+					   std::uint64_t seed, unsigned threads)
+	: nominal(nominal), covariance(covariance), chol{}, seed(seed), pool(threads) {
+
+	// Cholesky factor, a zero variance leaves its column out
+	double scale = 0;
+	for (int i = 0; i < 6; i++) scale = std::max(scale, std::fabs(covariance[i * 6 + i]));
+	for (int i = 0; i < 6; i++) {
+		for (int j = 0; j < i; j++) {
+			if (std::fabs(covariance[i * 6 + j] - covariance[j * 6 + i]) > 1e-12 * scale) {
+				throw std::domain_error("Covariance must be symmetric!");
+			}
+		}
+	}
+	for (int j = 0; j < 6; j++) {
+		double d = covariance[j * 6 + j];
+		for (int k = 0; k < j; k++) d -= this->chol[j * 6 + k] * this->chol[j * 6 + k];
+		if (d < -1e-12 * scale) {
+			throw std::domain_error("Covariance must be positive semidefinite!");
+		}
+		double l_jj = d > 1e-12 * scale ? std::sqrt(d) : 0;
+		this->chol[j * 6 + j] = l_jj;
+		for (int i = j + 1; i < 6; i++) {
+			double s = covariance[i * 6 + j];
+			for (int k = 0; k < j; k++) s -= this->chol[i * 6 + k] * this->chol[j * 6 + k];
+			this->chol[i * 6 + j] = l_jj > 0 ? s / l_jj : 0;
+		}
+	}
+
+	// The samples are streamed, they need none of these
+	this->nominal.set_events(nullptr);
+	this->nominal.set_cache(nullptr);
+	this->nominal.set_arena(nullptr);
+	this->nominal.set_stm(false);
+}
+
+std::uint64_t MonteCarlo::get_seed() const { return this->seed; }
+unsigned MonteCarlo::get_threads() const { return this->pool.get_threads(); }
+const StateCov &MonteCarlo::get_covariance() const { return this->covariance; }
+
+CartElem MonteCarlo::sample(std::size_t idx) const {
+	// Six normal deviates from three blocks of the stream (Box-Muller)
+	std::array<std::uint32_t, 2> key{(std::uint32_t) this->seed, (std::uint32_t) (this->seed >> 32)};
+	std::uint64_t counter = idx;
+	double z[6];
+	for (std::uint32_t block = 0; block < 3; block++) {
+		std::array<std::uint32_t, 4> bits = philox(
+			{(std::uint32_t) counter, (std::uint32_t) (counter >> 32), block, 0}, key);
+		double r = std::sqrt(-2 * std::log(uniform(bits[0], bits[1])));
+		double phi = 2 * PI * uniform(bits[2], bits[3]);
+		z[2 * block] = r * std::cos(phi);
+		z[2 * block + 1] = r * std::sin(phi);
+	}
+
+	double dx[6] = {};
+	for (int i = 0; i < 6; i++) {
+		for (int k = 0; k <= i; k++) dx[i] += this->chol[i * 6 + k] * z[k];
+	}
+	CartElem cart_elem = this->nominal.get_cart_elem();
+	return CartElem{
+		cart_elem.pos + Vec3{dx[0], dx[1], dx[2]},
+		cart_elem.vel + Vec3{dx[3], dx[4], dx[5]}
+	};
+}
+
+std::vector<Dispersion> MonteCarlo::run(std::size_t samples) {
+	if (samples == 0) {
+		throw std::domain_error("Samples must be a positive integer!");
+	}
+
+	// A satellite and an accumulator for every chunk that runs at the same time
+	std::size_t chunks = (samples + chunk_samples - 1) / chunk_samples;
+	std::size_t parallel = std::min<std::size_t>(this->pool.get_threads(), chunks);
+	std::vector<Satellite> sats(parallel, this->nominal);
+	std::vector<MomentSink> sinks(parallel);
+	MomentSink total;
+
+	for (std::size_t first_chunk = 0; first_chunk < chunks; first_chunk += parallel) {
+		std::size_t round = std::min(parallel, chunks - first_chunk);
+		this->pool.parallel_for(round, [&](std::size_t k) {
+			std::size_t begin = (first_chunk + k) * chunk_samples;
+			std::size_t end = std::min(samples, begin + chunk_samples);
+			sinks[k].reset();
+			for (std::size_t idx = begin; idx < end; idx++) {
+				sats[k].set_cart_elem(sample(idx));
+				sats[k].propagate(sinks[k]);
+			}
+		});
+		for (std::size_t k = 0; k < round; k++) merge(total, sinks[k]);
+	}
+
+	std::vector<Dispersion> dispersions(total.mean.size());
+	double n = total.count;
+	for (std::size_t epoch = 0; epoch < dispersions.size(); epoch++) {
+		const std::array<double, 6> &mean = total.mean[epoch];
+		const std::array<double, 21> &m2 = total.m2[epoch];
+		Dispersion &d = dispersions[epoch];
+		d.t = total.time_arr[epoch];
+		d.mean = CartElem{Vec3{mean[0], mean[1], mean[2]}, Vec3{mean[3], mean[4], mean[5]}};
+		for (int i = 0; i < 6; i++) {
+			for (int j = i; j < 6; j++) {
+				double c = n > 1 ? m2[upper(i, j)] / (n - 1) : 0;
+				d.cov[i * 6 + j] = c;
+				d.cov[j * 6 + i] = c;
+			}
+		}
+	}
+	return dispersions;
+}
+
+} // namespace orbsim
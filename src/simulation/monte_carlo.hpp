@@ -0,0 +1,62 @@
+#ifndef MONTE_CARLO_HPP
+#define MONTE_CARLO_HPP
+
+#include "simulation/math_obj.hpp"
+#include "simulation/satellite.hpp"
+#include "simulation/thread_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace orbsim {
+
+// Covariance of a state (pos, vel) in [km^2], [km^2/s] and [km^2/s^2]
+using StateCov = Mat6;
+
+struct Dispersion {
+	double t;	// [s]
+	CartElem mean;
+	StateCov cov;
+};
+
+/**
+ * @brief Propagates random dispersions of the initial state of a satellite
+ *
+ * The samples are the initial state plus normal deviates with the given
+ * covariance. Every sample has its own stream of a counter-based generator
+ * (Philox4x32-10), keyed by the seed and counting from the sample index, so
+ * a sample is the same no matter how many there are or which thread draws
+ * it.
+ *
+ * The samples are streamed through a sink into the mean and covariance at
+ * every epoch (Welford's update, merged with Chan's formula), no trajectory
+ * is kept. Fixed chunks of samples are accumulated on the threads of a pool
+ * and merged in order, so the statistics don't depend on the threads either.
+ */
+class MonteCarlo {
+
+public:
+	MonteCarlo(const Satellite &nominal, const StateCov &covariance,
+			   std::uint64_t seed = 0, unsigned threads = 0);
+
+	std::uint64_t get_seed() const;
+	unsigned get_threads() const;
+	const StateCov &get_covariance() const;
+
+	CartElem sample(std::size_t idx) const;
+	std::vector<Dispersion> run(std::size_t samples);
+
+private:
+	Satellite nominal;
+	StateCov covariance;
+	Mat6 chol;	// lower triangular factor of the covariance
+	std::uint64_t seed;
+	ThreadPool pool;
+};
+
+} // namespace orbsim
+
+
+#endif	// MONTE_CARLO_HPP
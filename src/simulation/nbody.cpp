@@ -0,0 +1,321 @@
+#include "nbody.hpp"
+
+#include "celestial_obj.hpp"
+#include "math_obj.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+
+namespace orbsim {
+
+namespace {
+
+const double G_km = G / 1e9;	// [km^3/(kg s^2)]
+
+// Cells with this many bodies or fewer are summed directly
+const int leaf_size = 8;
+const int max_depth = 32;
+
+// Bodies per task of the thread pool
+const std::size_t block_size = 128;
+
+} // namespace
+
+NBody::NBody(double t_start, double t_end, int t_steps, double theta, unsigned threads)
+	: t_start(t_start), t_end(t_end), t_steps(t_steps), theta(0), direct(false),
+	  softening(0), pool(threads) {
+
+	if (t_start < 0) {
+		throw std::domain_error("Start time must be a positive integer!");
+	}
+	if (t_start >= t_end) {
+		throw std::domain_error("Start time must be smaller than end time!");
+	}
+	if (t_steps <= 0) {
+		throw std::domain_error("Steps must be a positive integer!");
+	}
+	set_theta(theta);
+}
+
+std::size_t NBody::size() const { return this->x0.size(); }
+double NBody::get_t_start() const { return this->t_start; }
+double NBody::get_t_end() const { return this->t_end; }
+int NBody::get_t_steps() const { return this->t_steps; }
+double NBody::get_theta() const { return this->theta; }
+bool NBody::get_direct() const { return this->direct; }
+double NBody::get_softening() const { return this->softening; }
+unsigned NBody::get_threads() const { return this->pool.get_threads(); }
+
+void NBody::set_theta(double theta) {
+	if (theta < 0) {
+		throw std::domain_error("Opening angle must be a positive number!");
+	}
+	this->theta = theta;
+}
+
+void NBody::set_direct(bool direct) { this->direct = direct; }
+
+void NBody::set_softening(double softening) {
+	if (softening < 0) {
+		throw std::domain_error("Softening must be a positive number!");
+	}
+	this->softening = softening;
+}
+
+void NBody::add_body(CelestialObj body, CartElem cart_elem) {
+	this->x0.push_back(cart_elem.pos.x);
+	this->y0.push_back(cart_elem.pos.y);
+	this->z0.push_back(cart_elem.pos.z);
+	this->vx0.push_back(cart_elem.vel.x);
+	this->vy0.push_back(cart_elem.vel.y);
+	this->vz0.push_back(cart_elem.vel.z);
+
+	this->mass.push_back(body.mass);
+	this->x.push_back(cart_elem.pos.x);
+	this->y.push_back(cart_elem.pos.y);
+	this->z.push_back(cart_elem.pos.z);
+	this->vx.push_back(cart_elem.vel.x);
+	this->vy.push_back(cart_elem.vel.y);
+	this->vz.push_back(cart_elem.vel.z);
+	this->ax.push_back(0);
+	this->ay.push_back(0);
+	this->az.push_back(0);
+}
+
+double NBody::get_mass(std::size_t idx) const { return this->mass[idx]; }
+
+CartElem NBody::get_cart_elem(std::size_t idx) const {
+	return CartElem{
+		Vec3{this->x[idx], this->y[idx], this->z[idx]},
+		Vec3{this->vx[idx], this->vy[idx], this->vz[idx]}
+	};
+}
+
+Vec3 NBody::get_accel(std::size_t idx) const {
+	return Vec3{this->ax[idx], this->ay[idx], this->az[idx]};
+}
+
+void NBody::compute_accel() {
+	std::size_t n = size();
+	if (n == 0) return;
+	if (!this->direct) build_tree();
+
+	// The tree is only read from here on, every task writes its own bodies
+	std::size_t blocks = (n + block_size - 1) / block_size;
+	this->pool.parallel_for(blocks, [&](std::size_t block) {
+		std::size_t end = std::min(n, (block + 1) * block_size);
+		for (std::size_t i = block * block_size; i < end; i++) {
+			if (this->direct) {
+				accel_direct(i);
+			} else {
+				accel_tree(i);
+			}
+		}
+	});
+}
+
+double NBody::energy() const {
+	double eps2 = this->softening * this->softening;
+	double kinetic = 0, potential = 0;
+	for (std::size_t i = 0; i < size(); i++) {
+		kinetic += 0.5 * this->mass[i] * (this->vx[i]*this->vx[i] + this->vy[i]*this->vy[i] + this->vz[i]*this->vz[i]);
+		for (std::size_t j = i + 1; j < size(); j++) {
+			double dx = this->x[j] - this->x[i];
+			double dy = this->y[j] - this->y[i];
+			double dz = this->z[j] - this->z[i];
+			potential -= G_km * this->mass[i] * this->mass[j] / std::sqrt(dx*dx + dy*dy + dz*dz + eps2);
+		}
+	}
+	return kinetic + potential;	// [kg km^2/s^2]
+}
+
+void NBody::propagate(std::function<void(int step, const NBody &)> on_step) {
+	// Start over from the initial states
+	this->x = this->x0;
+	this->y = this->y0;
+	this->z = this->z0;
+	this->vx = this->vx0;
+	this->vy = this->vy0;
+	this->vz = this->vz0;
+
+	double dt = (this->t_end - this->t_start) / (this->t_steps - 1);
+	std::size_t n = size();
+
+	compute_accel();
+	if (on_step) on_step(0, *this);
+	for (int step = 1; step < this->t_steps; step++) {
+		// Kick - drift - kick, the tree is built for the new positions in between
+		for (std::size_t i = 0; i < n; i++) {
+			this->vx[i] += this->ax[i] * (dt/2);
+			this->vy[i] += this->ay[i] * (dt/2);
+			this->vz[i] += this->az[i] * (dt/2);
+			this->x[i] += this->vx[i] * dt;
+			this->y[i] += this->vy[i] * dt;
+			this->z[i] += this->vz[i] * dt;
+		}
+		compute_accel();
+		for (std::size_t i = 0; i < n; i++) {
+			this->vx[i] += this->ax[i] * (dt/2);
+			this->vy[i] += this->ay[i] * (dt/2);
+			this->vz[i] += this->az[i] * (dt/2);
+		}
+		if (on_step) on_step(step, *this);
+	}
+}
+
+void NBody::build_tree() {
+	std::size_t n = size();
+	this->order.resize(n);
+	this->scratch.resize(n);
+	for (std::size_t i = 0; i < n; i++) this->order[i] = (int) i;
+
+	// Cube around all the bodies
+	auto [x_min, x_max] = std::minmax_element(this->x.begin(), this->x.end());
+	auto [y_min, y_max] = std::minmax_element(this->y.begin(), this->y.end());
+	auto [z_min, z_max] = std::minmax_element(this->z.begin(), this->z.end());
+	double half = 0.5 * std::max({*x_max - *x_min, *y_max - *y_min, *z_max - *z_min});
+	half = half * (1 + 1e-12) + 1e-12;
+
+	this->nodes.clear();
+	this->nodes.push_back(Node{});
+	build_node(0, 0, (int) n, 0.5 * (*x_min + *x_max), 0.5 * (*y_min + *y_max),
+			   0.5 * (*z_min + *z_max), half, 0);
+}
+
+void NBody::build_node(int node, int begin, int end, double cx, double cy, double cz,
+					   double half, int depth) {
+	// Center of mass of the cell
+	double m = 0, mx = 0, my = 0, mz = 0;
+	for (int k = begin; k < end; k++) {
+		int i = this->order[k];
+		m += this->mass[i];
+		mx += this->mass[i] * this->x[i];
+		my += this->mass[i] * this->y[i];
+		mz += this->mass[i] * this->z[i];
+	}
+	Node cell{mx / m, my / m, mz / m, m, 2 * half, 0, 0, begin, end};
+	if (m == 0) {
+		cell.x = cx;
+		cell.y = cy;
+		cell.z = cz;
+	}
+	if (end - begin <= leaf_size || depth >= max_depth) {
+		this->nodes[node] = cell;
+		return;
+	}
+
+	// Sort the bodies of the cell by octant
+	auto octant = [&](int i) {
+		return (this->x[i] >= cx) | ((this->y[i] >= cy) << 1) | ((this->z[i] >= cz) << 2);
+	};
+	int counts[8] = {};
+	for (int k = begin; k < end; k++) counts[octant(this->order[k])]++;
+	int starts[9];
+	starts[0] = begin;
+	for (int o = 0; o < 8; o++) starts[o + 1] = starts[o] + counts[o];
+	int next[8];
+	std::copy(starts, starts + 8, next);
+	for (int k = begin; k < end; k++) {
+		int i = this->order[k];
+		this->scratch[next[octant(i)]++] = i;
+	}
+	std::copy(this->scratch.begin() + begin, this->scratch.begin() + end, this->order.begin() + begin);
+
+	// Children of the non-empty octants, next to each other
+	cell.child = (int) this->nodes.size();
+	for (int o = 0; o < 8; o++) {
+		if (counts[o] > 0) cell.child_count++;
+	}
+	this->nodes[node] = cell;
+	this->nodes.resize(this->nodes.size() + cell.child_count);
+
+	int child = cell.child;
+	double quarter = 0.5 * half;
+	for (int o = 0; o < 8; o++) {
+		if (counts[o] == 0) continue;
+		build_node(child++, starts[o], starts[o + 1],
+				   cx + (o & 1 ? quarter : -quarter),
+				   cy + (o & 2 ? quarter : -quarter),
+				   cz + (o & 4 ? quarter : -quarter),
+				   quarter, depth + 1);
+	}
+}
+
+void NBody::accel_tree(std::size_t i) {
+	double xi = this->x[i], yi = this->y[i], zi = this->z[i];
+	double eps2 = this->softening * this->softening;
+	double theta2 = this->theta * this->theta;
+	double sum_x = 0, sum_y = 0, sum_z = 0;
+
+	// Depth first, at most 7 siblings wait on each level
+	int stack[8 * max_depth + 8];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0) {
+		const Node &cell = this->nodes[stack[--top]];
+		double dx = cell.x - xi;
+		double dy = cell.y - yi;
+		double dz = cell.z - zi;
+		double d2 = dx*dx + dy*dy + dz*dz;
+
+		if (cell.child_count > 0 && cell.size * cell.size < theta2 * d2) {
+			// Far enough away to be a single mass
+			double inv = 1 / std::sqrt(d2 + eps2);
+			double f = G_km * cell.mass * inv * inv * inv;
+			sum_x += f * dx;
+			sum_y += f * dy;
+			sum_z += f * dz;
+		} else if (cell.child_count > 0) {
+			for (int c = 0; c < cell.child_count; c++) stack[top++] = cell.child + c;
+		} else {
+			for (int k = cell.begin; k < cell.end; k++) {
+				int j = this->order[k];
+				if (j == (int) i) continue;
+				double bx = this->x[j] - xi;
+				double by = this->y[j] - yi;
+				double bz = this->z[j] - zi;
+				double inv = 1 / std::sqrt(bx*bx + by*by + bz*bz + eps2);
+				double f = G_km * this->mass[j] * inv * inv * inv;
+				sum_x += f * bx;
+				sum_y += f * by;
+				sum_z += f * bz;
+			}
+		}
+	}
+
+	this->ax[i] = sum_x;
+	this->ay[i] = sum_y;
+	this->az[i] = sum_z;
+}
+
+void NBody::accel_direct(std::size_t i) {
+	const double *x = this->x.data(), *y = this->y.data(), *z = this->z.data();
+	const double *mass = this->mass.data();
+	double xi = x[i], yi = y[i], zi = z[i];
+	double eps2 = this->softening * this->softening;
+	double sum_x = 0, sum_y = 0, sum_z = 0;
+
+	for (std::size_t j = 0; j < size(); j++) {
+		if (j == i) continue;
+		double dx = x[j] - xi;
+		double dy = y[j] - yi;
+		double dz = z[j] - zi;
+		double inv = 1 / std::sqrt(dx*dx + dy*dy + dz*dz + eps2);
+		double f = G_km * mass[j] * inv * inv * inv;
+		sum_x += f * dx;
+		sum_y += f * dy;
+		sum_z += f * dz;
+	}
+
+	this->ax[i] = sum_x;
+	this->ay[i] = sum_y;
+	this->az[i] = sum_z;
+}
+
+} // namespace orbsim
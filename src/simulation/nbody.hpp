@@ -0,0 +1,100 @@
+#ifndef NBODY_HPP
+#define NBODY_HPP
+
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/thread_pool.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+
+namespace orbsim {
+
+/**
+ * @brief Bodies that all attract each other, in [km] and [km/s]
+ *
+ * The gravity of the whole system comes from a Barnes-Hut octree that is
+ * built again every step. A cell whose size seen from a body is below the
+ * opening angle theta acts as a point mass at its center of mass, so an
+ * evaluation is O(N log N). With theta = 0 or in direct mode every pair is
+ * summed, which is exact and O(N^2). The bodies are split between the
+ * threads of a pool for the traversal.
+ *
+ * The steps are leapfrog (kick - drift - kick), which keeps the energy of
+ * the system bounded.
+ */
+class NBody {
+
+public:
+	NBody(double t_start = 0, double t_end = 86400, int t_steps = 8640,
+		  double theta = 0.5, unsigned threads = 0);
+
+	std::size_t size() const;
+	double get_t_start() const;
+	double get_t_end() const;
+	int get_t_steps() const;
+	double get_theta() const;
+	bool get_direct() const;
+	double get_softening() const;
+	unsigned get_threads() const;
+
+	void set_theta(double theta);
+	void set_direct(bool direct);
+	void set_softening(double softening);
+
+	void add_body(CelestialObj body, CartElem cart_elem);
+
+	double get_mass(std::size_t idx) const;
+	CartElem get_cart_elem(std::size_t idx) const;
+	Vec3 get_accel(std::size_t idx) const;
+
+	void compute_accel();
+	double energy() const;
+	void propagate(std::function<void(int step, const NBody &)> on_step = nullptr);
+
+private:
+	struct Node {
+		double x, y, z;	// center of mass
+		double mass;
+		double size;	// edge of the cell
+		int child;	// first of the children, which are next to each other
+		int child_count;	// none for a leaf
+		int begin, end;	// bodies in the cell, in order
+	};
+
+	void build_tree();
+	void build_node(int node, int begin, int end, double cx, double cy, double cz,
+					double half, int depth);
+	void accel_tree(std::size_t i);
+	void accel_direct(std::size_t i);
+
+	double t_start;
+	double t_end;
+	int t_steps;
+	double theta;
+	bool direct;
+	double softening;	// [km]
+
+	// Initial states [km], [km/s]
+	std::vector<double> x0, y0, z0;
+	std::vector<double> vx0, vy0, vz0;
+
+	// Current states and their accelerations [km/s^2]
+	std::vector<double> mass;	// [kg]
+	std::vector<double> x, y, z;
+	std::vector<double> vx, vy, vz;
+	std::vector<double> ax, ay, az;
+
+	std::vector<Node> nodes;
+	std::vector<int> order;	// of the bodies, grouped by cell
+	std::vector<int> scratch;
+
+	ThreadPool pool;
+};
+
+} // namespace orbsim
+
+
+#endif	// NBODY_HPP
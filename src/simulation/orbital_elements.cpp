@@ -0,0 +1,232 @@
+#include "orbital_elements.hpp"
+
+#include "celestial_obj.hpp"
+#include "math_obj.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+
+namespace orbsim {
+
+namespace {
+
+// Elements per task of the thread pool
+const std::size_t block_size = 4096;
+
+// Keplerian orbital elements -> Cartesian state vectors
+// Steps are described here: https://downloads.rene-schwarz.com/download/M001-Keplerian_Orbit_Elements_to_Cartesian_State_Vectors.pdf
+inline void kepl_to_cart_kernel(const KeplElem &k, double mu, Vec3 &pos, Vec3 &vel) {
+	double e = k.ecc;
+	double a = k.sem_maj_ax * 1000;	// Convert to meters
+
+	// Ecc. anomaly and distance from the true anomaly, without solving for them
+	double cos_ni = std::cos(k.true_anom);
+	double sin_ni = std::sin(k.true_anom);
+	double q = std::sqrt(1 - e*e);
+	double inv_d = 1 / (1 + e * cos_ni);
+	double cos_E = (e + cos_ni) * inv_d;
+	double sin_E = q * sin_ni * inv_d;
+	double r = a * (1 - e * cos_E);
+
+	// Pos and vel vectors in the orbital frame
+	double f = std::sqrt(mu * a) / r;
+	Vec3 orb_pos{r * cos_ni, r * sin_ni, 0};
+	Vec3 orb_vel{- f * sin_E, f * q * cos_E, 0};
+
+	// Transform to the inertial frame, every sine and cosine only once
+	Mat3 rot = rot_z(std::cos(k.ri_asc_node), std::sin(k.ri_asc_node))
+			 * rot_x(std::cos(k.inc), std::sin(k.inc))
+			 * rot_z(std::cos(k.arg_of_per), std::sin(k.arg_of_per));
+
+	// Convert back to kilometers
+	pos = rot * orb_pos / 1000;
+	vel = rot * orb_vel / 1000;
+}
+
+// Cartesian state vectors -> Keplerian orbital elements
+// Steps are described here: https://downloads.rene-schwarz.com/download/M002-Cartesian_State_Vectors_to_Keplerian_Orbit_Elements.pdf
+inline void cart_to_kepl_kernel(const Vec3 &pos, const Vec3 &vel, double mu, KeplElem &k) {
+	// Convert to meters
+	Vec3 r_vec = pos * 1000;
+	Vec3 v_vec = vel * 1000;
+	double r = r_vec.len();
+	double v2 = v_vec.dot(v_vec);
+
+	// Orbital momentum vector
+	Vec3 h_vec = r_vec.cross(v_vec);
+	double h = h_vec.len();
+
+	// Ecc. vector
+	Vec3 e_vec = v_vec.cross(h_vec) / mu - r_vec / r;
+	double e = e_vec.len();
+
+	// Vector pointing towards the asc. node
+	double nx = -h_vec.y, ny = h_vec.x;
+	double n = std::sqrt(nx*nx + ny*ny);
+
+	// The quadrants are selects, not branches
+	double ni = std::acos(std::clamp(e_vec.dot(r_vec) / (e * r), -1.0, 1.0));
+	double OM = std::acos(std::clamp(nx / n, -1.0, 1.0));
+	double w = std::acos(std::clamp((nx*e_vec.x + ny*e_vec.y) / (n * e), -1.0, 1.0));
+
+	k.ecc = e;
+	k.sem_maj_ax = 1 / (2/r - v2/mu) / 1000;	// Convert back to kilometers
+	k.inc = std::acos(h_vec.z / h);
+	k.ri_asc_node = ny >= 0 ? OM : 2*PI - OM;
+	k.arg_of_per = e_vec.z >= 0 ? w : 2*PI - w;
+	k.true_anom = r_vec.dot(v_vec) >= 0 ? ni : 2*PI - ni;
+}
+
+// Halley iterations after the starter, enough for 0 <= e < 1
+const int kepler_iterations = 2;
+
+// Solution of E - e sin(E) = M (Mikkola, A cubic approximation for Kepler's equation, 1987)
+inline double kepler_kernel(double M, double e) {
+	// Reduced to -pi ... pi, added back at the end
+	double k = std::round(M / (2*PI));
+	double m = M - 2*PI * k;
+
+	double alpha = (1 - e) / (4*e + 0.5);
+	double beta = m / (2 * (4*e + 0.5));
+	double z = std::cbrt(beta + std::copysign(std::sqrt(beta*beta + alpha*alpha*alpha), beta));
+	double s = z - alpha / z;
+	s -= 0.078 * s*s*s*s*s / (1 + e);
+	double E = m + e * (3*s - 4*s*s*s);
+
+	for (int i = 0; i < kepler_iterations; i++) {
+		double sin_E = std::sin(E);
+		double cos_E = std::cos(E);
+		double f = E - e * sin_E - m;
+		double df = 1 - e * cos_E;
+		E -= 2 * f * df / (2 * df*df - f * e * sin_E);
+	}
+	return E + 2*PI * k;
+}
+
+inline double true_from_ecc_kernel(double E, double e) {
+	// Same revolution as the eccentric anomaly
+	double k = std::round(E / (2*PI));
+	double E0 = E - 2*PI * k;
+	return 2 * std::atan2(std::sqrt(1 + e) * std::sin(E0 / 2), std::sqrt(1 - e) * std::cos(E0 / 2)) + 2*PI * k;
+}
+
+// Runs block(begin, end) over the whole range, on the pool if there is one
+template <typename Block>
+void for_blocks(std::size_t count, ThreadPool *pool, Block block) {
+	if (pool == nullptr || count <= block_size) {
+		block(0, count);
+		return;
+	}
+	std::size_t blocks = (count + block_size - 1) / block_size;
+	pool->parallel_for(blocks, [&](std::size_t idx) {
+		block(idx * block_size, std::min(count, (idx + 1) * block_size));
+	});
+}
+
+} // namespace
+
+CartElem kepl_to_cart(const KeplElem &kepl_elem, CelestialObj cel_obj) {
+	CartElem cart_elem;
+	kepl_to_cart_kernel(kepl_elem, G * cel_obj.mass, cart_elem.pos, cart_elem.vel);
+	return cart_elem;
+}
+
+KeplElem cart_to_kepl(const CartElem &cart_elem, CelestialObj cel_obj) {
+	KeplElem kepl_elem;
+	cart_to_kepl_kernel(cart_elem.pos, cart_elem.vel, G * cel_obj.mass, kepl_elem);
+	return kepl_elem;
+}
+
+void kepl_to_cart(const KeplElem *kepl_elems, CartElem *cart_elems, std::size_t count,
+				  CelestialObj cel_obj, ThreadPool *pool) {
+	double mu = G * cel_obj.mass;
+	for_blocks(count, pool, [=](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			kepl_to_cart_kernel(kepl_elems[i], mu, cart_elems[i].pos, cart_elems[i].vel);
+		}
+	});
+}
+
+void cart_to_kepl(const CartElem *cart_elems, KeplElem *kepl_elems, std::size_t count,
+				  CelestialObj cel_obj, ThreadPool *pool) {
+	double mu = G * cel_obj.mass;
+	for_blocks(count, pool, [=](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			cart_to_kepl_kernel(cart_elems[i].pos, cart_elems[i].vel, mu, kepl_elems[i]);
+		}
+	});
+}
+
+void cart_to_kepl(const Vec3 *pos_arr, const Vec3 *vel_arr, KeplElem *kepl_elems,
+				  std::size_t count, CelestialObj cel_obj, ThreadPool *pool) {
+	double mu = G * cel_obj.mass;
+	for_blocks(count, pool, [=](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			cart_to_kepl_kernel(pos_arr[i], vel_arr[i], mu, kepl_elems[i]);
+		}
+	});
+}
+
+double ecc_anom_from_mean(double mean_anom, double ecc) {
+	return kepler_kernel(mean_anom, ecc);
+}
+
+double mean_anom_from_ecc(double ecc_anom, double ecc) {
+	return ecc_anom - ecc * std::sin(ecc_anom);
+}
+
+double true_anom_from_ecc(double ecc_anom, double ecc) {
+	return true_from_ecc_kernel(ecc_anom, ecc);
+}
+
+double ecc_anom_from_true(double true_anom, double ecc) {
+	double k = std::round(true_anom / (2*PI));
+	double ni = true_anom - 2*PI * k;
+	return 2 * std::atan2(std::sqrt(1 - ecc) * std::sin(ni / 2), std::sqrt(1 + ecc) * std::cos(ni / 2)) + 2*PI * k;
+}
+
+double true_anom_from_mean(double mean_anom, double ecc) {
+	return true_from_ecc_kernel(kepler_kernel(mean_anom, ecc), ecc);
+}
+
+double mean_anom_from_true(double true_anom, double ecc) {
+	return mean_anom_from_ecc(ecc_anom_from_true(true_anom, ecc), ecc);
+}
+
+void ecc_anom_from_mean(const double *mean_anoms, const double *eccs, double *ecc_anoms,
+						std::size_t count, ThreadPool *pool) {
+	for_blocks(count, pool, [=](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			ecc_anoms[i] = kepler_kernel(mean_anoms[i], eccs[i]);
+		}
+	});
+}
+
+void true_anom_from_mean(const double *mean_anoms, const double *eccs, double *true_anoms,
+						 std::size_t count, ThreadPool *pool) {
+	for_blocks(count, pool, [=](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			true_anoms[i] = true_from_ecc_kernel(kepler_kernel(mean_anoms[i], eccs[i]), eccs[i]);
+		}
+	});
+}
+
+std::vector<CartElem> kepl_to_cart(const std::vector<KeplElem> &kepl_elems,
+								   CelestialObj cel_obj, ThreadPool *pool) {
+	std::vector<CartElem> cart_elems(kepl_elems.size());
+	kepl_to_cart(kepl_elems.data(), cart_elems.data(), kepl_elems.size(), cel_obj, pool);
+	return cart_elems;
+}
+
+std::vector<KeplElem> cart_to_kepl(const std::vector<CartElem> &cart_elems,
+								   CelestialObj cel_obj, ThreadPool *pool) {
+	std::vector<KeplElem> kepl_elems(cart_elems.size());
+	cart_to_kepl(cart_elems.data(), kepl_elems.data(), cart_elems.size(), cel_obj, pool);
+	return kepl_elems;
+}
+
+} // namespace orbsim
@@ -0,0 +1,63 @@
+#ifndef ORBITAL_ELEMENTS_HPP
+#define ORBITAL_ELEMENTS_HPP
+
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/thread_pool.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace orbsim {
+
+/**
+ * @brief Conversions between Keplerian elements and Cartesian state vectors
+ *
+ * The batch versions run the same branch-free kernel over whole arrays, so
+ * the compiler can vectorize everything but the trigonometric functions.
+ * With a thread pool the arrays are split into blocks between its threads;
+ * called from a task of that same pool they run on the calling thread.
+ */
+CartElem kepl_to_cart(const KeplElem &kepl_elem, CelestialObj cel_obj = Earth);
+KeplElem cart_to_kepl(const CartElem &cart_elem, CelestialObj cel_obj = Earth);
+
+void kepl_to_cart(const KeplElem *kepl_elems, CartElem *cart_elems, std::size_t count,
+				  CelestialObj cel_obj = Earth, ThreadPool *pool = nullptr);
+void cart_to_kepl(const CartElem *cart_elems, KeplElem *kepl_elems, std::size_t count,
+				  CelestialObj cel_obj = Earth, ThreadPool *pool = nullptr);
+
+// States of a trajectory, as in SimData
+void cart_to_kepl(const Vec3 *pos_arr, const Vec3 *vel_arr, KeplElem *kepl_elems,
+				  std::size_t count, CelestialObj cel_obj = Earth, ThreadPool *pool = nullptr);
+
+std::vector<CartElem> kepl_to_cart(const std::vector<KeplElem> &kepl_elems,
+								   CelestialObj cel_obj = Earth, ThreadPool *pool = nullptr);
+std::vector<KeplElem> cart_to_kepl(const std::vector<CartElem> &cart_elems,
+								   CelestialObj cel_obj = Earth, ThreadPool *pool = nullptr);
+
+/**
+ * @brief Conversions between the mean, eccentric and true anomaly (for 0 <= e < 1)
+ *
+ * Kepler's equation is solved with Mikkola's cubic starter and a fixed
+ * number of Halley iterations, which reach machine precision for any
+ * eccentricity below 1 and keep the batch loops free of branches. The
+ * anomalies stay in the same revolution as the mean anomaly. The batch
+ * versions split the arrays between the threads of the pool like above.
+ */
+double ecc_anom_from_mean(double mean_anom, double ecc);
+double mean_anom_from_ecc(double ecc_anom, double ecc);
+double true_anom_from_ecc(double ecc_anom, double ecc);
+double ecc_anom_from_true(double true_anom, double ecc);
+double true_anom_from_mean(double mean_anom, double ecc);
+double mean_anom_from_true(double true_anom, double ecc);
+
+void ecc_anom_from_mean(const double *mean_anoms, const double *eccs, double *ecc_anoms,
+						std::size_t count, ThreadPool *pool = nullptr);
+void true_anom_from_mean(const double *mean_anoms, const double *eccs, double *true_anoms,
+						 std::size_t count, ThreadPool *pool = nullptr);
+
+} // namespace orbsim
+
+
+#endif	// ORBITAL_ELEMENTS_HPP
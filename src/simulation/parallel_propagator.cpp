@@ -0,0 +1,54 @@
+#include "parallel_propagator.hpp"
+
+#include "celestial_obj.hpp"
+#include "math_obj.hpp"
+#include "satellite.hpp"
+#include "thread_pool.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+namespace orbsim {
+
+ParallelPropagator::ParallelPropagator(unsigned threads) : pool(threads) {}
+
+unsigned ParallelPropagator::get_threads() const { return this->pool.get_threads(); }
+std::size_t ParallelPropagator::size() const { return this->sats.size(); }
+Satellite &ParallelPropagator::get_sat(std::size_t idx) { return this->sats[idx]; }
+
+void ParallelPropagator::add_sat(const Satellite &sat) {
+	this->sats.push_back(sat);
+}
+
+void ParallelPropagator::add_sats(const std::vector<CartElem> &cart_elems,
+								  std::string integ_name, CelestialObj cel_obj,
+								  double t_start, double t_end, int t_steps) {
+	this->sats.reserve(this->sats.size() + cart_elems.size());
+	for (const CartElem &cart_elem : cart_elems) {
+		this->sats.emplace_back(cart_elem, integ_name, cel_obj, t_start, t_end, t_steps);
+	}
+}
+
+void ParallelPropagator::add_sats(const std::vector<KeplElem> &kepl_elems,
+								  std::string integ_name, CelestialObj cel_obj,
+								  double t_start, double t_end, int t_steps) {
+	this->sats.reserve(this->sats.size() + kepl_elems.size());
+	for (const KeplElem &kepl_elem : kepl_elems) {
+		this->sats.emplace_back(kepl_elem, integ_name, cel_obj, t_start, t_end, t_steps);
+	}
+}
+
+std::vector<SimData> ParallelPropagator::propagate() {
+	std::vector<SimData> sim_data(this->sats.size());
+
+	// Every task writes only its own slot, so the order is deterministic
+	this->pool.parallel_for(this->sats.size(), [&](std::size_t i) {
+		sim_data[i] = this->sats[i].propagate();
+	});
+
+	return sim_data;
+}
+
+} // namespace orbsim
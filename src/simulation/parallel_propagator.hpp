@@ -0,0 +1,49 @@
+#ifndef PARALLEL_PROPAGATOR_HPP
+#define PARALLEL_PROPAGATOR_HPP
+
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/satellite.hpp"
+#include "simulation/thread_pool.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+namespace orbsim {
+
+/**
+ * @brief Propagates many satellites concurrently on a thread pool
+ *
+ * The results of propagate() are in the same order the satellites were
+ * added, no matter which thread integrated them.
+ */
+class ParallelPropagator {
+
+public:
+	explicit ParallelPropagator(unsigned threads = 0);
+
+	unsigned get_threads() const;
+	std::size_t size() const;
+	Satellite &get_sat(std::size_t idx);
+
+	void add_sat(const Satellite &sat);
+	void add_sats(const std::vector<CartElem> &cart_elems,
+				  std::string integ_name = "RK4", CelestialObj cel_obj = Earth,
+				  double t_start = 0, double t_end = 86400, int t_steps = 8640);
+	void add_sats(const std::vector<KeplElem> &kepl_elems,
+				  std::string integ_name = "RK4", CelestialObj cel_obj = Earth,
+				  double t_start = 0, double t_end = 86400, int t_steps = 8640);
+
+	std::vector<SimData> propagate();
+
+private:
+	ThreadPool pool;
+	std::vector<Satellite> sats;
+};
+
+} // namespace orbsim
+
+
+#endif	// PARALLEL_PROPAGATOR_HPP
@@ -0,0 +1,274 @@
+#include "propagation_cache.hpp"
+#include "celestial_obj.hpp"
+#include "hash.hpp"
+#include "math_obj.hpp"
+#include "trajectory_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace orbsim {
+
+namespace {
+
+// The whole key as it is stored next to a spilled trajectory
+std::string key_bytes(const PropagationKey &key) {
+	const double values[] = {
+		key.cart_elem.pos.x, key.cart_elem.pos.y, key.cart_elem.pos.z,
+		key.cart_elem.vel.x, key.cart_elem.vel.y, key.cart_elem.vel.z,
+		key.cel_obj.mass, key.cel_obj.radius, key.t_start, key.delta_t
+	};
+	std::string bytes(reinterpret_cast<const char *>(values), sizeof(values));
+	bytes.append(reinterpret_cast<const char *>(&key.t_steps), sizeof(key.t_steps));
+	bytes.append(reinterpret_cast<const char *>(&key.force_model), sizeof(key.force_model));
+	bytes.append(key.integ_name);
+	return bytes;
+}
+
+// Written under another name first, so a reader never sees half a file
+void replace_file(const std::string &path, const std::string &tmp_path) {
+	std::remove(path.c_str());
+	if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+		std::remove(tmp_path.c_str());
+		throw std::runtime_error("Could not write " + path + "!");
+	}
+}
+
+} // namespace
+
+bool PropagationKey::operator==(const PropagationKey &other) const {
+	return this->cart_elem.pos == other.cart_elem.pos && this->cart_elem.vel == other.cart_elem.vel &&
+		   this->integ_name == other.integ_name &&
+		   this->cel_obj.mass == other.cel_obj.mass && this->cel_obj.radius == other.cel_obj.radius &&
+		   this->t_start == other.t_start && this->delta_t == other.delta_t &&
+		   this->t_steps == other.t_steps && this->force_model == other.force_model;
+}
+
+std::uint64_t PropagationKey::hash() const {
+	Fnv1a fnv;
+	for (const Vec3 &v : {this->cart_elem.pos, this->cart_elem.vel}) {
+		fnv.add(v.x);
+		fnv.add(v.y);
+		fnv.add(v.z);
+	}
+	fnv.add(this->integ_name.data(), this->integ_name.size());
+	fnv.add(this->cel_obj.mass);
+	fnv.add(this->cel_obj.radius);
+	fnv.add(this->t_start);
+	fnv.add(this->delta_t);
+	fnv.add(&this->t_steps, sizeof(this->t_steps));
+	fnv.add(this->force_model);
+	return fnv.value;
+}
+
+PropagationCache::PropagationCache(std::size_t max_bytes, std::string spill_dir)
+	: max_bytes(max_bytes), spill_dir(std::move(spill_dir)), bytes(0), hits(0), misses(0), spill_count(0) {}
+
+std::shared_ptr<const CachedTrajectory> PropagationCache::get(const PropagationKey &key) {
+	std::uint64_t hash = key.hash();
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		auto it = this->index.find(hash);
+		if (it != this->index.end() && it->second->key == key) {
+			this->entries.splice(this->entries.begin(), this->entries, it->second);
+			this->hits++;
+			return it->second->trajectory;
+		}
+		if (this->spill_dir.empty()) {
+			this->misses++;
+			return nullptr;
+		}
+	}
+
+	// Not in memory, maybe it was spilled
+	std::shared_ptr<const CachedTrajectory> trajectory = load_spilled(key);
+
+	std::vector<Spill> evicted;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (trajectory == nullptr) {
+			this->misses++;
+			return nullptr;
+		}
+		this->hits++;
+		evicted = insert(key, trajectory);
+	}
+	spill(evicted);
+	return trajectory;
+}
+
+void PropagationCache::put(const PropagationKey &key, int steps,
+						   const double *time_arr, const Vec3 *pos_arr, const Vec3 *vel_arr) {
+	auto trajectory = std::make_shared<CachedTrajectory>();
+	trajectory->time_arr.assign(time_arr, time_arr + steps);
+	trajectory->pos_arr.assign(pos_arr, pos_arr + steps);
+	trajectory->vel_arr.assign(vel_arr, vel_arr + steps);
+
+	std::vector<Spill> evicted;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		evicted = insert(key, std::move(trajectory));
+	}
+	spill(evicted);
+}
+
+void PropagationCache::clear() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->entries.clear();
+	this->index.clear();
+	this->bytes = 0;
+}
+
+std::size_t PropagationCache::get_max_bytes() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->max_bytes;
+}
+
+std::string PropagationCache::get_spill_dir() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->spill_dir;
+}
+
+std::size_t PropagationCache::get_bytes() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->bytes;
+}
+
+std::size_t PropagationCache::size() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->entries.size();
+}
+
+std::size_t PropagationCache::get_hits() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->hits;
+}
+
+std::size_t PropagationCache::get_misses() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->misses;
+}
+
+void PropagationCache::set_max_bytes(std::size_t max_bytes) {
+	std::vector<Spill> evicted;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->max_bytes = max_bytes;
+		evicted = evict();
+	}
+	spill(evicted);
+}
+
+std::size_t PropagationCache::bytes_of(const CachedTrajectory &trajectory) {
+	return trajectory.time_arr.size() * (sizeof(double) + 2 * sizeof(Vec3));
+}
+
+std::string PropagationCache::spill_path(const PropagationKey &key) const {
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.orbtraj", (unsigned long long) key.hash());
+	return this->spill_dir + "/" + name;
+}
+
+std::shared_ptr<const CachedTrajectory> PropagationCache::load_spilled(const PropagationKey &key) const {
+	try {
+		// The file name is only the hash, the whole key is next to it
+		std::string path = spill_path(key);
+		std::ifstream key_file(path + ".key", std::ios::binary);
+		std::string stored((std::istreambuf_iterator<char>(key_file)), std::istreambuf_iterator<char>());
+		if (!key_file || stored != key_bytes(key)) return nullptr;
+
+		TrajectoryReader reader(path);
+		const TrajectoryHeader &header = reader.get_header();
+		if (header.integ_name != key.integ_name || header.cel_obj.mass != key.cel_obj.mass ||
+			header.cel_obj.radius != key.cel_obj.radius || header.epoch != key.t_start ||
+			header.steps != key.t_steps) {
+			return nullptr;
+		}
+
+		auto trajectory = std::make_shared<CachedTrajectory>();
+		trajectory->time_arr.resize(reader.size());
+		trajectory->pos_arr.resize(reader.size());
+		trajectory->vel_arr.resize(reader.size());
+		for (std::int64_t i = 0; i < reader.size(); i++) {
+			trajectory->time_arr[i] = reader.time_at(i);
+			trajectory->pos_arr[i] = reader.pos_at(i);
+			trajectory->vel_arr[i] = reader.vel_at(i);
+		}
+		return trajectory;
+	} catch (const std::exception &) {
+		return nullptr;
+	}
+}
+
+std::vector<PropagationCache::Spill> PropagationCache::insert(const PropagationKey &key,
+															 std::shared_ptr<const CachedTrajectory> trajectory) {
+	std::uint64_t hash = key.hash();
+	auto it = this->index.find(hash);
+	if (it != this->index.end()) {
+		this->bytes -= bytes_of(*it->second->trajectory);
+		this->entries.erase(it->second);
+		this->index.erase(it);
+	}
+
+	this->bytes += bytes_of(*trajectory);
+	this->entries.push_front(Entry{key, std::move(trajectory)});
+	this->index[hash] = this->entries.begin();
+	return evict();
+}
+
+std::vector<PropagationCache::Spill> PropagationCache::evict() {
+	std::vector<Spill> evicted;
+	while (this->bytes > this->max_bytes && !this->entries.empty()) {
+		Entry &entry = this->entries.back();
+		if (!this->spill_dir.empty()) {
+			evicted.push_back(Spill{entry, spill_path(entry.key), this->spill_count++});
+		}
+
+		this->bytes -= bytes_of(*entry.trajectory);
+		this->index.erase(entry.key.hash());
+		this->entries.pop_back();
+	}
+	return evicted;
+}
+
+void PropagationCache::spill(const std::vector<Spill> &evicted) const {
+	for (const Spill &spilled : evicted) {
+		const PropagationKey &key = spilled.entry.key;
+		const CachedTrajectory &trajectory = *spilled.entry.trajectory;
+		std::string tmp_path = spilled.path + "." + std::to_string(spilled.id) + ".tmp";
+		try {
+			// The key goes first, so a new trajectory is never matched by an old key
+			std::remove((spilled.path + ".key").c_str());
+			write_trajectory(tmp_path,
+				TrajectoryHeader{key.integ_name, key.cel_obj, key.t_start,
+								 (std::int64_t) trajectory.time_arr.size()},
+				trajectory.time_arr.data(), trajectory.pos_arr.data(), trajectory.vel_arr.data());
+			replace_file(spilled.path, tmp_path);
+
+			std::string bytes = key_bytes(key);
+			{
+				std::ofstream key_file(tmp_path, std::ios::binary);
+				key_file.write(bytes.data(), bytes.size());
+				if (!key_file) throw std::runtime_error("Could not write " + tmp_path + "!");
+			}
+			replace_file(spilled.path + ".key", tmp_path);
+		} catch (const std::exception &) {
+			// Losing a cache entry is fine
+			std::remove(tmp_path.c_str());
+		}
+	}
+}
+
+} // namespace orbsim
@@ -0,0 +1,107 @@
+#ifndef PROPAGATION_CACHE_HPP
+#define PROPAGATION_CACHE_HPP
+
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace orbsim {
+
+/**
+ * @brief Everything the result of a propagation depends on
+ */
+struct PropagationKey {
+	CartElem cart_elem;
+	std::string integ_name;
+	CelestialObj cel_obj;
+	double t_start;	// [s]
+	double delta_t;	// [s]
+	int t_steps;
+	std::uint64_t force_model;	// ForceModelDE::hash(), 0 for point-mass gravity
+
+	bool operator==(const PropagationKey &other) const;
+	std::uint64_t hash() const;
+};
+
+struct CachedTrajectory {
+	std::vector<double> time_arr;	// [s]
+	std::vector<Vec3> pos_arr;	// [km]
+	std::vector<Vec3> vel_arr;	// [km/s]
+};
+
+/**
+ * @brief Least recently used cache of propagation results
+ *
+ * Holds at most max_bytes of samples in memory. With a spill directory the
+ * entries that don't fit are written there as binary trajectory files
+ * (see trajectory_file.hpp), each with its whole key in a .key file next
+ * to it, and loaded back on a later hit. The directory isn't cleaned up.
+ * Safe to share between threads, the files are written outside the lock.
+ */
+class PropagationCache {
+
+public:
+	explicit PropagationCache(std::size_t max_bytes = 256 << 20, std::string spill_dir = "");
+	PropagationCache(const PropagationCache &other) = delete;
+	PropagationCache &operator=(const PropagationCache &other) = delete;
+
+	std::shared_ptr<const CachedTrajectory> get(const PropagationKey &key);
+	void put(const PropagationKey &key, int steps,
+			 const double *time_arr, const Vec3 *pos_arr, const Vec3 *vel_arr);
+	void clear();
+
+	std::size_t get_max_bytes() const;
+	std::string get_spill_dir() const;
+	std::size_t get_bytes() const;
+	std::size_t size() const;
+	std::size_t get_hits() const;
+	std::size_t get_misses() const;
+
+	void set_max_bytes(std::size_t max_bytes);
+
+private:
+	struct Entry {
+		PropagationKey key;
+		std::shared_ptr<const CachedTrajectory> trajectory;
+	};
+
+	// An evicted entry waiting to be written out
+	struct Spill {
+		Entry entry;
+		std::string path;
+		std::uint64_t id;	// keeps the temporary files of concurrent writes apart
+	};
+
+	static std::size_t bytes_of(const CachedTrajectory &trajectory);
+	std::string spill_path(const PropagationKey &key) const;
+	std::shared_ptr<const CachedTrajectory> load_spilled(const PropagationKey &key) const;
+	std::vector<Spill> insert(const PropagationKey &key, std::shared_ptr<const CachedTrajectory> trajectory);
+	std::vector<Spill> evict();
+	void spill(const std::vector<Spill> &evicted) const;
+
+	mutable std::mutex mutex;
+	std::size_t max_bytes;
+	std::string spill_dir;
+	std::size_t bytes;
+	std::size_t hits;
+	std::size_t misses;
+	std::uint64_t spill_count;
+
+	// Most recently used first
+	std::list<Entry> entries;
+	std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+};
+
+} // namespace orbsim
+
+
+#endif	// PROPAGATION_CACHE_HPP
@@ -6,7 +6,12 @@
 #include "integrators/rk4.hpp"
 #include "celestial_obj.hpp"
 #include "diff_eq.hpp"
+#include "forces/force_model.hpp"
 #include "math_obj.hpp"
+#include "orbital_elements.hpp"
+#include "propagation_cache.hpp"
+#include "sim_data.hpp"
+#include "trajectory_sink.hpp"
 
 #include <cmath>
 
@@ -15,6 +20,8 @@
 #include <iostream>
 #include <iomanip>
 #include <map>
+#include <memory>
+#include <optional>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -27,44 +34,45 @@ Satellite::Satellite(CartElem cart_elem,
 					 std::string integ_name, CelestialObj cel_obj,
 					 double t_start, double t_end, int t_steps)
 	: cart_elem(cart_elem), integ_name(integ_name), cel_obj(cel_obj),
-	  t_start(t_start), t_end(t_end), t_steps(t_steps) {
+	  t_start(t_start), t_end(t_end), t_steps(t_steps), arena(nullptr), incremental(false), cache(nullptr), events(nullptr), stm(false) {
 
-	std::set valid_integ {"Euler", "Verlet", "RK4"};
+	std::set valid_integ {"Euler", "Verlet", "RK4", "DOPRI5", "RK87", "GaussJackson",
+						   "Yoshida4", "Yoshida6", "Yoshida8", "Kepler"};
 	if (valid_integ.find(integ_name.c_str()) != valid_integ.end()) {
-		throw std::domain_error("Invalid integrator! Should be one of: Euler, Verlet and RK4");
+		throw std::domain_error("Invalid integrator! Should be one of: Euler, Verlet, RK4, DOPRI5, RK87, GaussJackson, Yoshida4, Yoshida6, Yoshida8 and Kepler");
 	}
 
-	calc_kepl();
+	this->kepl_elem = cart_to_kepl(this->cart_elem, this->cel_obj);
 
-	IntegratorFactory integ_fact(orbit_de, cel_obj, this->cart_elem.pos, this->cart_elem.vel, t_start, t_end, t_steps);
-	this->integ = integ_fact.create(integ_name);
+	this->integ = create_integ(integ_name);
 }
 
 Satellite::Satellite(KeplElem kepl_elem,
 					 std::string integ_name, CelestialObj cel_obj,
 					 double t_start, double t_end, int t_steps)
 	: kepl_elem(kepl_elem), integ_name(integ_name), cel_obj(cel_obj),
-	  t_start(t_start), t_end(t_end), t_steps(t_steps) {
+	  t_start(t_start), t_end(t_end), t_steps(t_steps), arena(nullptr), incremental(false), cache(nullptr), events(nullptr), stm(false) {
 
 	if (kepl_elem.ecc < 0 || kepl_elem.ecc >= 1) {
 		throw std::domain_error("Eccentricity must be a number between 0 and 1");
 	}
-	std::set valid_integ {"Euler", "Verlet", "RK4"};
+	std::set valid_integ {"Euler", "Verlet", "RK4", "DOPRI5", "RK87", "GaussJackson",
+						   "Yoshida4", "Yoshida6", "Yoshida8", "Kepler"};
 	if (valid_integ.find(integ_name.c_str()) != valid_integ.end()) {
-		throw std::domain_error("Invalid integrator! Should be one of: Euler, Verlet and RK4");
+		throw std::domain_error("Invalid integrator! Should be one of: Euler, Verlet, RK4, DOPRI5, RK87, GaussJackson, Yoshida4, Yoshida6, Yoshida8 and Kepler");
 	}
 
-	calc_cart();
+	this->cart_elem = kepl_to_cart(this->kepl_elem, this->cel_obj);
 
-	IntegratorFactory integ_fact(orbit_de, cel_obj, this->cart_elem.pos, this->cart_elem.vel, t_start, t_end, t_steps);
-	this->integ = integ_fact.create(integ_name);
+	this->integ = create_integ(integ_name);
 }
 
 Satellite::Satellite(const Satellite &other)
 	: cart_elem(other.cart_elem), kepl_elem(other.kepl_elem),
 	  integ_name(other.integ_name), cel_obj(other.cel_obj),
 	  t_start(other.t_start), t_end(other.t_end), t_steps(other.t_steps),
-	  integ(other.integ->copy()) {}
+	  integ(other.integ->copy()), arena(other.arena), incremental(other.incremental), cache(other.cache),
+	  events(other.events), stm(other.stm), force_model(other.force_model) {}
 
 Satellite &Satellite::operator=(const Satellite &other) {
 	Satellite sat_copy(other);
@@ -76,6 +84,12 @@ Satellite &Satellite::operator=(const Satellite &other) {
 	std::swap(this->t_end, sat_copy.t_end);
 	std::swap(this->t_steps, sat_copy.t_steps);
 	std::swap(this->integ, sat_copy.integ);
+	std::swap(this->arena, sat_copy.arena);
+	std::swap(this->incremental, sat_copy.incremental);
+	std::swap(this->cache, sat_copy.cache);
+	std::swap(this->events, sat_copy.events);
+	std::swap(this->stm, sat_copy.stm);
+	std::swap(this->force_model, sat_copy.force_model);
 
 	return *this;
 }
@@ -86,16 +100,23 @@ Satellite::~Satellite() {
 
 CartElem Satellite::get_cart_elem() const { return this->cart_elem; }
 KeplElem Satellite::get_kepl_elem() const { return this->kepl_elem; }
+double Satellite::get_mean_anom() const {
+	return mean_anom_from_true(this->kepl_elem.true_anom, this->kepl_elem.ecc);
+}
 
 double Satellite::get_t_start() const { return this->t_start; }
 double Satellite::get_t_end() const { return this->t_end; }
 double Satellite::get_t_steps() const { return this->t_steps; }
 
 std::string Satellite::get_integ_name() const { return this->integ_name; }
+CelestialObj Satellite::get_cel_obj() const { return this->cel_obj; }
+bool Satellite::get_incremental() const { return this->incremental; }
+EventDetector *Satellite::get_events() const { return this->events; }
+bool Satellite::get_stm() const { return this->stm; }
 
 void Satellite::set_cart_elem(CartElem new_cart_elem) {
 	this->cart_elem = new_cart_elem;
-	calc_kepl();
+	this->kepl_elem = cart_to_kepl(this->cart_elem, this->cel_obj);
 	this->integ->set_x0(this->cart_elem.pos);
 	this->integ->set_v0(this->cart_elem.vel);
 }
@@ -105,11 +126,17 @@ void Satellite::set_kepl_elem(KeplElem new_kepl_elem) {
 		throw std::domain_error("Eccentricity must be a number between 0 and 1");
 	}
 	this->kepl_elem = new_kepl_elem;
-	calc_cart();
+	this->cart_elem = kepl_to_cart(this->kepl_elem, this->cel_obj);
 	this->integ->set_x0(this->cart_elem.pos);
 	this->integ->set_v0(this->cart_elem.vel);
 }
 
+void Satellite::set_mean_anom(double mean_anom) {
+	KeplElem new_kepl_elem = this->kepl_elem;
+	new_kepl_elem.true_anom = true_anom_from_mean(mean_anom, new_kepl_elem.ecc);
+	set_kepl_elem(new_kepl_elem);
+}
+
 void Satellite::set_t_start(int t_start) {
 	if (t_start < 0) {
 		throw std::domain_error("Start time must be a positive integer!");
@@ -129,6 +156,14 @@ void Satellite::set_t_end(int t_end) {
 		throw std::domain_error("End time must be larger than start time!");
 	}
 	this->t_end = t_end;
+
+	// Keep the step size, the last sample is the one closest to the end time
+	if (this->incremental && this->t_steps > 1) {
+		double delta_t = this->integ->get_delta_t();
+		this->t_steps = 1 + std::lround((t_end - this->t_start) / delta_t);
+		this->integ->resize(this->t_steps);
+		return;
+	}
 	this->integ->set_delta_t(this->t_start, t_end);
 }
 
@@ -141,153 +176,117 @@ void Satellite::set_t_steps(int t_steps) {
 }
 
 void Satellite::set_integ(std::string integ_name) {
-	std::set valid_integ {"Euler", "Verlet", "RK4"};
+	std::set valid_integ {"Euler", "Verlet", "RK4", "DOPRI5", "RK87", "GaussJackson",
+						   "Yoshida4", "Yoshida6", "Yoshida8", "Kepler"};
 	if (valid_integ.find(integ_name.c_str()) != valid_integ.end()) {
-		throw std::domain_error("Invalid integrator! Should be one of: Euler, Verlet and RK4");
+		throw std::domain_error("Invalid integrator! Should be one of: Euler, Verlet, RK4, DOPRI5, RK87, GaussJackson, Yoshida4, Yoshida6, Yoshida8 and Kepler");
 	}
 
+	if (integ_name == this->integ_name) return;
+	replace_integ(integ_name);
 	this->integ_name = integ_name;
-
-	delete this->integ;
-	IntegratorFactory integ_fact(orbit_de, cel_obj, this->cart_elem.pos, this->cart_elem.vel, t_start, t_end, t_steps);
-	this->integ = integ_fact.create(integ_name);
 }
 
-SimData Satellite::propagate() {
-	this->integ->integrate();
-	return SimData{
-		this->integ->get_steps(),
-		this->integ->get_time_arr(),
-		this->integ->get_pos_arr(),
-		this->integ->get_vel_arr()
-	};
+void Satellite::set_force_model(const ForceModelDE &force_model) {
+	// Kepler can't take a force model, then nothing changes
+	std::optional<ForceModelDE> old_force_model = this->force_model;
+	this->force_model = force_model;
+	try {
+		replace_integ(this->integ_name);
+	} catch (const std::domain_error &) {
+		this->force_model = old_force_model;
+		throw;
+	}
 }
 
-void Satellite::calc_kepl() {
-
-	using std::acos;
-	using std::clamp;
-	using std::atan;
-	using std::tan;
-	using std::sqrt;
-	Vec3 r = this->cart_elem.pos * 1000;	// Convert to meters
-	Vec3 v = this->cart_elem.vel * 1000;	// Convert to meters
-
-	// Cartesian state vectors -> Keplerian orbital elements
-	// Steps are described here: https://downloads.rene-schwarz.com/download/M002-Cartesian_State_Vectors_to_Keplerian_Orbit_Elements.pdf
-
-	// 1) Prep.
-
-	// a) Orbital momentum vector
-	Vec3 h = r.cross(v);
-
-	// b) Ecc. vector and grav. parameter
-	double mu = G * cel_obj.mass;
-	Vec3 e = (v.cross(h) / mu) - r.norm();
-
-	// c) Vector pointing towards asc. node and true_anom
-	Vec3 n{-h.y, h.x, 0};
-	this->kepl_elem.true_anom = r.dot(v) >= 0 ?
-		acos(clamp(e.dot(r) / (e.len() * r.len()), -1.0, 1.0))
-		:
-		2*PI - acos(clamp(e.dot(r) / (e.len() * r.len()), -1.0, 1.0));
-	
-	// 2) Inc.
-
-	this->kepl_elem.inc = acos(h.z / h.len());
-
-	// 3) Ecc. and ecc. anomaly (second is not currently needed)
-
-	this->kepl_elem.ecc = e.len();
-	// double E = 2*atan(tan(this->true_anom/2) / sqrt((1 + this->ecc) / (1 - this->ecc)));
-
-	// 4) Longitude/Right asc. of asc. node and arg. of periapsis
-
-	this->kepl_elem.ri_asc_node = n.y >= 0 ?
-		acos(clamp(n.x / n.len(), -1.0, 1.0))
-		:
-		2*PI - acos(clamp(n.x / n.len(), -1.0, 1.0));
-	
-	this->kepl_elem.arg_of_per = e.z >= 0 ?
-		acos(clamp(n.dot(e) / (n.len() * e.len()), -1.0, 1.0))
-		:
-		2*PI - acos(clamp(n.dot(e) / (n.len() * e.len()), -1.0, 1.0));
-	
-	// 5) Mean anomaly (Not currently needed)
-
-	// double M = E - this->ecc * std::sin(E);
-
-	// 6) Semi-major axis
-
-	this->kepl_elem.sem_maj_ax = 1 / (2/r.len() - (v.len() * v.len())/mu);
-	this->kepl_elem.sem_maj_ax /= 1000;	// Convert back to kilometers
-
-
-	// std::cout << std::setprecision(15)
-	// 	<< "KEPLERIAN:\n"
-	// 	<< "ecc: " << this->kepl_elem.ecc << "\n"
-	// 	<< "sem_maj_ax: " << this->kepl_elem.sem_maj_ax << "\n"
-	// 	<< "inc: " << this->kepl_elem.inc << "\n"
-	// 	<< "ri_asc_node: " << this->kepl_elem.ri_asc_node << "\n"
-	// 	<< "arg_of_per: " << this->kepl_elem.arg_of_per << "\n"
-	// 	<< "true_anom: " << this->kepl_elem.true_anom << "\n";
+void Satellite::set_incremental(bool incremental) {
+	this->incremental = incremental;
 }
 
-void Satellite::calc_cart() {
-
-	using std::sin;
-	using std::cos;
-	using std::sqrt;
-	using std::atan2;
-	double e = this->kepl_elem.ecc;
-	double a = this->kepl_elem.sem_maj_ax * 1000;	// Convert to meters
-	double i = this->kepl_elem.inc;
-	double OM = this->kepl_elem.ri_asc_node;
-	double w = this->kepl_elem.arg_of_per;
-	double ni = this->kepl_elem.true_anom;
-
-	// Keplerian orbital elements -> Cartesian state vectors
-	// Steps are described here: https://downloads.rene-schwarz.com/download/M001-Keplerian_Orbit_Elements_to_Cartesian_State_Vectors.pdf
+void Satellite::set_cache(PropagationCache *cache) {
+	this->cache = cache;
+}
 
-	// 1) Mean anomaly (SKIP - don't need it)
+void Satellite::set_arena(TrajectoryArena *arena) {
+	this->arena = arena;
+	this->integ->set_arena(arena);
+}
 
-	// 2) Solve Kepler's equation for the ecc. anom
+void Satellite::set_events(EventDetector *events) {
+	this->events = events;
+	this->integ->set_events(events);
+}
 
-	double E = 2 * atan2(sqrt(1 - e) * sin(ni/2), sqrt(1 + e) * cos(ni/2));
+void Satellite::set_stm(bool stm) {
+	this->integ->set_stm(stm);
+	this->stm = stm;
+}
 
-	// 3) Obtain true anom.	(SKIP - already have it)
+SimData Satellite::propagate() {
+	this->integ->set_sink(nullptr);
 
-	// 4) Get distance to central body
+	// A cached trajectory has neither the events nor the state transition matrix
+	PropagationCache *cache = this->events == nullptr && !this->stm ? this->cache : nullptr;
 
-	double r = a * (1 - e * cos(E));
+	PropagationKey key{
+		this->cart_elem, this->integ_name, this->cel_obj,
+		this->t_start, this->integ->get_delta_t(), (int) this->t_steps,
+		this->force_model.has_value() ? this->force_model->hash() : 0
+	};
+	std::shared_ptr<const CachedTrajectory> cached;
+	if (cache != nullptr) {
+		cached = cache->get(key);
+	}
 
-	// 5) Obtain pos and vel vectors in orbital frame
+	if (cached != nullptr) {
+		this->integ->load_samples(cached->time_arr.data(), cached->pos_arr.data(), cached->vel_arr.data());
+	} else if (this->incremental) {
+		this->integ->extend();
+	} else {
+		this->integ->integrate();
+	}
 
-	Vec3 pos_o = r * Vec3{
-		cos(ni),
-		sin(ni),
-		0
-	};
+	if (cache != nullptr && cached == nullptr) {
+		cache->put(key, this->integ->get_steps(), this->integ->get_time_arr(),
+						 this->integ->get_pos_arr(), this->integ->get_vel_arr());
+	}
 
-	double mu = G * cel_obj.mass;
-	Vec3 vel_o = (sqrt(mu * a) / r) * Vec3{
-		- sin(E),
-		sqrt(1 - e*e) * cos(E),
-		0
-	};
+	return SimData(
+		this->integ->get_sample_count(),
+		this->integ->get_time_arr(),
+		this->integ->get_pos_arr(),
+		this->integ->get_vel_arr(),
+		this->integ->get_stm_arr()
+	);
+}
 
-	// 6) Transform to inertial frame
+void Satellite::propagate(TrajectorySink &sink, int window) {
+	// Only a window of samples is kept, the sink gets all of them
+	this->integ->set_sink(&sink, window);
+	this->integ->integrate();
+	this->integ->set_sink(nullptr);
+}
 
-	auto transform = [=](Vec3 o) {
-		return Vec3{
-			o.x * (cos(w)*cos(OM) - sin(w)*cos(i)*sin(OM)) - o.y * (sin(w)*cos(OM) + cos(w)*cos(i)*sin(OM)),
-			o.x * (cos(w)*sin(OM) + sin(w)*cos(i)*cos(OM)) + o.y * (cos(w)*cos(i)*cos(OM) - sin(w)*sin(OM)),
-			o.x * sin(w)*sin(i) + o.y * cos(w)*sin(i)
-		};
-	};
+Integrator *Satellite::create_integ(std::string integ_name) const {
+	std::unique_ptr<Integrator> integ;
+	if (this->force_model.has_value()) {
+		IntegratorFactory integ_fact(*this->force_model, cel_obj, this->cart_elem.pos, this->cart_elem.vel, t_start, t_end, t_steps);
+		integ.reset(integ_fact.create(integ_name));
+	} else {
+		IntegratorFactory integ_fact(orbit_de, cel_obj, this->cart_elem.pos, this->cart_elem.vel, t_start, t_end, t_steps);
+		integ.reset(integ_fact.create(integ_name));
+	}
+	integ->set_events(this->events);
+	integ->set_stm(this->stm);
+	return integ.release();
+}
 
-	this->cart_elem.pos = transform(pos_o) / 1000;
-	this->cart_elem.vel = transform(vel_o) / 1000;
+void Satellite::replace_integ(std::string integ_name) {
+	// The new integrator takes over the trajectory arrays of the old one
+	Integrator *new_integ = create_integ(integ_name);
+	new_integ->swap_buffer(*this->integ);
+	delete this->integ;
+	this->integ = new_integ;
 }
 
 } // namespace orbsim
@@ -2,28 +2,36 @@
 #define SATELLITE_HPP
 
 #include "simulation/integrators/integrator.hpp"
+#include "simulation/events.hpp"
+#include "simulation/forces/force_model.hpp"
 #include "simulation/celestial_obj.hpp"
 #include "simulation/math_obj.hpp"
+#include "simulation/propagation_cache.hpp"
+#include "simulation/sim_data.hpp"
+#include "simulation/trajectory_buffer.hpp"
+#include "simulation/trajectory_sink.hpp"
 
+#include <optional>
 #include <string>
-// #include <vector>
 
 
 namespace orbsim {
 
-struct SimData {
-	int steps;
-	double *time_arr;
-	Vec3 *pos_arr;	// [km]
-	Vec3 *vel_arr;	// [km]
-
-	// maybe better?
-	// std::vector<Vec3> pos_arr;	// [km]
-	// std::vector<Vec3> vel_arr;	// [km]
-};
-
 /**
  * @brief Satellite
+ *
+ * In incremental mode the step size stays the same when the end time
+ * changes, so a longer time span only adds steps and propagate() continues
+ * from the last computed state instead of starting over. Changing anything
+ * else still propagates from the start.
+ *
+ * With a cache propagate() first looks for the result of an identical
+ * propagation, by this or any other satellite using the same cache.
+ *
+ * With an event detector the events are found while propagating, the cache
+ * is then not used. A terminal event ends the trajectory at the event. The
+ * same goes for the state transition matrix, which is only propagated by
+ * the RK4, DOPRI5 and RK87 integrators.
  */
 class Satellite {
 
@@ -42,25 +50,38 @@ public:
 
 	CartElem get_cart_elem() const;
 	KeplElem get_kepl_elem() const;
+	double get_mean_anom() const;
 
 	double get_t_start() const;
 	double get_t_end() const;
 	double get_t_steps() const;
 	std::string get_integ_name() const;
+	CelestialObj get_cel_obj() const;
+	bool get_incremental() const;
+	EventDetector *get_events() const;
+	bool get_stm() const;
 
 	void set_cart_elem(CartElem new_cart_elem);
 	void set_kepl_elem(KeplElem new_kepl_elem);
+	void set_mean_anom(double mean_anom);	// keeps the other elements
 
 	void set_t_start(int t_start);
 	void set_t_end(int t_end);
 	void set_t_steps(int t_steps);
 	void set_integ(std::string integ_name);
+	void set_arena(TrajectoryArena *arena);
+	void set_incremental(bool incremental);
+	void set_cache(PropagationCache *cache);
+	void set_force_model(const ForceModelDE &force_model);
+	void set_events(EventDetector *events);
+	void set_stm(bool stm);
 
 	SimData propagate();
+	void propagate(TrajectorySink &sink, int window = 1024);
 
 private:
-	void calc_kepl();
-	void calc_cart();
+	Integrator *create_integ(std::string integ_name) const;
+	void replace_integ(std::string integ_name);
 
 	CartElem cart_elem;
 	KeplElem kepl_elem;
@@ -72,6 +93,12 @@ private:
 	double t_steps;
 
 	Integrator *integ;
+	TrajectoryArena *arena;	// not owned, may be null
+	bool incremental;
+	PropagationCache *cache;	// not owned, may be null
+	EventDetector *events;	// not owned, may be null
+	bool stm;
+	std::optional<ForceModelDE> force_model;	// point-mass gravity without one
 };
 
 } // namespace orbsim
@@ -0,0 +1,99 @@
+#include "sim_data.hpp"
+
+#include "math_obj.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace orbsim {
+
+SimData::SimData() : inv_delta_t(0) {}
+
+SimData::SimData(int steps, const double *time_arr, const Vec3 *pos_arr, const Vec3 *vel_arr,
+				 const Mat6 *stm_arr)
+	: time_arr(time_arr, time_arr + steps), pos_arr(pos_arr, pos_arr + steps),
+	  vel_arr(vel_arr, vel_arr + steps), inv_delta_t(0) {
+
+	if (stm_arr != nullptr) this->stm_arr.assign(stm_arr, stm_arr + steps);
+
+	if (steps > 1) {
+		// A terminal event can make the last step shorter
+		this->inv_delta_t = 1 / (time_arr[1] - time_arr[0]);
+	}
+}
+
+int SimData::get_steps() const { return (int) this->time_arr.size(); }
+const double *SimData::get_time_arr() const { return this->time_arr.data(); }
+const Vec3 *SimData::get_pos_arr() const { return this->pos_arr.data(); }
+const Vec3 *SimData::get_vel_arr() const { return this->vel_arr.data(); }
+const Mat6 *SimData::get_stm_arr() const { return this->stm_arr.empty() ? nullptr : this->stm_arr.data(); }
+bool SimData::has_stm() const { return !this->stm_arr.empty(); }
+double SimData::get_t_start() const { return this->time_arr.front(); }
+double SimData::get_t_end() const { return this->time_arr.back(); }
+
+CartElem SimData::state_at(double t) const {
+	check_time(t);
+	return interpolate(t);
+}
+
+void SimData::states_at(const double *times, CartElem *states, std::size_t count) const {
+	for (std::size_t i = 0; i < count; i++) check_time(times[i]);
+	for (std::size_t i = 0; i < count; i++) states[i] = interpolate(times[i]);
+}
+
+std::vector<CartElem> SimData::states_at(const std::vector<double> &times) const {
+	std::vector<CartElem> states(times.size());
+	states_at(times.data(), states.data(), times.size());
+	return states;
+}
+
+void SimData::check_time(double t) const {
+	if (this->time_arr.empty()) {
+		throw std::out_of_range("No samples to interpolate!");
+	}
+	double t_start = this->time_arr.front();
+	double t_end = this->time_arr.back();
+	double eps = 1e-9 * std::max(1.0, std::fabs(t_end));
+	if (!(t >= t_start - eps && t <= t_end + eps)) {
+		throw std::out_of_range("Time " + std::to_string(t) + " is outside of the trajectory!");
+	}
+}
+
+CartElem SimData::interpolate(double t) const {
+	int steps = (int) this->time_arr.size();
+	if (steps == 1) return CartElem{this->pos_arr[0], this->vel_arr[0]};
+
+	// Step of the uniform grid, then the position within it
+	int i = (int) ((t - this->time_arr[0]) * this->inv_delta_t);
+	i = std::clamp(i, 0, steps - 2);
+	double h = this->time_arr[i + 1] - this->time_arr[i];
+	double s = (t - this->time_arr[i]) / h;
+
+	double s2 = s * s, s3 = s2 * s;
+	double h00 = 2*s3 - 3*s2 + 1, h10 = (s3 - 2*s2 + s) * h;
+	double h01 = -2*s3 + 3*s2, h11 = (s3 - s2) * h;
+	double d00 = (6*s2 - 6*s) / h, d10 = 3*s2 - 4*s + 1;
+	double d01 = (-6*s2 + 6*s) / h, d11 = 3*s2 - 2*s;
+
+	const Vec3 &p0 = this->pos_arr[i], &p1 = this->pos_arr[i + 1];
+	const Vec3 &v0 = this->vel_arr[i], &v1 = this->vel_arr[i + 1];
+	return CartElem{
+		Vec3{
+			h00*p0.x + h10*v0.x + h01*p1.x + h11*v1.x,
+			h00*p0.y + h10*v0.y + h01*p1.y + h11*v1.y,
+			h00*p0.z + h10*v0.z + h01*p1.z + h11*v1.z
+		},
+		Vec3{
+			d00*p0.x + d10*v0.x + d01*p1.x + d11*v1.x,
+			d00*p0.y + d10*v0.y + d01*p1.y + d11*v1.y,
+			d00*p0.z + d10*v0.z + d01*p1.z + d11*v1.z
+		}
+	};
+}
+
+} // namespace orbsim
@@ -0,0 +1,58 @@
+#ifndef SIM_DATA_HPP
+#define SIM_DATA_HPP
+
+#include "simulation/math_obj.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace orbsim {
+
+/**
+ * @brief Trajectory of a propagation, with its own copy of the samples
+ *
+ * The samples are on a uniform time grid, except that the last step may be
+ * shorter, so state_at() finds the step of a time by division and
+ * interpolates between its ends with a cubic Hermite polynomial of the
+ * positions and velocities. The velocity is the derivative of that
+ * polynomial and one order less accurate.
+ *
+ * A propagation with the state transition matrix also has one for every
+ * sample, from the initial state to the state of the sample.
+ */
+class SimData {
+
+public:
+	SimData();
+	SimData(int steps, const double *time_arr, const Vec3 *pos_arr, const Vec3 *vel_arr,
+			const Mat6 *stm_arr = nullptr);
+
+	int get_steps() const;
+	const double *get_time_arr() const;
+	const Vec3 *get_pos_arr() const;
+	const Vec3 *get_vel_arr() const;
+	const Mat6 *get_stm_arr() const;
+	bool has_stm() const;
+	double get_t_start() const;
+	double get_t_end() const;
+
+	CartElem state_at(double t) const;
+	void states_at(const double *times, CartElem *states, std::size_t count) const;
+	std::vector<CartElem> states_at(const std::vector<double> &times) const;
+
+private:
+	void check_time(double t) const;
+	CartElem interpolate(double t) const;
+
+	std::vector<double> time_arr;	// [s]
+	std::vector<Vec3> pos_arr;	// [km]
+	std::vector<Vec3> vel_arr;	// [km/s]
+	std::vector<Mat6> stm_arr;	// empty without the state transition matrix
+	double inv_delta_t;
+};
+
+} // namespace orbsim
+
+
+#endif	// SIM_DATA_HPP
@@ -0,0 +1,160 @@
+#include "thread_pool.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+
+namespace orbsim {
+
+namespace {
+
+// Pool whose task the current thread is running, if any
+thread_local const ThreadPool *running_pool = nullptr;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threads)
+	: task(nullptr), generation(0), active(0), stop(false) {
+
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+	}
+	if (threads == 0) {
+		threads = 1;
+	}
+
+	for (unsigned i = 0; i < threads; i++) {
+		this->queues.push_back(std::make_unique<WorkQueue>());
+	}
+	for (unsigned i = 1; i < threads; i++) {
+		this->workers.emplace_back(&ThreadPool::worker_loop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stop = true;
+	}
+	this->start_cv.notify_all();
+	for (std::thread &worker : this->workers) {
+		worker.join();
+	}
+}
+
+unsigned ThreadPool::get_threads() const { return this->queues.size(); }
+
+void ThreadPool::parallel_for(std::size_t count, const std::function<void(std::size_t)> &task) {
+	// Called from one of its own tasks, the workers are busy already
+	if (running_pool == this) {
+		for (std::size_t i = 0; i < count; i++) task(i);
+		return;
+	}
+
+	std::lock_guard<std::mutex> run_lock(this->run_mutex);
+	const ThreadPool *outer = running_pool;
+	running_pool = this;
+
+	// Give every worker a contiguous share of the indices
+	std::size_t n_queues = this->queues.size();
+	for (std::size_t q = 0; q < n_queues; q++) {
+		std::lock_guard<std::mutex> lock(this->queues[q]->mutex);
+		for (std::size_t i = q * count / n_queues; i < (q + 1) * count / n_queues; i++) {
+			this->queues[q]->tasks.push_back(i);
+		}
+	}
+
+	this->error = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->task = &task;
+		this->active = this->workers.size();
+		this->generation++;
+	}
+	this->start_cv.notify_all();
+
+	drain(0, task);
+
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->done_cv.wait(lock, [this] { return this->active == 0; });
+		this->task = nullptr;
+	}
+	running_pool = outer;
+
+	if (this->error) {
+		std::rethrow_exception(this->error);
+	}
+}
+
+void ThreadPool::worker_loop(unsigned id) {
+	running_pool = this;
+	std::size_t seen = 0;
+	for (;;) {
+		const std::function<void(std::size_t)> *task;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->start_cv.wait(lock, [&] { return this->stop || this->generation != seen; });
+			if (this->stop) {
+				return;
+			}
+			seen = this->generation;
+			task = this->task;
+		}
+
+		drain(id, *task);
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if (--this->active == 0) {
+				this->done_cv.notify_all();
+			}
+		}
+	}
+}
+
+void ThreadPool::drain(unsigned id, const std::function<void(std::size_t)> &task) {
+	std::size_t idx;
+	while (pop(id, idx) || steal(id, idx)) {
+		try {
+			task(idx);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(this->error_mutex);
+			if (!this->error) {
+				this->error = std::current_exception();
+			}
+		}
+	}
+}
+
+bool ThreadPool::pop(unsigned id, std::size_t &idx) {
+	WorkQueue &queue = *this->queues[id];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.tasks.empty()) {
+		return false;
+	}
+	idx = queue.tasks.front();
+	queue.tasks.pop_front();
+	return true;
+}
+
+bool ThreadPool::steal(unsigned id, std::size_t &idx) {
+	std::size_t n_queues = this->queues.size();
+	for (std::size_t i = 1; i < n_queues; i++) {
+		WorkQueue &victim = *this->queues[(id + i) % n_queues];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty()) {
+			idx = victim.tasks.back();
+			victim.tasks.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace orbsim
@@ -0,0 +1,72 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace orbsim {
+
+/**
+ * @brief Fixed size pool of worker threads with work stealing
+ *
+ * parallel_for() splits the index range evenly between the workers' queues.
+ * A worker that runs out of its own indices steals from the back of another
+ * worker's queue, so uneven tasks still keep every thread busy. The calling
+ * thread takes part as worker 0.
+ *
+ * A parallel_for() from inside one of the pool's own tasks runs its range
+ * on the calling thread, so passing the pool down to nested batch calls
+ * doesn't deadlock.
+ */
+class ThreadPool {
+
+public:
+	explicit ThreadPool(unsigned threads = 0);
+	ThreadPool(const ThreadPool &other) = delete;
+	ThreadPool &operator=(const ThreadPool &other) = delete;
+
+	~ThreadPool();
+
+	unsigned get_threads() const;
+
+	void parallel_for(std::size_t count, const std::function<void(std::size_t)> &task);
+
+private:
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<std::size_t> tasks;
+	};
+
+	void worker_loop(unsigned id);
+	void drain(unsigned id, const std::function<void(std::size_t)> &task);
+	bool pop(unsigned id, std::size_t &idx);
+	bool steal(unsigned id, std::size_t &idx);
+
+	std::vector<std::thread> workers;
+	std::vector<std::unique_ptr<WorkQueue>> queues;
+
+	std::mutex run_mutex;	// one parallel_for() at a time
+	std::mutex mutex;
+	std::condition_variable start_cv;
+	std::condition_variable done_cv;
+	const std::function<void(std::size_t)> *task;
+	std::size_t generation;
+	unsigned active;
+	bool stop;
+
+	std::mutex error_mutex;
+	std::exception_ptr error;
+};
+
+} // namespace orbsim
+
+
+#endif	// THREAD_POOL_HPP
@@ -0,0 +1,176 @@
+#include "trajectory_buffer.hpp"
+#include "math_obj.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace orbsim {
+
+namespace {
+
+// Smallest block the arena hands out is 2^min_class bytes
+const int min_class = 8;
+
+int size_class(std::size_t bytes) {
+	int cls = min_class;
+	while (((std::size_t) 1 << cls) < bytes) cls++;
+	return cls;
+}
+
+} // namespace
+
+static_assert(std::is_trivially_copyable_v<Vec3>, "Trajectory buffers copy Vec3 with memcpy");
+
+TrajectoryArena::~TrajectoryArena() {
+	for (FreeBlock *&head : this->free_lists) {
+		while (head != nullptr) {
+			FreeBlock *next = head->next;
+			::operator delete(head);
+			head = next;
+		}
+	}
+}
+
+void *TrajectoryArena::allocate(std::size_t bytes) {
+	int cls = size_class(bytes);
+	if (cls - min_class >= size_classes) throw std::bad_alloc();
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		FreeBlock *&head = this->free_lists[cls - min_class];
+		if (head != nullptr) {
+			FreeBlock *block = head;
+			head = block->next;
+			this->reuses++;
+			return block;
+		}
+		this->heap_allocs++;
+	}
+	return ::operator new((std::size_t) 1 << cls);
+}
+
+void TrajectoryArena::deallocate(void *block, std::size_t bytes) {
+	if (block == nullptr) return;
+
+	std::lock_guard<std::mutex> lock(this->mutex);
+	FreeBlock *&head = this->free_lists[size_class(bytes) - min_class];
+	head = new (block) FreeBlock{head};
+}
+
+std::size_t TrajectoryArena::get_heap_allocs() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->heap_allocs;
+}
+
+std::size_t TrajectoryArena::get_reuses() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->reuses;
+}
+
+TrajectoryBuffer::TrajectoryBuffer(TrajectoryArena *arena)
+	: arena(arena), capacity(0), block(nullptr),
+	  time_arr(nullptr), pos_arr(nullptr), vel_arr(nullptr) {}
+
+TrajectoryBuffer::TrajectoryBuffer(const TrajectoryBuffer &other)
+	: TrajectoryBuffer(other.arena) {
+
+	reserve(other.capacity);
+	if (other.capacity > 0) {
+		std::memcpy(this->block, other.block, bytes_for(other.capacity));
+	}
+}
+
+TrajectoryBuffer &TrajectoryBuffer::operator=(const TrajectoryBuffer &other) {
+	TrajectoryBuffer buffer_copy(other);
+	swap(buffer_copy);
+
+	return *this;
+}
+
+TrajectoryBuffer::~TrajectoryBuffer() {
+	release();
+}
+
+int TrajectoryBuffer::get_capacity() const { return this->capacity; }
+TrajectoryArena *TrajectoryBuffer::get_arena() const { return this->arena; }
+double *TrajectoryBuffer::get_time_arr() const { return this->time_arr; }
+Vec3 *TrajectoryBuffer::get_pos_arr() const { return this->pos_arr; }
+Vec3 *TrajectoryBuffer::get_vel_arr() const { return this->vel_arr; }
+
+void TrajectoryBuffer::reserve(int capacity) {
+	if (capacity <= this->capacity) return;
+
+	// Positions and velocities first, the times after them
+	void *block = allocate(capacity);
+	Vec3 *pos_arr = static_cast<Vec3 *>(block);
+	Vec3 *vel_arr = pos_arr + capacity;
+	double *time_arr = reinterpret_cast<double *>(vel_arr + capacity);
+	std::fill(pos_arr, pos_arr + 2 * capacity, Vec3{0, 0, 0});
+	std::fill(time_arr, time_arr + capacity, 0.0);
+
+	// The old samples are kept
+	if (this->capacity > 0) {
+		std::copy(this->pos_arr, this->pos_arr + this->capacity, pos_arr);
+		std::copy(this->vel_arr, this->vel_arr + this->capacity, vel_arr);
+		std::copy(this->time_arr, this->time_arr + this->capacity, time_arr);
+	}
+
+	release();
+	this->capacity = capacity;
+	this->block = block;
+	this->time_arr = time_arr;
+	this->pos_arr = pos_arr;
+	this->vel_arr = vel_arr;
+}
+
+void TrajectoryBuffer::set_arena(TrajectoryArena *arena) {
+	if (arena == this->arena) return;
+
+	TrajectoryBuffer moved(arena);
+	moved.reserve(this->capacity);
+	if (this->capacity > 0) {
+		std::memcpy(moved.block, this->block, bytes_for(this->capacity));
+	}
+	swap(moved);
+}
+
+void TrajectoryBuffer::swap(TrajectoryBuffer &other) {
+	std::swap(this->arena, other.arena);
+	std::swap(this->capacity, other.capacity);
+	std::swap(this->block, other.block);
+	std::swap(this->time_arr, other.time_arr);
+	std::swap(this->pos_arr, other.pos_arr);
+	std::swap(this->vel_arr, other.vel_arr);
+}
+
+std::size_t TrajectoryBuffer::bytes_for(int capacity) {
+	return (std::size_t) capacity * (2 * sizeof(Vec3) + sizeof(double));
+}
+
+void *TrajectoryBuffer::allocate(int capacity) const {
+	if (this->arena != nullptr) return this->arena->allocate(bytes_for(capacity));
+	return ::operator new(bytes_for(capacity));
+}
+
+void TrajectoryBuffer::release() {
+	if (this->block == nullptr) return;
+
+	if (this->arena != nullptr) {
+		this->arena->deallocate(this->block, bytes_for(this->capacity));
+	} else {
+		::operator delete(this->block);
+	}
+	this->capacity = 0;
+	this->block = nullptr;
+	this->time_arr = nullptr;
+	this->pos_arr = nullptr;
+	this->vel_arr = nullptr;
+}
+
+} // namespace orbsim
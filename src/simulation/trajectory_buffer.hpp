@@ -0,0 +1,90 @@
+#ifndef TRAJECTORY_BUFFER_HPP
+#define TRAJECTORY_BUFFER_HPP
+
+#include "simulation/math_obj.hpp"
+
+#include <cstddef>
+#include <mutex>
+
+
+namespace orbsim {
+
+/**
+ * @brief Pool of memory blocks for trajectory buffers
+ *
+ * Blocks are rounded up to a power of two and kept on a free list when they
+ * are released, so buffers that are resized or recreated over and over
+ * (re-simulation, parameter sweeps) get their memory back without touching
+ * the heap. Safe to share between threads. Must outlive its buffers.
+ */
+class TrajectoryArena {
+
+public:
+	TrajectoryArena() = default;
+	TrajectoryArena(const TrajectoryArena &other) = delete;
+	TrajectoryArena &operator=(const TrajectoryArena &other) = delete;
+
+	~TrajectoryArena();
+
+	void *allocate(std::size_t bytes);
+	void deallocate(void *block, std::size_t bytes);
+
+	std::size_t get_heap_allocs() const;
+	std::size_t get_reuses() const;
+
+private:
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	static const int size_classes = 48;
+
+	mutable std::mutex mutex;
+	FreeBlock *free_lists[size_classes] = {};
+	std::size_t heap_allocs = 0;
+	std::size_t reuses = 0;
+};
+
+/**
+ * @brief Time, position and velocity arrays of a trajectory
+ *
+ * All three live in one block. The capacity only grows, so reusing a
+ * buffer for runs of the same or a smaller size doesn't allocate. Without
+ * an arena the memory comes straight from the heap.
+ */
+class TrajectoryBuffer {
+
+public:
+	explicit TrajectoryBuffer(TrajectoryArena *arena = nullptr);
+	TrajectoryBuffer(const TrajectoryBuffer &other);
+	TrajectoryBuffer &operator=(const TrajectoryBuffer &other);
+
+	~TrajectoryBuffer();
+
+	int get_capacity() const;
+	TrajectoryArena *get_arena() const;
+	double *get_time_arr() const;
+	Vec3 *get_pos_arr() const;
+	Vec3 *get_vel_arr() const;
+
+	void reserve(int capacity);
+	void set_arena(TrajectoryArena *arena);
+	void swap(TrajectoryBuffer &other);
+
+private:
+	static std::size_t bytes_for(int capacity);
+	void *allocate(int capacity) const;
+	void release();
+
+	TrajectoryArena *arena;	// not owned, may be null
+	int capacity;
+	void *block;
+	double *time_arr;	// [s]
+	Vec3 *pos_arr;	// [km]
+	Vec3 *vel_arr;	// [km/s]
+};
+
+} // namespace orbsim
+
+
+#endif	// TRAJECTORY_BUFFER_HPP
@@ -0,0 +1,302 @@
+#include "trajectory_file.hpp"
+
+#include "celestial_obj.hpp"
+#include "math_obj.hpp"
+#include "trajectory_sink.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace orbsim {
+
+namespace {
+
+const char magic[8] = {'O', 'R', 'B', 'T', 'R', 'A', 'J', '\0'};
+const std::size_t header_size = 128;
+const std::size_t name_size = 64;
+const int columns = 7;
+
+bool little_endian() {
+	std::uint16_t one = 1;
+	unsigned char first;
+	std::memcpy(&first, &one, 1);
+	return first == 1;
+}
+
+template <typename T>
+void put(unsigned char *buf, std::size_t offset, T value) {
+	std::memcpy(buf + offset, &value, sizeof(T));
+}
+
+template <typename T>
+T get(const unsigned char *buf, std::size_t offset) {
+	T value;
+	std::memcpy(&value, buf + offset, sizeof(T));
+	return value;
+}
+
+} // namespace
+
+TrajectoryWriter::TrajectoryWriter(const std::string &filename, std::string integ_name,
+								   CelestialObj cel_obj, double epoch)
+	: filename(filename), file(filename, std::ios::binary),
+	  header{std::move(integ_name), cel_obj, epoch, 0} {
+
+	if (!little_endian()) {
+		throw std::runtime_error("Binary trajectory files are only supported on little-endian machines!");
+	}
+	if (!this->file) {
+		throw std::runtime_error("Could not open " + filename + " for writing!");
+	}
+	if (this->header.integ_name.size() >= name_size) {
+		throw std::domain_error("Integrator name is too long!");
+	}
+}
+
+void TrajectoryWriter::begin(int steps) {
+	this->header.steps = steps;
+
+	unsigned char buf[header_size] = {};
+	std::memcpy(buf, magic, sizeof(magic));
+	put<std::uint32_t>(buf, 8, trajectory_file_version);
+	put<std::uint32_t>(buf, 12, header_size);
+	put<std::uint64_t>(buf, 16, steps);
+	put<double>(buf, 24, this->header.epoch);
+	put<double>(buf, 32, this->header.cel_obj.mass);
+	put<double>(buf, 40, this->header.cel_obj.radius);
+	std::memcpy(buf + 48, this->header.integ_name.c_str(), this->header.integ_name.size());
+
+	this->file.seekp(0);
+	this->file.write(reinterpret_cast<const char *>(buf), header_size);
+
+	// Give the file its full size up front, the columns are filled in later
+	std::size_t total = header_size + columns * sizeof(double) * (std::size_t) steps;
+	if (total > header_size) {
+		this->file.seekp(total - 1);
+		this->file.put('\0');
+	}
+}
+
+void TrajectoryWriter::consume(const TrajectoryBlock &block) {
+	if (block.first + block.count > this->header.steps) {
+		throw std::out_of_range("Block is outside of the trajectory!");
+	}
+
+	// Write each column through a small buffer
+	const int chunk = 512;
+	double buf[chunk];
+	for (int col = 0; col < columns; col++) {
+		std::size_t offset = header_size + (col * (std::size_t) this->header.steps + block.first) * sizeof(double);
+		this->file.seekp(offset);
+
+		for (int start = 0; start < block.count; start += chunk) {
+			int n = std::min(chunk, block.count - start);
+			for (int i = 0; i < n; i++) {
+				const Vec3 &pos = block.pos_arr[start + i];
+				const Vec3 &vel = block.vel_arr[start + i];
+				switch (col) {
+				case 0: buf[i] = block.time_arr[start + i]; break;
+				case 1: buf[i] = pos.x; break;
+				case 2: buf[i] = pos.y; break;
+				case 3: buf[i] = pos.z; break;
+				case 4: buf[i] = vel.x; break;
+				case 5: buf[i] = vel.y; break;
+				case 6: buf[i] = vel.z; break;
+				}
+			}
+			this->file.write(reinterpret_cast<const char *>(buf), n * sizeof(double));
+		}
+	}
+}
+
+void TrajectoryWriter::end(int count) {
+	this->file.flush();
+	if (!this->file) {
+		throw std::runtime_error("Could not write " + this->filename + "!");
+	}
+	if (count >= this->header.steps) return;
+
+	// Every column but the first moves towards the start, in place
+	this->file.close();
+	std::fstream file(this->filename, std::ios::binary | std::ios::in | std::ios::out);
+	const int chunk = 512;
+	double buf[chunk];
+	for (int col = 1; col < columns; col++) {
+		std::size_t from = header_size + col * (std::size_t) this->header.steps * sizeof(double);
+		std::size_t to = header_size + col * (std::size_t) count * sizeof(double);
+		for (int start = 0; start < count; start += chunk) {
+			int n = std::min(chunk, count - start);
+			file.seekg(from + start * sizeof(double));
+			file.read(reinterpret_cast<char *>(buf), n * sizeof(double));
+			file.seekp(to + start * sizeof(double));
+			file.write(reinterpret_cast<const char *>(buf), n * sizeof(double));
+		}
+	}
+	std::uint64_t steps = count;
+	file.seekp(16);
+	file.write(reinterpret_cast<const char *>(&steps), sizeof(steps));
+	file.close();
+	if (!file) {
+		throw std::runtime_error("Could not write " + this->filename + "!");
+	}
+
+	std::error_code error;
+	std::filesystem::resize_file(this->filename, header_size + columns * sizeof(double) * (std::size_t) count, error);
+	if (error) {
+		throw std::runtime_error("Could not write " + this->filename + "!");
+	}
+	this->header.steps = count;
+
+	// Open again for the next run
+	this->file.open(this->filename, std::ios::binary | std::ios::in | std::ios::out);
+}
+
+void write_trajectory(const std::string &filename, const TrajectoryHeader &header,
+					  const double *time_arr, const Vec3 *pos_arr, const Vec3 *vel_arr) {
+	TrajectoryWriter writer(filename, header.integ_name, header.cel_obj, header.epoch);
+	writer.begin(header.steps);
+	writer.consume(TrajectoryBlock{0, (int) header.steps, time_arr, pos_arr, vel_arr});
+	writer.end(header.steps);
+}
+
+TrajectoryReader::TrajectoryReader(const std::string &filename)
+	: data(nullptr), length(0) {
+
+#ifdef _WIN32
+	this->mapping_handle = nullptr;
+	this->file_handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+									OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (this->file_handle == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("Could not open " + filename + "!");
+	}
+	LARGE_INTEGER file_size;
+	GetFileSizeEx(this->file_handle, &file_size);
+	this->length = (std::size_t) file_size.QuadPart;
+
+	if (this->length >= header_size) {
+		this->mapping_handle = CreateFileMappingA(this->file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (this->mapping_handle != nullptr) {
+			this->data = static_cast<const unsigned char *>(
+				MapViewOfFile(this->mapping_handle, FILE_MAP_READ, 0, 0, 0));
+		}
+		if (this->data == nullptr) {
+			unmap();
+			throw std::runtime_error("Could not map " + filename + "!");
+		}
+	}
+#else
+	this->fd = open(filename.c_str(), O_RDONLY);
+	if (this->fd < 0) {
+		throw std::runtime_error("Could not open " + filename + "!");
+	}
+	struct stat st;
+	fstat(this->fd, &st);
+	this->length = (std::size_t) st.st_size;
+
+	if (this->length >= header_size) {
+		void *addr = mmap(nullptr, this->length, PROT_READ, MAP_SHARED, this->fd, 0);
+		if (addr == MAP_FAILED) {
+			unmap();
+			throw std::runtime_error("Could not map " + filename + "!");
+		}
+		this->data = static_cast<const unsigned char *>(addr);
+	}
+#endif
+
+	if (this->length < header_size || std::memcmp(this->data, magic, sizeof(magic)) != 0) {
+		unmap();
+		throw std::runtime_error(filename + " is not a trajectory file!");
+	}
+	if (get<std::uint32_t>(this->data, 8) != trajectory_file_version) {
+		unmap();
+		throw std::runtime_error(filename + " has an unsupported trajectory file version!");
+	}
+
+	// Checked against the file size without multiplying, a corrupt count
+	// could overflow
+	std::uint64_t steps = get<std::uint64_t>(this->data, 16);
+	std::size_t columns_offset = get<std::uint32_t>(this->data, 12);
+	if (columns_offset != header_size ||
+		steps > (std::uint64_t) std::numeric_limits<std::int64_t>::max() ||
+		steps > (this->length - header_size) / (columns * sizeof(double))) {
+		unmap();
+		throw std::runtime_error(filename + " is truncated!");
+	}
+
+	this->header.steps = (std::int64_t) steps;
+	this->header.epoch = get<double>(this->data, 24);
+	this->header.cel_obj.mass = get<double>(this->data, 32);
+	this->header.cel_obj.radius = get<double>(this->data, 40);
+	const char *name = reinterpret_cast<const char *>(this->data + 48);
+	this->header.integ_name = std::string(name, strnlen(name, name_size));
+}
+
+TrajectoryReader::~TrajectoryReader() {
+	unmap();
+}
+
+void TrajectoryReader::unmap() {
+#ifdef _WIN32
+	if (this->data != nullptr) UnmapViewOfFile(this->data);
+	if (this->mapping_handle != nullptr) CloseHandle(this->mapping_handle);
+	if (this->file_handle != INVALID_HANDLE_VALUE) CloseHandle(this->file_handle);
+	this->mapping_handle = nullptr;
+	this->file_handle = INVALID_HANDLE_VALUE;
+#else
+	if (this->data != nullptr) munmap(const_cast<unsigned char *>(this->data), this->length);
+	if (this->fd >= 0) close(this->fd);
+	this->fd = -1;
+#endif
+	this->data = nullptr;
+}
+
+const TrajectoryHeader &TrajectoryReader::get_header() const { return this->header; }
+std::int64_t TrajectoryReader::size() const { return this->header.steps; }
+
+const double *TrajectoryReader::column(TrajectoryColumn col) const {
+	std::size_t offset = header_size + (std::size_t) col * sizeof(double) * (std::size_t) this->header.steps;
+	return reinterpret_cast<const double *>(this->data + offset);
+}
+
+double TrajectoryReader::time_at(std::int64_t idx) const {
+	return column(TrajectoryColumn::Time)[idx];
+}
+
+Vec3 TrajectoryReader::pos_at(std::int64_t idx) const {
+	return Vec3{
+		column(TrajectoryColumn::PosX)[idx],
+		column(TrajectoryColumn::PosY)[idx],
+		column(TrajectoryColumn::PosZ)[idx]
+	};
+}
+
+Vec3 TrajectoryReader::vel_at(std::int64_t idx) const {
+	return Vec3{
+		column(TrajectoryColumn::VelX)[idx],
+		column(TrajectoryColumn::VelY)[idx],
+		column(TrajectoryColumn::VelZ)[idx]
+	};
+}
+
+} // namespace orbsim
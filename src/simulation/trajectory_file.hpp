@@ -0,0 +1,115 @@
+#ifndef TRAJECTORY_FILE_HPP
+#define TRAJECTORY_FILE_HPP
+
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/trajectory_sink.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+
+namespace orbsim {
+
+/*
+ * Binary trajectory file, version 1. All values are little-endian.
+ *
+ *     offset  size
+ *          0     8  magic "ORBTRAJ\0"
+ *          8     4  uint32 version
+ *         12     4  uint32 header size (128)
+ *         16     8  uint64 number of samples N
+ *         24     8  float64 epoch of the first sample [s]
+ *         32     8  float64 central body mass [kg]
+ *         40     8  float64 central body radius [km]
+ *         48    64  integrator name, zero padded
+ *        112    16  reserved, zero
+ *        128  56*N  columns of N float64 each: t, x, y, z, vx, vy, vz
+ *
+ * Every column is contiguous, so a reader can use one coordinate over the
+ * whole trajectory without touching the others.
+ */
+const std::uint32_t trajectory_file_version = 1;
+
+struct TrajectoryHeader {
+	std::string integ_name;
+	CelestialObj cel_obj;
+	double epoch;	// [s]
+	std::int64_t steps;
+};
+
+enum class TrajectoryColumn { Time, PosX, PosY, PosZ, VelX, VelY, VelZ };
+
+/**
+ * @brief Writes a binary trajectory file, also while integrating (as a sink)
+ *
+ * The number of samples comes from begin(), after that the blocks are
+ * written straight to their place in each column. If end() gets fewer
+ * samples, e.g. after a terminal event, the columns are moved together and
+ * the file is cut to that many.
+ */
+class TrajectoryWriter : public TrajectorySink {
+
+public:
+	TrajectoryWriter(const std::string &filename, std::string integ_name,
+					 CelestialObj cel_obj, double epoch = 0);
+
+	void begin(int steps) override;
+	void consume(const TrajectoryBlock &block) override;
+	void end(int count) override;
+
+private:
+	std::string filename;
+	std::ofstream file;
+	TrajectoryHeader header;
+};
+
+/**
+ * @brief Writes a whole trajectory kept in memory
+ */
+void write_trajectory(const std::string &filename, const TrajectoryHeader &header,
+					  const double *time_arr, const Vec3 *pos_arr, const Vec3 *vel_arr);
+
+/**
+ * @brief Memory-mapped view of a binary trajectory file
+ *
+ * Opening doesn't read the samples, the OS pages them in when they are
+ * accessed, so even huge files open instantly.
+ */
+class TrajectoryReader {
+
+public:
+	explicit TrajectoryReader(const std::string &filename);
+	TrajectoryReader(const TrajectoryReader &other) = delete;
+	TrajectoryReader &operator=(const TrajectoryReader &other) = delete;
+
+	~TrajectoryReader();
+
+	const TrajectoryHeader &get_header() const;
+	std::int64_t size() const;
+
+	const double *column(TrajectoryColumn col) const;
+	double time_at(std::int64_t idx) const;
+	Vec3 pos_at(std::int64_t idx) const;
+	Vec3 vel_at(std::int64_t idx) const;
+
+private:
+	void unmap();
+
+	TrajectoryHeader header;
+	const unsigned char *data;
+	std::size_t length;
+#ifdef _WIN32
+	void *file_handle;
+	void *mapping_handle;
+#else
+	int fd;
+#endif
+};
+
+} // namespace orbsim
+
+
+#endif	// TRAJECTORY_FILE_HPP
@@ -0,0 +1,90 @@
+#include "trajectory_sink.hpp"
+
+#include "math_obj.hpp"
+
+#include <fstream>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+namespace orbsim {
+
+CallbackSink::CallbackSink(std::function<void(const TrajectoryBlock &)> callback)
+	: callback(std::move(callback)) {}
+
+void CallbackSink::consume(const TrajectoryBlock &block) {
+	this->callback(block);
+}
+
+RingBufferSink::RingBufferSink(int capacity)
+	: capacity(capacity), total(0) {
+
+	if (capacity <= 0) {
+		throw std::domain_error("Capacity must be a positive integer!");
+	}
+	this->time_arr.resize(capacity);
+	this->pos_arr.resize(capacity);
+	this->vel_arr.resize(capacity);
+}
+
+int RingBufferSink::get_capacity() const { return this->capacity; }
+int RingBufferSink::size() const { return this->total < this->capacity ? this->total : this->capacity; }
+int RingBufferSink::get_total() const { return this->total; }
+
+double RingBufferSink::time_at(int idx) const { return this->time_arr[index(idx)]; }
+Vec3 RingBufferSink::pos_at(int idx) const { return this->pos_arr[index(idx)]; }
+Vec3 RingBufferSink::vel_at(int idx) const { return this->vel_arr[index(idx)]; }
+
+int RingBufferSink::index(int idx) const {
+	if (idx < 0 || idx >= size()) {
+		throw std::out_of_range("Sample is not in the ring buffer!");
+	}
+	return (this->total - size() + idx) % this->capacity;
+}
+
+void RingBufferSink::begin(int) {
+	this->total = 0;
+}
+
+void RingBufferSink::consume(const TrajectoryBlock &block) {
+	for (int i = 0; i < block.count; i++) {
+		int slot = this->total % this->capacity;
+		this->time_arr[slot] = block.time_arr[i];
+		this->pos_arr[slot] = block.pos_arr[i];
+		this->vel_arr[slot] = block.vel_arr[i];
+		this->total++;
+	}
+}
+
+StreamSink::StreamSink(std::ostream &os) : os(os) {}
+
+void StreamSink::consume(const TrajectoryBlock &block) {
+	for (int i = 0; i < block.count; i++) {
+		this->os << block.pos_arr[i].to_str() << " " << block.vel_arr[i].to_str() << "\n";
+	}
+}
+
+void StreamSink::end(int) {
+	this->os.flush();
+}
+
+FileSink::FileSink(const std::string &filename)
+	: file(filename), stream(this->file) {
+
+	if (!this->file) {
+		throw std::runtime_error("Could not open " + filename + " for writing!");
+	}
+}
+
+void FileSink::consume(const TrajectoryBlock &block) {
+	this->stream.consume(block);
+}
+
+void FileSink::end(int count) {
+	this->stream.end(count);
+}
+
+} // namespace orbsim
@@ -0,0 +1,124 @@
+#ifndef TRAJECTORY_SINK_HPP
+#define TRAJECTORY_SINK_HPP
+
+#include "simulation/math_obj.hpp"
+
+#include <fstream>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace orbsim {
+
+/**
+ * @brief Consecutive samples of a trajectory, only valid during the call
+ */
+struct TrajectoryBlock {
+	int first;	// index of the first sample in the whole trajectory
+	int count;
+	const double *time_arr;	// [s]
+	const Vec3 *pos_arr;	// [km]
+	const Vec3 *vel_arr;	// [km/s]
+	const Mat6 *stm_arr = nullptr;	// only with the state transition matrix
+};
+
+/**
+ * @brief Receives the samples of an integration while it is running
+ *
+ * An integrator with a sink only keeps a small window of samples in memory
+ * and hands it over every time it fills up (see Integrator::set_sink()).
+ * begin() gets the number of samples on the grid, end() the number that
+ * were handed over, which is smaller when a terminal event stopped the
+ * integration.
+ */
+class TrajectorySink {
+
+public:
+	virtual ~TrajectorySink() = default;
+
+	virtual void begin(int /* steps */) {}
+	virtual void consume(const TrajectoryBlock &block) = 0;
+	virtual void end(int /* count */) {}
+};
+
+/**
+ * @brief Calls a function for every block
+ */
+class CallbackSink : public TrajectorySink {
+
+public:
+	explicit CallbackSink(std::function<void(const TrajectoryBlock &)> callback);
+
+	void consume(const TrajectoryBlock &block) override;
+
+private:
+	std::function<void(const TrajectoryBlock &)> callback;
+};
+
+/**
+ * @brief Keeps only the latest samples
+ */
+class RingBufferSink : public TrajectorySink {
+
+public:
+	explicit RingBufferSink(int capacity);
+
+	int get_capacity() const;
+	int size() const;
+	int get_total() const;
+
+	// 0 is the oldest sample still kept, size() - 1 the latest one
+	double time_at(int idx) const;
+	Vec3 pos_at(int idx) const;
+	Vec3 vel_at(int idx) const;
+
+	void begin(int steps) override;
+	void consume(const TrajectoryBlock &block) override;
+
+private:
+	int index(int idx) const;
+
+	int capacity;
+	int total;	// samples received since begin()
+	std::vector<double> time_arr;
+	std::vector<Vec3> pos_arr;
+	std::vector<Vec3> vel_arr;
+};
+
+/**
+ * @brief Writes every sample as a line of text, in the format of Integrator::save_to_file()
+ */
+class StreamSink : public TrajectorySink {
+
+public:
+	explicit StreamSink(std::ostream &os);
+
+	void consume(const TrajectoryBlock &block) override;
+	void end(int count) override;
+
+private:
+	std::ostream &os;
+};
+
+/**
+ * @brief StreamSink writing to a file
+ */
+class FileSink : public TrajectorySink {
+
+public:
+	explicit FileSink(const std::string &filename);
+
+	void consume(const TrajectoryBlock &block) override;
+	void end(int count) override;
+
+private:
+	std::ofstream file;
+	StreamSink stream;
+};
+
+} // namespace orbsim
+
+
+#endif	// TRAJECTORY_SINK_HPP
@@ -0,0 +1,114 @@
+#include "simulation/conjunction.hpp"
+#include "simulation/satellite.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+TEST(ConjunctionTest, Constructor) {
+	using namespace orbsim;
+
+	ConjunctionScreen screen(5, 2);
+
+	EXPECT_DOUBLE_EQ(screen.get_threshold(), 5);
+	EXPECT_EQ(screen.get_threads(), 2);
+	EXPECT_THROW(ConjunctionScreen(0), std::domain_error);
+}
+
+TEST(ConjunctionTest, CrossingOrbits) {
+	using namespace orbsim;
+
+	// An equatorial and a polar orbit both reach the x axis at t = 1000 s,
+	// 2 km apart, the third object is far away
+	double a = 7000;
+	double n = std::sqrt(G * Earth.mass / 1e9 / (a * a * a));
+	double anom = -n * 1000;
+	std::vector<Satellite> sats{
+		Satellite(KeplElem{0, a, 0, 0, 0, anom}, "Kepler", Earth, 0, 3000, 301),
+		Satellite(KeplElem{0, a + 2, PI / 2, 0, 0, -std::sqrt(G * Earth.mass / 1e9 / std::pow(a + 2, 3)) * 1000},
+				  "Kepler", Earth, 0, 3000, 301),
+		Satellite(KeplElem{0, 42164, 0, PI, 0, 0}, "Kepler", Earth, 0, 3000, 301),
+	};
+	std::vector<SimData> trajectories;
+	for (Satellite &sat : sats) trajectories.push_back(sat.propagate());
+
+	ConjunctionScreen screen(5);
+	std::vector<Conjunction> conjunctions = screen.screen(trajectories);
+
+	ASSERT_EQ(conjunctions.size(), 1u);
+	EXPECT_EQ(conjunctions[0].first, 0u);
+	EXPECT_EQ(conjunctions[0].second, 1u);
+	EXPECT_NEAR(conjunctions[0].tca, 1000, 0.1);
+	EXPECT_NEAR(conjunctions[0].miss_distance, 2, 0.01);
+
+	// Nothing that close with a smaller threshold
+	EXPECT_TRUE(ConjunctionScreen(1).screen(trajectories).empty());
+}
+
+TEST(ConjunctionTest, MatchesAllPairs) {
+	using namespace orbsim;
+
+	// Crowded shell of 150 objects, compared with every pair at every sample
+	std::mt19937 gen(3);
+	std::uniform_real_distribution<double> angle(0, 2 * PI);
+	std::uniform_real_distribution<double> alt(700, 720);
+	std::vector<Satellite> sats;
+	for (int i = 0; i < 150; i++) {
+		sats.emplace_back(KeplElem{0, Earth.radius + alt(gen), angle(gen) / 2, angle(gen), 0, angle(gen)},
+						  "Kepler", Earth, 0, 6000, 601);
+	}
+	std::vector<SimData> trajectories;
+	for (Satellite &sat : sats) trajectories.push_back(sat.propagate());
+
+	double threshold = 50;
+	std::vector<Conjunction> conjunctions = ConjunctionScreen(threshold, 4).screen(trajectories);
+	EXPECT_FALSE(conjunctions.empty());
+
+	for (std::size_t i = 0; i < trajectories.size(); i++) {
+		for (std::size_t j = i + 1; j < trajectories.size(); j++) {
+			double closest = 1e300;
+			for (int k = 0; k < 601; k++) {
+				closest = std::min(closest, (trajectories[i].get_pos_arr()[k] - trajectories[j].get_pos_arr()[k]).len());
+			}
+			if (closest >= threshold) continue;
+
+			// Every pair that came that close at a sample is found, at least as close
+			double best = 1e300;
+			for (const Conjunction &c : conjunctions) {
+				if (c.first == i && c.second == j) best = std::min(best, c.miss_distance);
+			}
+			EXPECT_LE(best, closest + 1e-9) << i << " " << j;
+		}
+	}
+}
+
+TEST(ConjunctionTest, DifferentSteps) {
+	using namespace orbsim;
+
+	Satellite first(CartElem{Vec3{7000, 0, 0}, Vec3{0, 7.5, 0}}, "Kepler", Earth, 0, 1000, 101);
+	Satellite second(CartElem{Vec3{7000, 0, 0}, Vec3{0, 7.5, 0}}, "Kepler", Earth, 0, 1000, 51);
+	std::vector<SimData> trajectories{first.propagate(), second.propagate()};
+
+	EXPECT_THROW(ConjunctionScreen(5).screen(trajectories), std::domain_error);
+}
+
+TEST(ConjunctionTest, DifferentTimes) {
+	using namespace orbsim;
+
+	// Same number of steps over different time spans
+	Satellite first(CartElem{Vec3{7000, 0, 0}, Vec3{0, 7.5, 0}}, "Kepler", Earth, 0, 1000, 101);
+	Satellite second(CartElem{Vec3{7000, 0, 0}, Vec3{0, 7.5, 0}}, "Kepler", Earth, 0, 2000, 101);
+	Satellite third(CartElem{Vec3{7000, 0, 0}, Vec3{0, 7.5, 0}}, "Kepler", Earth, 0, 1000, 101);
+	std::vector<SimData> trajectories{first.propagate(), second.propagate()};
+	EXPECT_THROW(ConjunctionScreen(5).screen(trajectories), std::domain_error);
+
+	trajectories[1] = third.propagate();
+	EXPECT_NO_THROW(ConjunctionScreen(5).screen(trajectories));
+}
@@ -0,0 +1,68 @@
+#include "simulation/constellation.hpp"
+#include "simulation/satellite.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <string>
+
+
+TEST(ConstellationTest, Constructor) {
+	using namespace orbsim;
+
+	Constellation constel("Verlet", Earth, 0, 1000, 100);
+
+	EXPECT_EQ(constel.size(), 0);
+	EXPECT_EQ(constel.get_integ_name(), "Verlet");
+	EXPECT_EQ(constel.get_t_steps(), 100);
+	EXPECT_THROW(Constellation("Leapfrog"), std::domain_error);
+	EXPECT_THROW(Constellation("RK4", Earth, 100, 10, 100), std::domain_error);
+	EXPECT_THROW(Constellation("RK4", Earth, 0, 1000, 0), std::domain_error);
+}
+
+TEST(ConstellationTest, AddSatellite) {
+	using namespace orbsim;
+
+	Constellation constel;
+	constel.add_sat(CartElem{Vec3{7000, 0, 0}, Vec3{0, 5.1, 7.3}});
+	constel.add_sat(CartElem{Vec3{0, 7100, 1300}, Vec3{-7.35, 0, 1}});
+
+	EXPECT_EQ(constel.size(), 2);
+	EXPECT_EQ(constel.get_cart_elem(0).pos, (Vec3{7000, 0, 0}));
+	EXPECT_EQ(constel.get_cart_elem(0).vel, (Vec3{0, 5.1, 7.3}));
+	EXPECT_EQ(constel.get_cart_elem(1).pos, (Vec3{0, 7100, 1300}));
+	EXPECT_EQ(constel.get_cart_elem(1).vel, (Vec3{-7.35, 0, 1}));
+}
+
+TEST(ConstellationTest, MatchesSatellite) {
+	using namespace orbsim;
+
+	CartElem cart_elems[] = {
+		{Vec3{7000, 0, 0}, Vec3{0, 5.1, 7.3}},
+		{Vec3{7100, 0, 1300}, Vec3{0, 7.35, 1}},
+		{Vec3{-6800, 2000, 0}, Vec3{-1.5, -7.2, 0.4}},
+	};
+
+	for (std::string integ_name : {"Euler", "Verlet", "RK4"}) {
+		Constellation constel(integ_name, Earth, 0, 6000, 601);
+		for (CartElem cart_elem : cart_elems) {
+			constel.add_sat(cart_elem);
+		}
+
+		int steps_seen = 0;
+		constel.propagate([&](int, const Constellation &) { steps_seen++; });
+		EXPECT_EQ(steps_seen, 601);
+
+		for (std::size_t i = 0; i < constel.size(); i++) {
+			Satellite sat(cart_elems[i], integ_name, Earth, 0, 6000, 601);
+			SimData sim_data = sat.propagate();
+
+			Vec3 pos_diff = constel.get_cart_elem(i).pos - sim_data.get_pos_arr()[600];
+			Vec3 vel_diff = constel.get_cart_elem(i).vel - sim_data.get_vel_arr()[600];
+			EXPECT_LT(pos_diff.len(), 1e-6) << integ_name;
+			EXPECT_LT(vel_diff.len(), 1e-9) << integ_name;
+		}
+	}
+}
@@ -0,0 +1,129 @@
+#include "simulation/events.hpp"
+#include "simulation/satellite.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+TEST(EventsTest, Apsides) {
+	using namespace orbsim;
+
+	// Starts at periapsis, which isn't an event because the radial velocity is zero there
+	double mu = G * Earth.mass / 1e9;
+	double a = 1 / (2 / 7000.0 - 8.0 * 8.0 / mu);
+	double period = 2 * PI * std::sqrt(a * a * a / mu);
+
+	EventDetector detector({periapsis_event(), apoapsis_event()});
+	Satellite sat(CartElem{Vec3{7000, 0, 0}, Vec3{0, 8, 0}}, "RK87", Earth, 0, 86400, 1441);
+	sat.set_events(&detector);
+	SimData sim_data = sat.propagate();
+	EXPECT_EQ(sim_data.get_steps(), 1441);
+
+	// The interpolant of the 60 s steps is good to a few hundredths of a second
+	std::vector<Event> periapses = detector.get_events("Periapsis");
+	std::vector<Event> apoapses = detector.get_events("Apoapsis");
+	ASSERT_EQ(periapses.size(), (std::size_t) std::floor(86400 / period));
+	ASSERT_EQ(apoapses.size(), (std::size_t) std::floor(86400 / period + 0.5));
+	for (std::size_t k = 0; k < periapses.size(); k++) {
+		EXPECT_NEAR(periapses[k].t, (k + 1) * period, 5e-2);
+		EXPECT_NEAR(periapses[k].pos.len(), 7000, 1e-3);
+	}
+	for (std::size_t k = 0; k < apoapses.size(); k++) {
+		EXPECT_NEAR(apoapses[k].t, (k + 0.5) * period, 5e-2);
+		EXPECT_NEAR(apoapses[k].pos.len(), 2 * a - 7000, 1e-3);
+	}
+
+	// In time order
+	const std::vector<Event> &events = detector.get_events();
+	for (std::size_t i = 1; i < events.size(); i++) {
+		EXPECT_LT(events[i - 1].t, events[i].t);
+	}
+}
+
+TEST(EventsTest, Nodes) {
+	using namespace orbsim;
+
+	EventDetector detector;
+	detector.add(ascending_node_event());
+	detector.add(descending_node_event());
+	Satellite sat(CartElem{Vec3{7000, 0, 100}, Vec3{0, 5.1, 5.3}}, "DOPRI5", Earth, 0, 30000, 301);
+	sat.set_events(&detector);
+	sat.propagate();
+
+	// Alternating, on the equator
+	const std::vector<Event> &events = detector.get_events();
+	ASSERT_GE(events.size(), 6u);
+	for (std::size_t i = 0; i < events.size(); i++) {
+		EXPECT_EQ(events[i].function, i % 2 == 0 ? 1u : 0u);
+		EXPECT_NEAR(events[i].pos.z, 0, 1e-6);
+	}
+	EXPECT_LT(events[0].vel.z, 0);
+	EXPECT_GT(events[1].vel.z, 0);
+	EXPECT_FALSE(detector.get_stopped());
+}
+
+TEST(EventsTest, TerminalImpact) {
+	using namespace orbsim;
+
+	// Too slow to stay in orbit from 200 km up
+	CartElem initial{Vec3{Earth.radius + 200, 0, 0}, Vec3{0, 6, 0}};
+
+	EventDetector reference({impact_event()});
+	Satellite kepler(initial, "Kepler", Earth, 0, 3000, 3001);
+	kepler.set_events(&reference);
+	SimData kepler_data = kepler.propagate();
+	ASSERT_TRUE(reference.get_stopped());
+	double t_impact = reference.get_events().back().t;
+	EXPECT_LT(kepler_data.get_steps(), 3001);
+	EXPECT_DOUBLE_EQ(kepler_data.get_t_end(), t_impact);
+
+	for (std::string integ_name : {"Verlet", "RK4", "DOPRI5", "RK87", "GaussJackson", "Yoshida4"}) {
+		EventDetector detector({apoapsis_event(), impact_event()});
+		Satellite sat(initial, integ_name, Earth, 0, 3000, 3001);
+		sat.set_events(&detector);
+		SimData sim_data = sat.propagate();
+
+		ASSERT_TRUE(detector.get_stopped()) << integ_name;
+		const Event &impact = detector.get_events().back();
+		EXPECT_EQ(detector.get_function(impact.function).name, "Impact");
+		EXPECT_NEAR(impact.t, t_impact, 0.1) << integ_name;
+
+		// The trajectory ends at the surface and no steps are taken after it
+		int steps = sim_data.get_steps();
+		EXPECT_EQ(steps, (int) std::ceil(impact.t) + 1) << integ_name;
+		EXPECT_DOUBLE_EQ(sim_data.get_t_end(), impact.t);
+		EXPECT_NEAR(sim_data.get_pos_arr()[steps - 1].len(), Earth.radius, 1e-6);
+		EXPECT_NO_THROW(sim_data.state_at(impact.t - 0.5));
+	}
+}
+
+TEST(EventsTest, OnlyTerminalWithEvents) {
+	using namespace orbsim;
+
+	CartElem initial{Vec3{Earth.radius + 200, 0, 0}, Vec3{0, 6, 0}};
+	EventDetector detector({impact_event()});
+	Satellite sat(initial, "RK4", Earth, 0, 3000, 3001);
+	sat.set_events(&detector);
+	int steps = sat.propagate().get_steps();
+
+	// Without the events the whole time span is integrated, through the planet
+	sat.set_events(nullptr);
+	EXPECT_EQ(sat.propagate().get_steps(), 3001);
+	EXPECT_LT(steps, 3001);
+}
+
+TEST(EventsTest, InvalidFunctions) {
+	using namespace orbsim;
+
+	EventDetector detector;
+	EXPECT_THROW(detector.add(EventFunction{"Empty", nullptr, 0, false}), std::domain_error);
+	EXPECT_THROW(altitude_event(100, Earth, 2), std::domain_error);
+	EXPECT_EQ(detector.size(), 0u);
+}
@@ -0,0 +1,73 @@
+#include "simulation/forces/atmosphere.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+TEST(AtmosphereTest, Exponential) {
+	using namespace orbsim;
+
+	Atmosphere atmosphere;
+	EXPECT_DOUBLE_EQ(atmosphere.get_min_altitude(), 0);
+	EXPECT_DOUBLE_EQ(atmosphere.get_max_altitude(), 1500);
+
+	// Band bottoms and inside a band, where the model is exact
+	EXPECT_NEAR(atmosphere.density(0), 1.225, 1e-12);
+	EXPECT_NEAR(atmosphere.density(300), 2.418e-11, 1e-22);
+	double expected = 2.418e-11 * std::exp(-37.3 / 53.628);
+	EXPECT_NEAR(atmosphere.density(337.3), expected, 1e-9 * expected);
+
+	// Continuous, decreasing and none above the table
+	for (double h = 0.5; h < 1500; h += 7.3) {
+		EXPECT_LT(atmosphere.density(h + 1), atmosphere.density(h));
+	}
+	EXPECT_EQ(atmosphere.density(1500), 0);
+	EXPECT_EQ(atmosphere.density(-10), atmosphere.density(0));
+
+	// A coarse table is just as exact
+	Atmosphere coarse(5);
+	EXPECT_NEAR(coarse.density(337.3), expected, 1e-9 * expected);
+	EXPECT_NE(coarse.get_hash(), atmosphere.get_hash());
+}
+
+TEST(AtmosphereTest, Tabulated) {
+	using namespace orbsim;
+
+	Atmosphere atmosphere({200, 300, 400}, {1e-10, 1e-11, 4e-12}, 0.5);
+	EXPECT_DOUBLE_EQ(atmosphere.get_max_altitude(), 400);
+
+	// Exponential between the points
+	EXPECT_NEAR(atmosphere.density(200), 1e-10, 1e-22);
+	EXPECT_NEAR(atmosphere.density(250), std::sqrt(1e-10 * 1e-11), 1e-12 * 1e-10);
+	EXPECT_NEAR(atmosphere.density(350), std::sqrt(1e-11 * 4e-12), 1e-12 * 1e-11);
+	EXPECT_EQ(atmosphere.density(401), 0);
+
+	EXPECT_THROW(Atmosphere(std::vector<double>{200}, {1e-10}), std::domain_error);
+	EXPECT_THROW(Atmosphere({200, 100}, {1e-10, 1e-11}), std::domain_error);
+	EXPECT_THROW(Atmosphere({200, 300}, {1e-10, 0}), std::domain_error);
+	EXPECT_THROW(Atmosphere({200, 300}, {1e-10, 1e-11}, 0), std::domain_error);
+}
+
+TEST(AtmosphereTest, File) {
+	using namespace orbsim;
+
+	std::string filename = testing::TempDir() + "atmosphere_test.txt";
+	{
+		std::ofstream file(filename);
+		file << "# altitude [km] density [kg/m^3]\n200 1e-10\n300 1e-11\n400 4e-12\n";
+	}
+
+	Atmosphere from_file(filename, 0.5);
+	Atmosphere tabulated({200, 300, 400}, {1e-10, 1e-11, 4e-12}, 0.5);
+	EXPECT_EQ(from_file.get_hash(), tabulated.get_hash());
+	EXPECT_DOUBLE_EQ(from_file.density(333), tabulated.density(333));
+
+	std::remove(filename.c_str());
+	EXPECT_THROW(Atmosphere("/nonexistent/atmosphere.txt"), std::runtime_error);
+}
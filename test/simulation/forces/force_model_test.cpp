@@ -0,0 +1,141 @@
+#include "simulation/forces/force_model.hpp"
+#include "simulation/forces/atmosphere.hpp"
+#include "simulation/forces/geopotential.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/satellite.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+
+namespace {
+
+// J2 only field with the reference radius and GM of the central body
+std::string write_j2_field() {
+	std::string filename = testing::TempDir() + "force_model_j2.txt";
+	std::ofstream file(filename);
+	file << "0 0 1 0\n2 0 -4.84165371736e-4 0\n";
+	return filename;
+}
+
+} // namespace
+
+
+TEST(ForceModelTest, PointMassWithoutModels) {
+	using namespace orbsim;
+
+	ForceModelDE force_model;
+	Vec3 x{1.1, -0.2, 0.3};
+	EXPECT_EQ(force_model.accel(0, x, Vec3{0, 1, 0}), orbit_de.accel(0, x, Vec3{0, 1, 0}));
+	EXPECT_EQ(force_model.get_geopotential(), nullptr);
+}
+
+TEST(ForceModelTest, Geopotential) {
+	using namespace orbsim;
+
+	std::string filename = write_j2_field();
+	Geopotential point_mass(filename, 0, 0);
+	Geopotential j2(filename, 2, 0);
+
+	// Degree 0 is point-mass gravity, at any rotation of the frame
+	ForceModelDE force_model;
+	force_model.set_geopotential(&point_mass, 1e-3, 0.5);
+	Vec3 x{1.1, -0.2, 0.3};
+	Vec3 expected = orbit_de.accel(0, x, Vec3{0, 0, 0});
+	EXPECT_NEAR((force_model.accel(2.5, x, Vec3{0, 0, 0}) - expected).len(), 0, 1e-14);
+
+	// A zonal field doesn't care about the rotation either
+	ForceModelDE fixed, rotating;
+	fixed.set_geopotential(&j2, 0);
+	rotating.set_geopotential(&j2);
+	EXPECT_NEAR((fixed.accel(0, x, x) - rotating.accel(3, x, x)).len(), 0, 1e-14);
+	EXPECT_NE(fixed.hash(), rotating.hash());
+	EXPECT_NE(fixed.hash(), ForceModelDE().hash());
+
+	std::remove(filename.c_str());
+}
+
+TEST(ForceModelTest, J2NodalRegression) {
+	using namespace orbsim;
+
+	std::string filename = write_j2_field();
+	Geopotential j2(filename, 2, 0);
+	ForceModelDE force_model;
+	force_model.set_geopotential(&j2);
+
+	// Circular orbit at 51.6 deg for one day
+	double a = 7000;
+	double inc = 51.6 * PI / 180;
+	Satellite sat(KeplElem{0, a, inc, 0, 0, 0}, "DOPRI5", Earth, 0, 86400, 2);
+	sat.set_force_model(force_model);
+	SimData sim_data = sat.propagate();
+
+	Vec3 h = sim_data.get_pos_arr()[1].cross(sim_data.get_vel_arr()[1]);
+	double raan = std::atan2(h.x, -h.y);
+
+	// Secular rate -3/2 n J2 (R/a)^2 cos(i), the short periodic part is small
+	double mu = j2.get_gm();
+	double n = std::sqrt(mu / (a * a * a));
+	double J2 = 4.84165371736e-4 * std::sqrt(5.0);
+	double R = j2.get_ref_radius();
+	double expected = -1.5 * n * J2 * (R / a) * (R / a) * std::cos(inc) * 86400;
+	EXPECT_NEAR(raan, expected, 0.03 * std::fabs(expected));
+
+	// Without the field the plane doesn't move
+	Satellite two_body(KeplElem{0, a, inc, 0, 0, 0}, "DOPRI5", Earth, 0, 86400, 2);
+	sim_data = two_body.propagate();
+	h = sim_data.get_pos_arr()[1].cross(sim_data.get_vel_arr()[1]);
+	EXPECT_NEAR(std::atan2(h.x, -h.y), 0, 1e-8);
+
+	std::remove(filename.c_str());
+}
+
+TEST(ForceModelTest, DragDecay) {
+	using namespace orbsim;
+
+	Atmosphere atmosphere;
+	ForceModelDE force_model;
+	force_model.set_drag(&atmosphere, 0.01, 0);
+
+	// Circular orbit at 300 km for one day, the density barely changes
+	double a = Earth.radius + 300;
+	Satellite sat(KeplElem{0, a, 0, 0, 0, 0}, "RK4", Earth, 0, 86400, 86401);
+	sat.set_force_model(force_model);
+	SimData sim_data = sat.propagate();
+
+	// da/dt = -rho B sqrt(mu a), the energy gives the mean semi-major axis
+	double mu = G * Earth.mass / 1e9;
+	auto sma = [&](int i) {
+		double r = sim_data.get_pos_arr()[i].len();
+		double v = sim_data.get_vel_arr()[i].len();
+		return 1 / (2 / r - v * v / mu);
+	};
+	double expected = -atmosphere.density(300) * 0.01 * std::sqrt(mu * 1e9 * a * 1e3) * 86400 / 1e3;
+	EXPECT_NEAR(sma(86400) - sma(0), expected, 0.05 * std::fabs(expected));
+
+	// The drag of a rotating atmosphere is lower for a prograde orbit
+	ForceModelDE rotating;
+	rotating.set_drag(&atmosphere, 0.01);
+	Vec3 x{a / Earth.radius, 0, 0};
+	Vec3 v{0, 1, 0};
+	EXPECT_LT(rotating.accel(0, x, v).y, 0);
+	EXPECT_GT(rotating.accel(0, x, v).y, force_model.accel(0, x, v).y);
+	EXPECT_NE(rotating.hash(), force_model.hash());
+	EXPECT_THROW(force_model.set_drag(&atmosphere, -1), std::domain_error);
+}
+
+TEST(ForceModelTest, KeplerNeedsPointMass) {
+	using namespace orbsim;
+
+	Satellite sat(CartElem{Vec3{7000, 0, 0}, Vec3{0, 7.5, 0}}, "Kepler", Earth, 0, 86400, 100);
+	EXPECT_THROW(sat.set_force_model(ForceModelDE()), std::domain_error);
+	EXPECT_EQ(sat.get_integ_name(), "Kepler");
+	EXPECT_NO_THROW(sat.propagate());
+}
@@ -0,0 +1,162 @@
+#include "simulation/forces/geopotential.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+
+namespace {
+
+const double C20 = -4.84165371736e-4;	// EGM96, fully normalized
+const std::string C20_str = "-4.84165371736e-4";
+
+// Writes a coefficient file to the test directory and returns its path
+std::string write_coeffs(const std::string &name, const std::string &contents) {
+	std::string filename = testing::TempDir() + name;
+	std::ofstream file(filename);
+	file << contents;
+	return filename;
+}
+
+// Made up field of degree and order 8, with Kaula's rule magnitudes
+std::string kaula_field() {
+	std::ostringstream contents;
+	contents << std::setprecision(17) << "0 0 1 0\n";
+	for (int n = 1; n <= 8; n++) {
+		for (int m = 0; m <= n; m++) {
+			double c = 1e-5 / (n * n) * std::sin(3.0 * n + m);
+			double s = m == 0 ? 0 : 1e-5 / (n * n) * std::cos(5.0 * n - m);
+			contents << n << " " << m << " " << c << " " << s << "\n";
+		}
+	}
+	return contents.str();
+}
+
+} // namespace
+
+
+TEST(GeopotentialTest, PointMass) {
+	using namespace orbsim;
+
+	std::string filename = write_coeffs("point_mass.txt", "0 0 1 0\n");
+	Geopotential field(filename, 0, 0);
+
+	Vec3 r{7000, -1200, 3000};
+	Vec3 expected = - field.get_gm() * r / std::pow(r.len(), 3);
+	Vec3 a = field.accel(r);
+	EXPECT_NEAR((a - expected).len() / expected.len(), 0, 1e-14);
+	EXPECT_NEAR(field.potential(r), field.get_gm() / r.len(), 1e-12);
+
+	std::remove(filename.c_str());
+}
+
+TEST(GeopotentialTest, J2) {
+	using namespace orbsim;
+
+	std::string filename = write_coeffs("j2.txt", "0 0 1 0\n2 0 " + C20_str + " 0\n");
+	Geopotential field(filename, 2, 0);
+
+	// Closed form J2 acceleration
+	double mu = field.get_gm();
+	double R = field.get_ref_radius();
+	double J2 = -C20 * std::sqrt(5.0);
+	Vec3 r{5000, 4000, 3500};
+	double r2 = r.dot(r);
+	double k = -1.5 * J2 * mu * R * R / (r2 * r2 * std::sqrt(r2));
+	double z2 = 5 * r.z * r.z / r2;
+	Vec3 expected = - mu * r / (r2 * std::sqrt(r2))
+					+ k * Vec3{r.x * (1 - z2), r.y * (1 - z2), r.z * (3 - z2)};
+
+	EXPECT_NEAR((field.accel(r) - expected).len() / expected.len(), 0, 1e-9);
+
+	std::remove(filename.c_str());
+}
+
+TEST(GeopotentialTest, AccelerationIsGradientOfPotential) {
+	using namespace orbsim;
+
+	std::string filename = write_coeffs("kaula.txt", kaula_field());
+	Geopotential field(filename, 8, 8);
+
+	Vec3 r{-4100, 5300, 2900};
+	double h = 1e-3;
+	Vec3 grad{
+		(field.potential(r + Vec3{h, 0, 0}) - field.potential(r - Vec3{h, 0, 0})) / (2 * h),
+		(field.potential(r + Vec3{0, h, 0}) - field.potential(r - Vec3{0, h, 0})) / (2 * h),
+		(field.potential(r + Vec3{0, 0, h}) - field.potential(r - Vec3{0, 0, h})) / (2 * h)
+	};
+	Vec3 a = field.accel(r);
+	Vec3 pm = - field.get_gm() * r / std::pow(r.len(), 3);
+
+	// Compare the part that isn't point-mass, it is much smaller
+	EXPECT_NEAR((a - grad).len() / (a - pm).len(), 0, 1e-4);
+
+	std::remove(filename.c_str());
+}
+
+TEST(GeopotentialTest, LowerDegreeAndOrder) {
+	using namespace orbsim;
+
+	std::string filename = write_coeffs("kaula.txt", kaula_field());
+	Geopotential full(filename, 8, 8);
+	Geopotential zonal(filename, 8, 0);
+	Geopotential low(filename, 2, 2);
+
+	Vec3 r{-4100, 5300, 2900};
+	EXPECT_NE(full.accel(r), zonal.accel(r));
+	EXPECT_NE(full.accel(r), low.accel(r));
+	EXPECT_NE(full.get_hash(), low.get_hash());
+
+	// Made of its first degrees only
+	std::string low_file = write_coeffs("kaula_low.txt", kaula_field().substr(0, kaula_field().find("\n3 ")) + "\n");
+	Geopotential truncated(low_file, 2, 2);
+	EXPECT_EQ(truncated.accel(r), low.accel(r));
+	EXPECT_EQ(truncated.get_hash(), low.get_hash());
+
+	std::remove(filename.c_str());
+	std::remove(low_file.c_str());
+}
+
+TEST(GeopotentialTest, IcgemFormat) {
+	using namespace orbsim;
+
+	std::string filename = write_coeffs("icgem.gfc",
+		"product_type             gravity_field\n"
+		"modelname                test\n"
+		"earth_gravity_constant   0.3986004415E+15\n"
+		"radius                   0.6378136300E+07\n"
+		"max_degree               2\n"
+		"norm                     fully_normalized\n"
+		"end_of_head ===============================\n"
+		"gfc    0    0  1.0                    0.0               0.0  0.0\n"
+		"gfc    2    0 " + C20_str + "  0.0               0.0  0.0\n");
+	Geopotential field(filename, 2, 2);
+
+	EXPECT_DOUBLE_EQ(field.get_gm(), 398600.4415);
+	EXPECT_DOUBLE_EQ(field.get_ref_radius(), 6378.1363);
+	EXPECT_EQ(field.get_degree(), 2);
+
+	std::remove(filename.c_str());
+}
+
+TEST(GeopotentialTest, InvalidArguments) {
+	using namespace orbsim;
+
+	std::string filename = write_coeffs("j2.txt", "0 0 1 0\n2 0 " + C20_str + " 0\n");
+
+	EXPECT_THROW(Geopotential("/nonexistent/dir/egm96.txt", 2, 2), std::runtime_error);
+	EXPECT_THROW(Geopotential(filename, 4, 4), std::domain_error);
+	EXPECT_THROW(Geopotential(filename, 2, 3), std::domain_error);
+	EXPECT_THROW(Geopotential(filename, -1, 0), std::domain_error);
+	EXPECT_THROW(Geopotential(filename, Geopotential::max_degree + 1, 0), std::domain_error);
+
+	std::remove(filename.c_str());
+}
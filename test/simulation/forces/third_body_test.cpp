@@ -0,0 +1,77 @@
+#include "simulation/forces/third_body.hpp"
+#include "simulation/forces/force_model.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/satellite.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <stdexcept>
+
+
+TEST(ThirdBodyTest, AnalyticPositions) {
+	using namespace orbsim;
+
+	// Close to the March equinox of 2000 the Sun is along +x
+	Vec3 sun = sun_position(2451623.8);
+	EXPECT_NEAR(sun.len(), 1.49e8, 0.01e8);
+	EXPECT_LT(std::fabs(sun.y) / sun.len(), 0.01);
+	EXPECT_GT(sun.x, 0);
+
+	// The Moon stays between perigee and apogee, near the ecliptic
+	for (double jd = J2000; jd < J2000 + 60; jd += 1.7) {
+		Vec3 moon = moon_position(jd);
+		EXPECT_GT(moon.len(), 356000);
+		EXPECT_LT(moon.len(), 407000);
+		EXPECT_LT(std::fabs(moon.z) / moon.len(), std::sin((23.44 + 5.2) * PI / 180));
+	}
+}
+
+TEST(ThirdBodyTest, ChebyshevSegments) {
+	using namespace orbsim;
+
+	double epoch = J2000 + 1000;
+	Ephemeris ephemeris(0, 30 * 86400, epoch);
+
+	for (double t = 0; t <= 30 * 86400; t += 3917) {
+		EXPECT_NEAR((ephemeris.sun(t) - sun_position(epoch + t / 86400)).len(), 0, 1e-2);
+		EXPECT_NEAR((ephemeris.moon(t) - moon_position(epoch + t / 86400)).len(), 0, 1e-3);
+	}
+
+	// A little past the span is still fine
+	double t = 30 * 86400 + 600;
+	EXPECT_NEAR((ephemeris.moon(t) - moon_position(epoch + t / 86400)).len(), 0, 1);
+
+	EXPECT_NE(ephemeris.get_hash(), Ephemeris(0, 30 * 86400).get_hash());
+	EXPECT_THROW(Ephemeris(10, 0), std::domain_error);
+}
+
+TEST(ThirdBodyTest, ForceModel) {
+	using namespace orbsim;
+
+	Ephemeris ephemeris(0, 86400);
+	ForceModelDE force_model;
+	force_model.set_third_body(&ephemeris);
+	EXPECT_NE(force_model.hash(), ForceModelDE().hash());
+
+	// At the center of the Earth only the central body pulls
+	double R = Earth.radius;
+	double V = std::sqrt((Earth.mass * G) / (1000 * R)) / 1000;
+	double A = V * V / R;
+	Vec3 x{42164 / R, 0, 0};
+	Vec3 a = force_model.accel(0, x, Vec3{0, 0, 0}) - ForceModelDE().accel(0, x, Vec3{0, 0, 0});
+
+	// Lunisolar perturbation at GEO is a few 1e-9 km/s^2
+	EXPECT_GT((a * A).len(), 1e-10);
+	EXPECT_LT((a * A).len(), 1e-8);
+
+	// It tilts a GEO orbit, two-body motion stays in the equator
+	Satellite sat(KeplElem{0, 42164, 0, 0, 0, 0}, "DOPRI5", Earth, 0, 86400, 2);
+	sat.set_force_model(force_model);
+	SimData sim_data = sat.propagate();
+	Vec3 h = sim_data.get_pos_arr()[1].cross(sim_data.get_vel_arr()[1]);
+	double inc = std::atan2(std::sqrt(h.x * h.x + h.y * h.y), h.z);
+	EXPECT_GT(inc, 1e-6);
+	EXPECT_LT(inc, 1e-3);
+}
@@ -0,0 +1,75 @@
+#include "simulation/integrators/dopri5.hpp"
+#include "simulation/integrators/rk4.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "test_orbit.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <stdexcept>
+
+
+namespace {
+
+// Eccentric orbit (e = 0.7, a = 20000 km)
+const TestOrbit orbit = test_orbit(20000, 0.7);
+
+} // namespace
+
+
+TEST(DOPRI5Test, ReturnsToPeriapsisAfterOnePeriod) {
+	using namespace orbsim;
+
+	DOPRI5 integ(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period, 100);
+	integ.integrate();
+
+	EXPECT_LT((integ.get_pos_arr()[99] - orbit.x0).len(), 1e-2);
+	EXPECT_LT((integ.get_vel_arr()[99] - orbit.v0).len(), 1e-5);
+	EXPECT_GT(integ.get_accepted_steps(), 0);
+}
+
+TEST(DOPRI5Test, FewerEvaluationsThanRK4) {
+	using namespace orbsim;
+
+	DOPRI5 dopri5(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period, 100, 1e-12, 1e-15);
+	dopri5.integrate();
+	double dopri5_err = (dopri5.get_pos_arr()[99] - orbit.x0).len();
+
+	// Fixed step RK4 needs a fine grid to get through periapsis as accurately
+	RK4 rk4(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period, 10000);
+	rk4.integrate();
+	double rk4_err = (rk4.get_pos_arr()[9999] - orbit.x0).len();
+
+	EXPECT_LT(dopri5_err, rk4_err);
+	EXPECT_LT(dopri5.get_rhs_evals() * 5, rk4.get_rhs_evals());
+}
+
+TEST(DOPRI5Test, DenseOutputMatchesReference) {
+	using namespace orbsim;
+
+	DOPRI5 coarse(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period, 1001, 1e-10, 1e-13);
+	RK4 reference(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period, 100001);
+	coarse.integrate();
+	reference.integrate();
+
+	// Grid samples fall between internal steps, so they all come from the interpolant
+	for (int i = 0; i < 1001; i += 37) {
+		EXPECT_LT((coarse.get_pos_arr()[i] - reference.get_pos_arr()[i * 100]).len(), 1e-2);
+	}
+}
+
+TEST(DOPRI5Test, Tolerances) {
+	using namespace orbsim;
+
+	DOPRI5 integ(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period, 100);
+	integ.set_tolerances(1e-6, 1e-9);
+
+	EXPECT_DOUBLE_EQ(integ.get_rel_tol(), 1e-6);
+	EXPECT_DOUBLE_EQ(integ.get_abs_tol(), 1e-9);
+	EXPECT_THROW(integ.set_tolerances(0, 1e-9), std::domain_error);
+	EXPECT_THROW(integ.set_tolerances(1e-6, -1), std::domain_error);
+	EXPECT_THROW(DOPRI5(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period, 100, -1e-9), std::domain_error);
+}
@@ -0,0 +1,68 @@
+#include "simulation/integrators/gauss_jackson.hpp"
+#include "simulation/integrators/rk87.hpp"
+#include "simulation/integrators/rk4.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "test_orbit.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+
+namespace {
+
+// Slightly eccentric LEO (e = 0.1, a = 8000 km)
+const TestOrbit orbit = test_orbit(8000, 0.1);
+
+} // namespace
+
+
+TEST(GaussJacksonTest, ReturnsToPeriapsisAfterTenPeriods) {
+	using namespace orbsim;
+
+	GaussJackson integ(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 10 * orbit.period, 10 * 200 + 1);
+	integ.integrate();
+
+	EXPECT_LT((integ.get_pos_arr()[2000] - orbit.x0).len(), 1e-5);
+	EXPECT_LT((integ.get_vel_arr()[2000] - orbit.v0).len(), 1e-8);
+}
+
+TEST(GaussJacksonTest, OneEvaluationPerStep) {
+	using namespace orbsim;
+
+	GaussJackson short_run(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period, 101);
+	GaussJackson long_run(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 2 * orbit.period, 201);
+	short_run.integrate();
+	long_run.integrate();
+
+	// Same step size and start up, 100 more steps
+	EXPECT_EQ(long_run.get_rhs_evals() - short_run.get_rhs_evals(), 100);
+}
+
+TEST(GaussJacksonTest, MoreAccurateThanRK4) {
+	using namespace orbsim;
+
+	GaussJackson gj(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 10 * orbit.period, 10 * 100 + 1);
+	RK4 rk4(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 10 * orbit.period, 10 * 100 + 1);
+	gj.integrate();
+	rk4.integrate();
+
+	EXPECT_LT((gj.get_pos_arr()[1000] - orbit.x0).len() * 1000, (rk4.get_pos_arr()[1000] - orbit.x0).len());
+	EXPECT_LT(gj.get_rhs_evals(), rk4.get_rhs_evals());
+}
+
+TEST(GaussJacksonTest, ShortGridUsesStartUp) {
+	using namespace orbsim;
+
+	GaussJackson gj(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period / 10, 5);
+	RK87 reference(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period / 10, 5, 1e-13, 1e-15);
+	gj.integrate();
+	reference.integrate();
+
+	for (int i = 0; i < 5; i++) {
+		EXPECT_LT((gj.get_pos_arr()[i] - reference.get_pos_arr()[i]).len(), 1e-9);
+	}
+}
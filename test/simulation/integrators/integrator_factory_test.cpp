@@ -3,10 +3,30 @@
 #include "simulation/integrators/euler.hpp"
 #include "simulation/integrators/verlet.hpp"
 #include "simulation/integrators/rk4.hpp"
+#include "simulation/integrators/dopri5.hpp"
+#include "simulation/integrators/rk87.hpp"
+#include "simulation/integrators/gauss_jackson.hpp"
+#include "simulation/integrators/yoshida.hpp"
+#include "simulation/integrators/kepler.hpp"
 #include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
 
 #include "gtest/gtest.h"
 
+#include <stdexcept>
+#include <string>
+
+
+namespace {
+
+// Point-mass gravity the library doesn't know about
+struct UserDE {
+	orbsim::Vec3 accel(double, const orbsim::Vec3 &x, const orbsim::Vec3 &) const {
+		return - x / (x.len() * x.len() * x.len());
+	}
+};
+
+} // namespace
 
 TEST(IntegratorFactoryTest, Euler) {
 	using namespace orbsim;
@@ -49,3 +69,114 @@ TEST(IntegratorFactoryTest, RK4) {
 
 	delete integ;
 }
+
+TEST(IntegratorFactoryTest, DOPRI5) {
+	using namespace orbsim;
+
+	IntegratorFactory integ_factory(orbit_de, Earth, Vec3{7000,0,0}, {0,0,0}, 0, 1000, 100);
+	Integrator *integ = integ_factory.create("DOPRI5");
+
+	EXPECT_NE(dynamic_cast<DOPRI5 *>(integ), nullptr);
+	EXPECT_EQ(integ->get_steps(), 100);
+	EXPECT_EQ(integ->get_pos_arr()[0], (Vec3{7000,0,0}));
+	EXPECT_EQ(integ->get_vel_arr()[0], (Vec3{0,0,0}));
+
+	delete integ;
+}
+
+TEST(IntegratorFactoryTest, RK87) {
+	using namespace orbsim;
+
+	IntegratorFactory integ_factory(orbit_de, Earth, Vec3{7000,0,0}, {0,0,0}, 0, 1000, 100);
+	Integrator *integ = integ_factory.create("RK87");
+
+	EXPECT_NE(dynamic_cast<RK87 *>(integ), nullptr);
+	EXPECT_EQ(integ->get_steps(), 100);
+	EXPECT_EQ(integ->get_pos_arr()[0], (Vec3{7000,0,0}));
+	EXPECT_EQ(integ->get_vel_arr()[0], (Vec3{0,0,0}));
+
+	delete integ;
+}
+
+TEST(IntegratorFactoryTest, GaussJackson) {
+	using namespace orbsim;
+
+	IntegratorFactory integ_factory(orbit_de, Earth, Vec3{7000,0,0}, {0,0,0}, 0, 1000, 100);
+	Integrator *integ = integ_factory.create("GaussJackson");
+
+	EXPECT_NE(dynamic_cast<GaussJackson *>(integ), nullptr);
+	EXPECT_EQ(integ->get_steps(), 100);
+	EXPECT_EQ(integ->get_pos_arr()[0], (Vec3{7000,0,0}));
+	EXPECT_EQ(integ->get_vel_arr()[0], (Vec3{0,0,0}));
+
+	delete integ;
+}
+
+TEST(IntegratorFactoryTest, Yoshida) {
+	using namespace orbsim;
+
+	IntegratorFactory integ_factory(orbit_de, Earth, Vec3{7000,0,0}, {0,0,0}, 0, 1000, 100);
+	Integrator *integ4 = integ_factory.create("Yoshida4");
+	Integrator *integ6 = integ_factory.create("Yoshida6");
+	Integrator *integ8 = integ_factory.create("Yoshida8");
+
+	EXPECT_NE(dynamic_cast<Yoshida4 *>(integ4), nullptr);
+	EXPECT_NE(dynamic_cast<Yoshida6 *>(integ6), nullptr);
+	EXPECT_NE(dynamic_cast<Yoshida8 *>(integ8), nullptr);
+	EXPECT_EQ(integ8->get_steps(), 100);
+	EXPECT_EQ(integ8->get_pos_arr()[0], (Vec3{7000,0,0}));
+	EXPECT_EQ(integ8->get_vel_arr()[0], (Vec3{0,0,0}));
+
+	delete integ4;
+	delete integ6;
+	delete integ8;
+}
+
+TEST(IntegratorFactoryTest, Kepler) {
+	using namespace orbsim;
+
+	IntegratorFactory integ_factory(orbit_de, Earth, Vec3{7000,0,0}, {0,0,0}, 0, 1000, 100);
+	Integrator *integ = integ_factory.create("Kepler");
+
+	EXPECT_NE(dynamic_cast<Kepler *>(integ), nullptr);
+	EXPECT_EQ(integ->get_steps(), 100);
+	EXPECT_EQ(integ->get_pos_arr()[0], (Vec3{7000,0,0}));
+	EXPECT_EQ(integ->get_vel_arr()[0], (Vec3{0,0,0}));
+
+	delete integ;
+}
+
+TEST(IntegratorFactoryTest, GenericSystem) {
+	using namespace orbsim;
+
+	IntegratorFactory<DESystem<Vec3>> integ_factory(orbit_de, Earth, Vec3{7000,0,0}, {0,0,0}, 0, 1000, 100);
+	Integrator *integ = integ_factory.create("RK4");
+
+	EXPECT_NE(dynamic_cast<BasicRK4<DESystem<Vec3>> *>(integ), nullptr);
+	EXPECT_EQ(dynamic_cast<RK4 *>(integ), nullptr);
+	EXPECT_THROW(integ_factory.create("Leapfrog"), std::domain_error);
+	EXPECT_THROW(integ_factory.create("Kepler"), std::domain_error);
+
+	delete integ;
+}
+
+TEST(IntegratorFactoryTest, UserSystem) {
+	using namespace orbsim;
+
+	IntegratorFactory<UserDE> integ_factory(UserDE{}, Earth, Vec3{7000,0,0}, {0,0,7.5}, 0, 1000, 100);
+	IntegratorFactory<OrbitDE> orbit_factory(orbit_de, Earth, Vec3{7000,0,0}, {0,0,7.5}, 0, 1000, 100);
+
+	for (std::string type : {"Euler", "Verlet", "RK4", "DOPRI5", "RK87", "GaussJackson", "Yoshida8"}) {
+		Integrator *integ = integ_factory.create(type);
+		Integrator *orbit_integ = orbit_factory.create(type);
+		integ->integrate();
+		orbit_integ->integrate();
+
+		EXPECT_NEAR((integ->get_pos_arr()[99] - orbit_integ->get_pos_arr()[99]).len(), 0, 1e-6) << type;
+		EXPECT_NEAR((integ->get_vel_arr()[99] - orbit_integ->get_vel_arr()[99]).len(), 0, 1e-9) << type;
+
+		delete integ;
+		delete orbit_integ;
+	}
+	EXPECT_THROW(integ_factory.create("Kepler"), std::domain_error);
+}
@@ -2,12 +2,25 @@
 #include "simulation/integrators/euler.hpp"
 #include "simulation/integrators/verlet.hpp"
 #include "simulation/integrators/rk4.hpp"
+#include "simulation/integrators/dopri5.hpp"
+#include "simulation/integrators/rk87.hpp"
+#include "simulation/integrators/gauss_jackson.hpp"
+#include "simulation/integrators/yoshida.hpp"
+#include "simulation/integrators/kepler.hpp"
+#include "simulation/forces/force_model.hpp"
 #include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
 #include "simulation/math_obj.hpp"
+#include "simulation/trajectory_sink.hpp"
 
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <fstream>
 #include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <vector>
 
 
 template <typename I>
@@ -20,7 +33,9 @@ public:
 	I integ;
 };
 
-using IntegTypes = testing::Types<orbsim::Euler, orbsim::Verlet, orbsim::RK4>;
+using IntegTypes = testing::Types<orbsim::Euler, orbsim::Verlet, orbsim::RK4, orbsim::DOPRI5,
+								   orbsim::RK87, orbsim::GaussJackson,
+								   orbsim::Yoshida4, orbsim::Yoshida6, orbsim::Yoshida8, orbsim::Kepler>;
 TYPED_TEST_SUITE(IntegratorTest, IntegTypes);
 
 
@@ -118,3 +133,201 @@ TYPED_TEST(IntegratorTest, InitialVelocitySetter) {
 
 	EXPECT_EQ(this->integ.get_vel_arr()[0], (Vec3{0,-3.9,2.5}));
 }
+
+TYPED_TEST(IntegratorTest, TimeArray) {
+	using namespace orbsim;
+
+	this->integ.integrate();
+
+	EXPECT_DOUBLE_EQ(this->integ.get_time_arr()[0], 0);
+	EXPECT_DOUBLE_EQ(this->integ.get_time_arr()[50], 50 * this->integ.get_delta_t());
+	EXPECT_DOUBLE_EQ(this->integ.get_time_arr()[99], 1000);
+}
+
+TYPED_TEST(IntegratorTest, StreamingMatchesInMemory) {
+	using namespace orbsim;
+
+	TypeParam streamed(this->integ);
+	this->integ.integrate();
+
+	// 100 samples through a window of 7, the last block is a partial one
+	std::vector<Vec3> pos, vel;
+	int next = 0;
+	CallbackSink sink([&](const TrajectoryBlock &block) {
+		EXPECT_EQ(block.first, next);
+		EXPECT_LE(block.count, 7);
+		for (int i = 0; i < block.count; i++) {
+			pos.push_back(block.pos_arr[i]);
+			vel.push_back(block.vel_arr[i]);
+		}
+		next += block.count;
+	});
+	streamed.set_sink(&sink, 7);
+	streamed.integrate();
+
+	ASSERT_EQ(pos.size(), 100u);
+	for (int i = 0; i < 100; i++) {
+		EXPECT_EQ(pos[i], this->integ.get_pos_arr()[i]);
+		EXPECT_EQ(vel[i], this->integ.get_vel_arr()[i]);
+	}
+
+	// Running again starts from the initial state, not the last window
+	next = 0;
+	pos.clear();
+	vel.clear();
+	streamed.integrate();
+	ASSERT_EQ(pos.size(), 100u);
+	EXPECT_EQ(pos[99], this->integ.get_pos_arr()[99]);
+}
+
+TEST(IntegratorRhsTest, StaticAndGenericRhsAgree) {
+	using namespace orbsim;
+
+	DESystem<Vec3> generic_de = orbit_de;
+
+	RK4 static_integ(orbit_de, Earth.mass, Earth.radius, Vec3{7000,0,0}, Vec3{0,5.1,7.3}, 0, 1000, 100);
+	BasicRK4<DESystem<Vec3>> generic_integ(generic_de, Earth.mass, Earth.radius, Vec3{7000,0,0}, Vec3{0,5.1,7.3}, 0, 1000, 100);
+	static_integ.integrate();
+	generic_integ.integrate();
+
+	for (int i = 0; i < 100; i++) {
+		EXPECT_LT((static_integ.get_pos_arr()[i] - generic_integ.get_pos_arr()[i]).len(), 1e-8);
+		EXPECT_LT((static_integ.get_vel_arr()[i] - generic_integ.get_vel_arr()[i]).len(), 1e-11);
+	}
+}
+
+TYPED_TEST(IntegratorTest, StepsSetterResizesArrays) {
+	using namespace orbsim;
+
+	// Same time span, more samples than the arrays had room for
+	this->integ.set_steps(1000);
+	this->integ.integrate();
+	EXPECT_GE(this->integ.get_buffer().get_capacity(), 1000);
+
+	EXPECT_DOUBLE_EQ(this->integ.get_time_arr()[999], 1000);
+	EXPECT_NEAR(this->integ.get_pos_arr()[999].len(), 7000, 2000);
+}
+
+TYPED_TEST(IntegratorTest, ArraysAreReused) {
+	using namespace orbsim;
+
+	this->integ.integrate();
+	const Vec3 *pos_arr = this->integ.get_pos_arr();
+
+	// Fewer steps still fit in the same arrays
+	this->integ.set_steps(50);
+	this->integ.integrate();
+	EXPECT_EQ(this->integ.get_pos_arr(), pos_arr);
+
+	// A streamed run gives them back and keeps only its window
+	CallbackSink sink([](const TrajectoryBlock &) {});
+	this->integ.set_sink(&sink, 10);
+	this->integ.integrate();
+	EXPECT_EQ(this->integ.get_buffer().get_capacity(), 10);
+	this->integ.set_sink(nullptr);
+	this->integ.integrate();
+	EXPECT_GE(this->integ.get_buffer().get_capacity(), 50);
+}
+
+TYPED_TEST(IntegratorTest, StreamingBoundsMemory) {
+	using namespace orbsim;
+
+	// Nothing but the initial state before integrating
+	TypeParam integ(orbit_de, Earth.mass, Earth.radius, Vec3{7000,0,0}, Vec3{0,5.1,7.3}, 0, 1e6, 1000000);
+	EXPECT_EQ(integ.get_buffer().get_capacity(), 1);
+
+	int count = 0;
+	CallbackSink sink([&](const TrajectoryBlock &block) { count += block.count; });
+	integ.set_sink(&sink, 256);
+	integ.integrate();
+	EXPECT_EQ(count, 1000000);
+	EXPECT_EQ(integ.get_buffer().get_capacity(), 256);
+}
+
+TYPED_TEST(IntegratorTest, ExtendContinuesLastIntegration) {
+	using namespace orbsim;
+
+	TypeParam full(this->integ);
+	full.resize(300);
+	full.integrate();
+
+	// 100 steps, then only the 200 new ones
+	this->integ.integrate();
+	EXPECT_EQ(this->integ.get_valid_steps(), 100);
+	const Vec3 first_half = this->integ.get_pos_arr()[99];
+	this->integ.resize(300);
+	this->integ.extend();
+
+	EXPECT_EQ(this->integ.get_valid_steps(), 300);
+	EXPECT_EQ(this->integ.get_pos_arr()[99], first_half);
+	EXPECT_LE(this->integ.get_rhs_evals(), full.get_rhs_evals());
+	for (int i = 0; i < 300; i += 50) {
+		EXPECT_DOUBLE_EQ(this->integ.get_time_arr()[i], full.get_time_arr()[i]);
+		EXPECT_NEAR((this->integ.get_pos_arr()[i] - full.get_pos_arr()[i]).len(), 0, 1e-3);
+		EXPECT_NEAR((this->integ.get_vel_arr()[i] - full.get_vel_arr()[i]).len(), 0, 1e-6);
+	}
+
+	// Changing the initial state starts over
+	this->integ.set_x0(Vec3{7100,0,0});
+	EXPECT_EQ(this->integ.get_valid_steps(), 0);
+	this->integ.extend();
+	EXPECT_EQ(this->integ.get_pos_arr()[0], (Vec3{7100,0,0}));
+	EXPECT_EQ(this->integ.get_valid_steps(), 300);
+}
+
+TYPED_TEST(IntegratorTest, SaveToFileWritesSamplesInMemory) {
+	using namespace orbsim;
+
+	// One file per integrator, the typed tests may run at the same time
+	std::string filename = testing::TempDir() + "integrator_test_" + typeid(TypeParam).name() + ".txt";
+	auto count_lines = [&] {
+		std::ifstream in(filename);
+		std::string line;
+		int lines = 0;
+		while (std::getline(in, line)) lines++;
+		return lines;
+	};
+
+	// Nothing integrated yet
+	EXPECT_THROW(this->integ.save_to_file(filename.c_str()), std::domain_error);
+
+	this->integ.integrate();
+	this->integ.save_to_file(filename.c_str());
+	EXPECT_EQ(count_lines(), 100);
+
+	// More steps than the last integration, those aren't there yet
+	this->integ.set_steps(1000);
+	EXPECT_THROW(this->integ.save_to_file(filename.c_str()), std::domain_error);
+
+	// The samples went to the sink
+	CallbackSink sink([](const TrajectoryBlock &) {});
+	this->integ.set_sink(&sink, 10);
+	this->integ.integrate();
+	this->integ.set_sink(nullptr);
+	EXPECT_THROW(this->integ.save_to_file(filename.c_str()), std::domain_error);
+
+	std::remove(filename.c_str());
+}
+
+TYPED_TEST(IntegratorTest, EnergyErrorNeedsTrajectoryInMemory) {
+	using namespace orbsim;
+
+	EXPECT_THROW(this->integ.get_energy_error(), std::domain_error);
+	this->integ.integrate();
+	EXPECT_LT(this->integ.get_energy_error(), 0.1);
+
+	CallbackSink sink([](const TrajectoryBlock &) {});
+	this->integ.set_sink(&sink, 10);
+	this->integ.integrate();
+	EXPECT_THROW(this->integ.get_energy_error(), std::domain_error);
+}
+
+TEST(IntegratorEnergyTest, OnlyForPointMassGravity) {
+	using namespace orbsim;
+
+	// The two-body energy doesn't tell anything about other systems
+	BasicRK4<ForceModelDE> integ(ForceModelDE(Earth), Earth.mass, Earth.radius,
+								 Vec3{7000,0,0}, Vec3{0,5.1,7.3}, 0, 1000, 100);
+	integ.integrate();
+	EXPECT_THROW(integ.get_energy_error(), std::domain_error);
+}
@@ -0,0 +1,84 @@
+#include "simulation/integrators/kepler.hpp"
+#include "simulation/integrators/rk87.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/thread_pool.hpp"
+
+#include "test_orbit.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+
+namespace {
+
+// Eccentric orbit (e = 0.7, a = 20000 km)
+const TestOrbit orbit = test_orbit(20000, 0.7);
+
+} // namespace
+
+
+TEST(KeplerTest, ReturnsToPeriapsis) {
+	using namespace orbsim;
+
+	// Also far in the future, whole revolutions are removed before solving
+	Kepler integ(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 1000 * orbit.period, 1001);
+	integ.integrate();
+
+	for (int i = 1; i <= 1000; i += 111) {
+		EXPECT_LT((integ.get_pos_arr()[i] - orbit.x0).len(), 1e-5);
+		EXPECT_LT((integ.get_vel_arr()[i] - orbit.v0).len(), 1e-8);
+	}
+	EXPECT_EQ(integ.get_rhs_evals(), 0);
+}
+
+TEST(KeplerTest, MatchesNumericalIntegration) {
+	using namespace orbsim;
+
+	Vec3 pos{7000, 300, -1500};
+	Vec3 vel{0.5, 6.9, 3.1};
+	Kepler kepler(orbit_de, Earth.mass, Earth.radius, pos, vel, 0, 86400, 1001);
+	RK87 reference(orbit_de, Earth.mass, Earth.radius, pos, vel, 0, 86400, 1001, 1e-13, 1e-15);
+	kepler.integrate();
+	reference.integrate();
+
+	for (int i = 0; i <= 1000; i++) {
+		EXPECT_LT((kepler.get_pos_arr()[i] - reference.get_pos_arr()[i]).len(), 1e-4);
+		EXPECT_LT((kepler.get_vel_arr()[i] - reference.get_vel_arr()[i]).len(), 1e-7);
+	}
+}
+
+TEST(KeplerTest, HyperbolicOrbit) {
+	using namespace orbsim;
+
+	// Faster than escape velocity
+	Vec3 pos{7000, 0, 0};
+	Vec3 vel{0, 1.5 * std::sqrt(2 * orbit.mu / 7000), 0};
+	Kepler kepler(orbit_de, Earth.mass, Earth.radius, pos, vel, 0, 20000, 101);
+	RK87 reference(orbit_de, Earth.mass, Earth.radius, pos, vel, 0, 20000, 101, 1e-13, 1e-15);
+	kepler.integrate();
+	reference.integrate();
+
+	for (int i = 0; i <= 100; i++) {
+		EXPECT_LT((kepler.get_pos_arr()[i] - reference.get_pos_arr()[i]).len(), 1e-4);
+	}
+	EXPECT_LT(kepler.get_energy_error(), 1e-12);
+}
+
+TEST(KeplerTest, ParallelMatchesSerial) {
+	using namespace orbsim;
+
+	ThreadPool pool(4);
+	Kepler serial(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 30 * orbit.period, 100000);
+	Kepler parallel(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 30 * orbit.period, 100000);
+	parallel.set_thread_pool(&pool);
+	serial.integrate();
+	parallel.integrate();
+
+	for (int i = 0; i < 100000; i++) {
+		ASSERT_EQ(serial.get_pos_arr()[i], parallel.get_pos_arr()[i]);
+		ASSERT_EQ(serial.get_vel_arr()[i], parallel.get_vel_arr()[i]);
+	}
+}
@@ -0,0 +1,100 @@
+#include "simulation/integrators/rk4_simd.hpp"
+#include "simulation/integrators/rk4.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+
+namespace {
+
+struct SoABuffers {
+	explicit SoABuffers(std::size_t n) : x(n), y(n), z(n), vx(n), vy(n), vz(n) {
+		// Spread of circular-ish and eccentric orbits in dimensionless units
+		for (std::size_t i = 0; i < n; i++) {
+			double r = 1.1 + 0.05 * i;
+			x[i] = r;
+			y[i] = 0.01 * i;
+			z[i] = -0.02 * i;
+			vx[i] = 0.001 * i;
+			vy[i] = (0.8 + 0.01 * i) / std::sqrt(r);
+			vz[i] = 0.3 / std::sqrt(r);
+		}
+	}
+
+	orbsim::SoAState state() {
+		return orbsim::SoAState{x.data(), y.data(), z.data(), vx.data(), vy.data(), vz.data()};
+	}
+
+	std::vector<double> x, y, z, vx, vy, vz;
+};
+
+} // namespace
+
+
+TEST(RK4SimdTest, DetectedLevelIsSupported) {
+	using namespace orbsim;
+
+	EXPECT_TRUE(simd_level_supported(SimdLevel::Scalar));
+	EXPECT_TRUE(simd_level_supported(rk4_simd_level()));
+}
+
+TEST(RK4SimdTest, KernelsMatchScalar) {
+	using namespace orbsim;
+
+	// 19 is not a multiple of any lane width, so the scalar tail is used too
+	const std::size_t n = 19;
+	const double dt = 0.01;
+
+	SoABuffers expected(n);
+	for (int step = 0; step < 1000; step++) {
+		rk4_step_soa(expected.state(), n, dt, SimdLevel::Scalar);
+	}
+
+	for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+		if (!simd_level_supported(level)) {
+			continue;
+		}
+
+		SoABuffers actual(n);
+		for (int step = 0; step < 1000; step++) {
+			rk4_step_soa(actual.state(), n, dt, level);
+		}
+
+		for (std::size_t i = 0; i < n; i++) {
+			EXPECT_NEAR(actual.x[i], expected.x[i], 1e-11) << simd_level_name(level);
+			EXPECT_NEAR(actual.y[i], expected.y[i], 1e-11) << simd_level_name(level);
+			EXPECT_NEAR(actual.z[i], expected.z[i], 1e-11) << simd_level_name(level);
+			EXPECT_NEAR(actual.vx[i], expected.vx[i], 1e-11) << simd_level_name(level);
+			EXPECT_NEAR(actual.vy[i], expected.vy[i], 1e-11) << simd_level_name(level);
+			EXPECT_NEAR(actual.vz[i], expected.vz[i], 1e-11) << simd_level_name(level);
+		}
+	}
+}
+
+TEST(RK4SimdTest, MatchesRK4Integrator) {
+	using namespace orbsim;
+
+	RK4 integ(orbit_de, Earth.mass, Earth.radius, Vec3{7000, 0, 0}, Vec3{0, 5.1, 7.3}, 0, 1000, 101);
+	integ.integrate();
+
+	// Same norming as Integrator
+	double R_dim = Earth.radius;
+	double V_dim = std::sqrt((Earth.mass * G)/(1000*Earth.radius))/1000;
+	double T_dim = R_dim / V_dim;
+
+	std::vector<double> x(8, 7000 / R_dim), y(8, 0), z(8, 0);
+	std::vector<double> vx(8, 0), vy(8, 5.1 / V_dim), vz(8, 7.3 / V_dim);
+	SoAState state{x.data(), y.data(), z.data(), vx.data(), vy.data(), vz.data()};
+	for (int step = 0; step < 100; step++) {
+		rk4_step_soa(state, 8, 10 / T_dim);
+	}
+
+	Vec3 pos = Vec3{x[7], y[7], z[7]} * R_dim;
+	Vec3 vel = Vec3{vx[7], vy[7], vz[7]} * V_dim;
+	EXPECT_LT((pos - integ.get_pos_arr()[100]).len(), 1e-6);
+	EXPECT_LT((vel - integ.get_vel_arr()[100]).len(), 1e-9);
+}
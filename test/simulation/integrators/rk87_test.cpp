@@ -0,0 +1,73 @@
+#include "simulation/integrators/rk87.hpp"
+#include "simulation/integrators/rk4.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "test_orbit.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <stdexcept>
+
+
+namespace {
+
+// Slightly eccentric LEO (e = 0.1, a = 8000 km)
+const TestOrbit orbit = test_orbit(8000, 0.1);
+
+} // namespace
+
+
+TEST(RK87Test, ReturnsToPeriapsisAfterTenPeriods) {
+	using namespace orbsim;
+
+	RK87 integ(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 10 * orbit.period, 11, 1e-12, 1e-15);
+	integ.integrate();
+
+	for (int i = 1; i <= 10; i++) {
+		EXPECT_LT((integ.get_pos_arr()[i] - orbit.x0).len(), 1e-4);
+		EXPECT_LT((integ.get_vel_arr()[i] - orbit.v0).len(), 1e-7);
+	}
+	EXPECT_GT(integ.get_accepted_steps(), 0);
+}
+
+TEST(RK87Test, FewerEvaluationsThanRK4) {
+	using namespace orbsim;
+
+	RK87 rk87(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 10 * orbit.period, 11, 1e-12, 1e-15);
+	RK4 rk4(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 10 * orbit.period, 10 * 400 + 1);
+	rk87.integrate();
+	rk4.integrate();
+
+	EXPECT_LT((rk87.get_pos_arr()[10] - orbit.x0).len(), (rk4.get_pos_arr()[4000] - orbit.x0).len());
+	EXPECT_LT(rk87.get_rhs_evals(), rk4.get_rhs_evals());
+}
+
+TEST(RK87Test, HitsTheTimeGrid) {
+	using namespace orbsim;
+
+	// A grid finer than the natural step size limits the steps
+	RK87 fine(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period, 1001);
+	RK87 coarse(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period, 11);
+	fine.integrate();
+	coarse.integrate();
+
+	for (int i = 0; i < 11; i++) {
+		EXPECT_LT((fine.get_pos_arr()[i * 100] - coarse.get_pos_arr()[i]).len(), 1e-3);
+	}
+	EXPECT_EQ(fine.get_accepted_steps(), 1000);
+}
+
+TEST(RK87Test, Tolerances) {
+	using namespace orbsim;
+
+	RK87 integ(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, orbit.period, 100);
+	integ.set_tolerances(1e-6, 1e-9);
+
+	EXPECT_DOUBLE_EQ(integ.get_rel_tol(), 1e-6);
+	EXPECT_DOUBLE_EQ(integ.get_abs_tol(), 1e-9);
+	EXPECT_THROW(integ.set_tolerances(0, 1e-9), std::domain_error);
+	EXPECT_THROW(integ.set_tolerances(1e-6, -1), std::domain_error);
+}
@@ -0,0 +1,35 @@
+#ifndef TEST_ORBIT_HPP
+#define TEST_ORBIT_HPP
+
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include <cmath>
+
+
+/**
+ * @brief Keplerian orbit around the Earth in the xy plane, starting at periapsis
+ *
+ * After a whole number of periods the exact solution is back at the initial
+ * state, which is what the integrator tests compare against.
+ */
+struct TestOrbit {
+	double mu;			// [km^3/s^2]
+	double period;		// [s]
+	orbsim::Vec3 x0;	// [km]
+	orbsim::Vec3 v0;	// [km/s]
+};
+
+// Semi-major axis in [km] and eccentricity
+inline TestOrbit test_orbit(double a, double e) {
+	double mu = orbsim::G * orbsim::Earth.mass / 1e9;
+	return TestOrbit{
+		mu,
+		2 * orbsim::PI * std::sqrt(a*a*a / mu),
+		orbsim::Vec3{a * (1 - e), 0, 0},
+		orbsim::Vec3{0, std::sqrt(mu / a * (1 + e) / (1 - e)), 0}
+	};
+}
+
+
+#endif	// TEST_ORBIT_HPP
@@ -0,0 +1,186 @@
+#include "simulation/integrators/variational.hpp"
+#include "simulation/integrators/dopri5.hpp"
+#include "simulation/integrators/rk4.hpp"
+#include "simulation/integrators/rk87.hpp"
+#include "simulation/integrators/verlet.hpp"
+#include "simulation/forces/atmosphere.hpp"
+#include "simulation/forces/force_model.hpp"
+#include "simulation/satellite.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+namespace {
+
+// Determinant by Gaussian elimination with partial pivoting
+double determinant(orbsim::Mat6 m) {
+	double det = 1;
+	for (int j = 0; j < 6; j++) {
+		int pivot = j;
+		for (int i = j + 1; i < 6; i++) {
+			if (std::fabs(m[i * 6 + j]) > std::fabs(m[pivot * 6 + j])) pivot = i;
+		}
+		if (pivot != j) {
+			for (int k = 0; k < 6; k++) std::swap(m[j * 6 + k], m[pivot * 6 + k]);
+			det = -det;
+		}
+		det *= m[j * 6 + j];
+		for (int i = j + 1; i < 6; i++) {
+			double f = m[i * 6 + j] / m[j * 6 + j];
+			for (int k = j; k < 6; k++) m[i * 6 + k] -= f * m[j * 6 + k];
+		}
+	}
+	return det;
+}
+
+// Final state of a tight propagation, for finite differences
+orbsim::CartElem final_state(orbsim::CartElem initial, double t_end) {
+	orbsim::RK87 integ(orbsim::orbit_de, orbsim::Earth.mass, orbsim::Earth.radius,
+					   initial.pos, initial.vel, 0, t_end, 2, 1e-13, 1e-15);
+	integ.integrate();
+	return orbsim::CartElem{integ.get_pos_arr()[1], integ.get_vel_arr()[1]};
+}
+
+const orbsim::CartElem initial{orbsim::Vec3{7000, 0, 0}, orbsim::Vec3{0, 5.1, 5.9}};
+
+} // namespace
+
+
+TEST(VariationalTest, PointMassPartials) {
+	using namespace orbsim;
+
+	// The closed form matches the central differences of the generic system
+	Vec3 pos{0.8, -0.5, 0.3}, vel{0.1, 0.9, 0.2};
+	AccelPartials exact = accel_partials(orbit_de, 0, pos, vel);
+	AccelPartials numeric = accel_partials((DESystem<Vec3>) orbit_de, 0, pos, vel);
+	for (int k = 0; k < 9; k++) {
+		EXPECT_NEAR(exact.by_pos.m[k], numeric.by_pos.m[k], 1e-8);
+		EXPECT_EQ(exact.by_vel.m[k], 0);
+		EXPECT_NEAR(numeric.by_vel.m[k], 0, 1e-8);
+	}
+}
+
+TEST(VariationalTest, MatchesFiniteDifferences) {
+	using namespace orbsim;
+
+	// Central differences of whole propagations
+	const double t_end = 3000;
+	Mat6 reference;
+	for (int k = 0; k < 6; k++) {
+		double h = k < 3 ? 1e-3 : 1e-6;
+		CartElem plus = initial, minus = initial;
+		double *p = k < 3 ? &plus.pos.x : &plus.vel.x;
+		double *m = k < 3 ? &minus.pos.x : &minus.vel.x;
+		p[k % 3] += h;
+		m[k % 3] -= h;
+		CartElem end_plus = final_state(plus, t_end), end_minus = final_state(minus, t_end);
+		double d[6] = {
+			end_plus.pos.x - end_minus.pos.x, end_plus.pos.y - end_minus.pos.y, end_plus.pos.z - end_minus.pos.z,
+			end_plus.vel.x - end_minus.vel.x, end_plus.vel.y - end_minus.vel.y, end_plus.vel.z - end_minus.vel.z
+		};
+		for (int i = 0; i < 6; i++) reference[i * 6 + k] = d[i] / (2 * h);
+	}
+
+	for (std::string integ_name : {"RK4", "DOPRI5", "RK87"}) {
+		Satellite sat(initial, integ_name, Earth, 0, t_end, 3001);
+		sat.set_stm(true);
+		SimData sim_data = sat.propagate();
+		ASSERT_TRUE(sim_data.has_stm());
+
+		// Identity at the start
+		const Mat6 &first = sim_data.get_stm_arr()[0];
+		for (int k = 0; k < 36; k++) EXPECT_EQ(first[k], k % 7 == 0 ? 1 : 0);
+
+		// Relative to the largest entry of each 3x3 block
+		auto block_max = [&](int i, int k) {
+			double m = 0;
+			for (int bi = i / 3 * 3; bi < i / 3 * 3 + 3; bi++) {
+				for (int bk = k / 3 * 3; bk < k / 3 * 3 + 3; bk++) m = std::max(m, std::fabs(reference[bi * 6 + bk]));
+			}
+			return m;
+		};
+		const Mat6 &last = sim_data.get_stm_arr()[3000];
+		for (int i = 0; i < 6; i++) {
+			for (int k = 0; k < 6; k++) {
+				double scale = block_max(i, k);
+				EXPECT_NEAR(last[i * 6 + k], reference[i * 6 + k], 1e-5 * scale)
+					<< integ_name << " " << i << " " << k;
+			}
+		}
+
+		// Gravity alone preserves phase space volume
+		EXPECT_NEAR(determinant(last), 1, 1e-6) << integ_name;
+	}
+}
+
+TEST(VariationalTest, StateUnchanged) {
+	using namespace orbsim;
+
+	for (std::string integ_name : {"RK4", "DOPRI5", "RK87"}) {
+		Satellite with(initial, integ_name, Earth, 0, 6000, 601);
+		Satellite without(initial, integ_name, Earth, 0, 6000, 601);
+		with.set_stm(true);
+		SimData with_data = with.propagate();
+		SimData without_data = without.propagate();
+		EXPECT_FALSE(without_data.has_stm());
+		EXPECT_EQ(without_data.get_stm_arr(), nullptr);
+
+		// The step size control only looks at the state
+		EXPECT_NEAR((with_data.get_pos_arr()[600] - without_data.get_pos_arr()[600]).len(), 0, 1e-9) << integ_name;
+	}
+}
+
+TEST(VariationalTest, ForceModelWithDrag) {
+	using namespace orbsim;
+
+	// Drag depends on the velocity too, the partials come from central differences
+	Atmosphere atmosphere;
+	ForceModelDE force_model;
+	force_model.set_drag(&atmosphere, 0.05);
+	CartElem low{Vec3{Earth.radius + 300, 0, 0}, Vec3{0, 5.4, 5.4}};
+
+	Satellite sat(low, "RK87", Earth, 0, 2000, 201);
+	sat.set_force_model(force_model);
+	sat.set_stm(true);
+	SimData sim_data = sat.propagate();
+	const Mat6 &stm = sim_data.get_stm_arr()[200];
+
+	// Column of the initial vx by finite differences
+	const double h = 1e-6;
+	Satellite plus(CartElem{low.pos, low.vel + Vec3{h, 0, 0}}, "RK87", Earth, 0, 2000, 201);
+	Satellite minus(CartElem{low.pos, low.vel - Vec3{h, 0, 0}}, "RK87", Earth, 0, 2000, 201);
+	plus.set_force_model(force_model);
+	minus.set_force_model(force_model);
+	Vec3 d_pos = (plus.propagate().get_pos_arr()[200] - minus.propagate().get_pos_arr()[200]) / (2 * h);
+	EXPECT_NEAR(stm[0 * 6 + 3], d_pos.x, 1e-3 * d_pos.len());
+	EXPECT_NEAR(stm[1 * 6 + 3], d_pos.y, 1e-3 * d_pos.len());
+	EXPECT_NEAR(stm[2 * 6 + 3], d_pos.z, 1e-3 * d_pos.len());
+
+	// Drag takes energy, so the volume shrinks
+	EXPECT_LT(determinant(stm), 1);
+}
+
+TEST(VariationalTest, Unsupported) {
+	using namespace orbsim;
+
+	Verlet verlet(orbit_de, Earth.mass, Earth.radius, initial.pos, initial.vel, 0, 100, 11);
+	EXPECT_FALSE(verlet.has_stm());
+	EXPECT_THROW(verlet.set_stm(true), std::domain_error);
+
+	// The satellite keeps its integrator
+	Satellite sat(initial, "RK4", Earth, 0, 100, 11);
+	sat.set_stm(true);
+	EXPECT_THROW(sat.set_integ("Verlet"), std::domain_error);
+	EXPECT_EQ(sat.get_integ_name(), "RK4");
+	sat.set_integ("DOPRI5");
+	EXPECT_TRUE(sat.propagate().has_stm());
+}
@@ -0,0 +1,63 @@
+#include "simulation/integrators/yoshida.hpp"
+#include "simulation/integrators/verlet.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/diff_eq.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "test_orbit.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+
+namespace {
+
+// Moderately eccentric orbit (e = 0.3, a = 10000 km)
+const TestOrbit orbit = test_orbit(10000, 0.3);
+
+template <typename I>
+double period_error(int steps_per_period) {
+	I integ(orbsim::orbit_de, orbsim::Earth.mass, orbsim::Earth.radius, orbit.x0, orbit.v0, 0, orbit.period, steps_per_period + 1);
+	integ.integrate();
+	return (integ.get_pos_arr()[steps_per_period] - orbit.x0).len();
+}
+
+} // namespace
+
+
+TEST(YoshidaTest, ConvergenceOrder) {
+	using namespace orbsim;
+
+	// Halving the step size should cut the error by about 2^order
+	EXPECT_NEAR(std::log2(period_error<Yoshida4>(200) / period_error<Yoshida4>(400)), 4, 0.3);
+	EXPECT_NEAR(std::log2(period_error<Yoshida6>(100) / period_error<Yoshida6>(200)), 6, 0.5);
+	EXPECT_NEAR(std::log2(period_error<Yoshida8>(50) / period_error<Yoshida8>(100)), 8, 1);
+}
+
+TEST(YoshidaTest, NoEnergyDrift) {
+	using namespace orbsim;
+
+	// 100 periods with only 100 steps per orbit.period
+	Yoshida6 short_run(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 10 * orbit.period, 1001);
+	Yoshida6 long_run(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 100 * orbit.period, 10001);
+	short_run.integrate();
+	long_run.integrate();
+
+	// Bounded error: running 10 times longer doesn't make it grow
+	EXPECT_LT(long_run.get_energy_error(), 1e-6);
+	EXPECT_LT(long_run.get_energy_error(), 1.5 * short_run.get_energy_error());
+}
+
+TEST(YoshidaTest, SmallerEnergyErrorThanVerlet) {
+	using namespace orbsim;
+
+	// Verlet gets at least as many RHS evaluations per orbit.period
+	Verlet verlet(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 10 * orbit.period, 10 * 800 + 1);
+	Yoshida8 yoshida(orbit_de, Earth.mass, Earth.radius, orbit.x0, orbit.v0, 0, 10 * orbit.period, 10 * 100 + 1);
+	verlet.integrate();
+	yoshida.integrate();
+
+	EXPECT_LT(yoshida.get_rhs_evals(), verlet.get_rhs_evals());
+	EXPECT_LT(yoshida.get_energy_error() * 100, verlet.get_energy_error());
+}
@@ -0,0 +1,136 @@
+#include "simulation/monte_carlo.hpp"
+#include "simulation/satellite.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+
+// 100 m and 10 cm/s, x correlated with vy
+orbsim::StateCov test_covariance() {
+	orbsim::StateCov cov{};
+	for (int i = 0; i < 3; i++) cov[i * 6 + i] = 0.01;
+	for (int i = 3; i < 6; i++) cov[i * 6 + i] = 1e-8;
+	cov[0 * 6 + 4] = cov[4 * 6 + 0] = 0.5 * 0.1 * 1e-4;
+	return cov;
+}
+
+} // namespace
+
+
+TEST(MonteCarloTest, ReproducibleSamples) {
+	using namespace orbsim;
+
+	Satellite sat;
+	MonteCarlo one(sat, test_covariance(), 42, 1);
+	MonteCarlo four(sat, test_covariance(), 42, 4);
+	MonteCarlo other(sat, test_covariance(), 43, 1);
+
+	for (std::size_t idx : {0, 1, 1000, 123456789}) {
+		EXPECT_EQ(one.sample(idx).pos, four.sample(idx).pos);
+		EXPECT_EQ(one.sample(idx).vel, four.sample(idx).vel);
+		EXPECT_NE(one.sample(idx).pos, other.sample(idx).pos);
+	}
+	EXPECT_NE(one.sample(0).pos, one.sample(1).pos);
+	EXPECT_EQ(four.get_threads(), 4u);
+	EXPECT_EQ(other.get_seed(), 43u);
+}
+
+TEST(MonteCarloTest, SampleDistribution) {
+	using namespace orbsim;
+
+	Satellite sat;
+	StateCov cov = test_covariance();
+	MonteCarlo monte_carlo(sat, cov, 7);
+	CartElem nominal = sat.get_cart_elem();
+
+	const int n = 20000;
+	double sum[6] = {}, sum2[6][6] = {};
+	for (int idx = 0; idx < n; idx++) {
+		CartElem s = monte_carlo.sample(idx);
+		Vec3 dp = s.pos - nominal.pos, dv = s.vel - nominal.vel;
+		double x[6] = {dp.x, dp.y, dp.z, dv.x, dv.y, dv.z};
+		for (int i = 0; i < 6; i++) {
+			sum[i] += x[i];
+			for (int j = 0; j < 6; j++) sum2[i][j] += x[i] * x[j];
+		}
+	}
+
+	// Within a few standard errors
+	for (int i = 0; i < 6; i++) {
+		double sigma = std::sqrt(cov[i * 6 + i]);
+		EXPECT_NEAR(sum[i] / n, 0, 4 * sigma / std::sqrt(n));
+		for (int j = 0; j < 6; j++) {
+			double sigma_ij = sigma * std::sqrt(cov[j * 6 + j]);
+			EXPECT_NEAR(sum2[i][j] / n, cov[i * 6 + j], 5 * sigma_ij * std::sqrt(2.0 / n));
+		}
+	}
+}
+
+TEST(MonteCarloTest, Statistics) {
+	using namespace orbsim;
+
+	Satellite sat(CartElem{Vec3{7000, 0, 0}, Vec3{0, 5.1, 5.3}}, "RK4", Earth, 0, 3000, 61);
+	StateCov cov = test_covariance();
+	MonteCarlo monte_carlo(sat, cov, 1, 4);
+	std::vector<Dispersion> dispersions = monte_carlo.run(2000);
+	ASSERT_EQ(dispersions.size(), 61u);
+	EXPECT_DOUBLE_EQ(dispersions[60].t, 3000);
+
+	// The initial epoch has the covariance that was sampled
+	const Dispersion &first = dispersions[0];
+	EXPECT_NEAR((first.mean.pos - sat.get_cart_elem().pos).len(), 0, 0.02);
+	for (int i = 0; i < 6; i++) {
+		for (int j = 0; j < 6; j++) {
+			double sigma_ij = std::sqrt(cov[i * 6 + i] * cov[j * 6 + j]);
+			EXPECT_NEAR(first.cov[i * 6 + j], cov[i * 6 + j], 0.2 * sigma_ij);
+			EXPECT_DOUBLE_EQ(first.cov[i * 6 + j], first.cov[j * 6 + i]);
+		}
+	}
+
+	// The mean follows the nominal orbit and the along-track spread grows
+	SimData nominal = sat.propagate();
+	EXPECT_NEAR((dispersions[60].mean.pos - nominal.get_pos_arr()[60]).len(), 0, 0.1);
+	double spread0 = first.cov[0] + first.cov[7] + first.cov[14];
+	double spread = dispersions[60].cov[0] + dispersions[60].cov[7] + dispersions[60].cov[14];
+	EXPECT_GT(spread, 10 * spread0);
+}
+
+TEST(MonteCarloTest, IndependentOfThreads) {
+	using namespace orbsim;
+
+	Satellite sat(CartElem{Vec3{7000, 0, 0}, Vec3{0, 7.5, 0}}, "Verlet", Earth, 0, 1000, 11);
+	std::vector<Dispersion> one = MonteCarlo(sat, test_covariance(), 5, 1).run(300);
+	std::vector<Dispersion> three = MonteCarlo(sat, test_covariance(), 5, 3).run(300);
+
+	ASSERT_EQ(one.size(), three.size());
+	for (std::size_t epoch = 0; epoch < one.size(); epoch++) {
+		EXPECT_EQ(one[epoch].mean.pos, three[epoch].mean.pos);
+		EXPECT_EQ(one[epoch].cov, three[epoch].cov);
+	}
+}
+
+TEST(MonteCarloTest, InvalidInput) {
+	using namespace orbsim;
+
+	Satellite sat;
+	StateCov cov = test_covariance();
+	cov[0 * 6 + 1] = 1;
+	EXPECT_THROW(MonteCarlo(sat, cov), std::domain_error);
+
+	cov = test_covariance();
+	cov[0] = -1;
+	EXPECT_THROW(MonteCarlo(sat, cov), std::domain_error);
+
+	// Zero variances are fine
+	MonteCarlo monte_carlo(sat, StateCov{});
+	EXPECT_EQ(monte_carlo.sample(3).pos, sat.get_cart_elem().pos);
+	EXPECT_THROW(monte_carlo.run(0), std::domain_error);
+}
@@ -0,0 +1,122 @@
+#include "simulation/nbody.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+
+namespace {
+
+// Debris cloud of n bodies around a point, always the same one
+void add_cloud(orbsim::NBody &nbody, int n) {
+	std::mt19937 gen(42);
+	std::normal_distribution<double> pos(0, 100);
+	std::uniform_real_distribution<double> mass(1e10, 1e12);
+	for (int i = 0; i < n; i++) {
+		orbsim::Vec3 r{pos(gen), pos(gen), 0.3 * pos(gen)};
+		nbody.add_body(orbsim::CelestialObj{mass(gen), 0.01},
+					   orbsim::CartElem{r, orbsim::Vec3{0, 0, 0}});
+	}
+}
+
+} // namespace
+
+
+TEST(NBodyTest, Constructor) {
+	using namespace orbsim;
+
+	NBody nbody(0, 1000, 100, 0.7, 2);
+
+	EXPECT_EQ(nbody.size(), 0);
+	EXPECT_EQ(nbody.get_t_steps(), 100);
+	EXPECT_DOUBLE_EQ(nbody.get_theta(), 0.7);
+	EXPECT_EQ(nbody.get_threads(), 2);
+	EXPECT_FALSE(nbody.get_direct());
+	EXPECT_THROW(NBody(100, 10, 100), std::domain_error);
+	EXPECT_THROW(NBody(0, 1000, 0), std::domain_error);
+	EXPECT_THROW(NBody(0, 1000, 100, -1), std::domain_error);
+	EXPECT_THROW(nbody.set_softening(-1), std::domain_error);
+}
+
+TEST(NBodyTest, TreeMatchesDirect) {
+	using namespace orbsim;
+
+	NBody direct(0, 1000, 100, 0.5, 4);
+	add_cloud(direct, 3000);
+	direct.set_direct(true);
+	direct.compute_accel();
+
+	// Opening every cell is the direct sum in another order
+	NBody exact(0, 1000, 100, 0, 4);
+	add_cloud(exact, 3000);
+	exact.compute_accel();
+
+	NBody tree(0, 1000, 100, 0.5, 4);
+	add_cloud(tree, 3000);
+	tree.compute_accel();
+
+	double err2 = 0, norm2 = 0;
+	for (std::size_t i = 0; i < direct.size(); i++) {
+		Vec3 a = direct.get_accel(i);
+		EXPECT_LT((exact.get_accel(i) - a).len(), 1e-12 * a.len());
+		Vec3 d = tree.get_accel(i) - a;
+		err2 += d.dot(d);
+		norm2 += a.dot(a);
+	}
+	EXPECT_LT(std::sqrt(err2 / norm2), 1e-2);
+}
+
+TEST(NBodyTest, TwoBodyOrbit) {
+	using namespace orbsim;
+
+	// Small body on a circular orbit, the Earth moves a little too
+	double r = 7000;
+	double m = 1e20;
+	double mu = G * (Earth.mass + m) / 1e9;
+	double v = std::sqrt(mu / r);
+	double period = 2 * PI * std::sqrt(r * r * r / mu);
+
+	NBody nbody(0, period, 4001);
+	nbody.add_body(Earth, CartElem{Vec3{-r * m / (Earth.mass + m), 0, 0},
+								   Vec3{0, -v * m / (Earth.mass + m), 0}});
+	nbody.add_body(CelestialObj{m, 10}, CartElem{Vec3{r * Earth.mass / (Earth.mass + m), 0, 0},
+												 Vec3{0, v * Earth.mass / (Earth.mass + m), 0}});
+
+	double energy = nbody.energy();
+	double max_drift = 0;
+	nbody.propagate([&](int, const NBody &n) {
+		max_drift = std::max(max_drift, std::fabs(n.energy() / energy - 1));
+	});
+
+	// Back where it started after one period, the energy stays bounded
+	Vec3 start{r * Earth.mass / (Earth.mass + m), 0, 0};
+	EXPECT_LT((nbody.get_cart_elem(1).pos - start).len(), 1);
+	EXPECT_LT(max_drift, 1e-5);
+
+	// The center of mass stays put
+	Vec3 com = nbody.get_cart_elem(0).pos * Earth.mass + nbody.get_cart_elem(1).pos * m;
+	EXPECT_LT(com.len() / (Earth.mass + m), 1e-6);
+}
+
+TEST(NBodyTest, CloudConservesMomentum) {
+	using namespace orbsim;
+
+	NBody nbody(0, 3600, 61, 0.5);
+	add_cloud(nbody, 500);
+	nbody.set_softening(1);
+	nbody.set_direct(true);
+	nbody.propagate();
+
+	Vec3 momentum{0, 0, 0};
+	double scale = 0;
+	for (std::size_t i = 0; i < nbody.size(); i++) {
+		momentum = momentum + nbody.get_cart_elem(i).vel * nbody.get_mass(i);
+		scale += nbody.get_cart_elem(i).vel.len() * nbody.get_mass(i);
+	}
+	EXPECT_GT(scale, 0);
+	EXPECT_LT(momentum.len(), 1e-10 * scale);
+}
@@ -0,0 +1,141 @@
+#include "simulation/orbital_elements.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/thread_pool.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+// Elliptic, inclined orbits away from the singular cases
+std::vector<orbsim::KeplElem> random_elems(int count) {
+	std::mt19937 gen(11);
+	std::uniform_real_distribution<double> ecc(0.001, 0.9);
+	std::uniform_real_distribution<double> sma(6600, 50000);
+	std::uniform_real_distribution<double> inc(0.01, orbsim::PI - 0.01);
+	std::uniform_real_distribution<double> angle(0.01, 2 * orbsim::PI - 0.01);
+
+	std::vector<orbsim::KeplElem> elems(count);
+	for (orbsim::KeplElem &k : elems) {
+		k = orbsim::KeplElem{ecc(gen), sma(gen), inc(gen), angle(gen), angle(gen), angle(gen)};
+	}
+	return elems;
+}
+
+} // namespace
+
+
+TEST(OrbitalElementsTest, CircularOrbit) {
+	using namespace orbsim;
+
+	// Circular equatorial orbit at the ascending node
+	CartElem cart_elem = kepl_to_cart(KeplElem{0, 7000, 0, 0, 0, 0});
+	double v = std::sqrt(G * Earth.mass / 7e6) / 1000;
+
+	EXPECT_NEAR((cart_elem.pos - Vec3{7000, 0, 0}).len(), 0, 1e-9);
+	EXPECT_NEAR((cart_elem.vel - Vec3{0, v, 0}).len(), 0, 1e-12);
+}
+
+TEST(OrbitalElementsTest, RoundTrip) {
+	using namespace orbsim;
+
+	std::vector<KeplElem> kepl_elems = random_elems(1000);
+	std::vector<KeplElem> back = cart_to_kepl(kepl_to_cart(kepl_elems));
+
+	for (std::size_t i = 0; i < kepl_elems.size(); i++) {
+		EXPECT_NEAR(back[i].ecc, kepl_elems[i].ecc, 1e-9);
+		EXPECT_NEAR(back[i].sem_maj_ax, kepl_elems[i].sem_maj_ax, 1e-6 * kepl_elems[i].sem_maj_ax);
+		EXPECT_NEAR(back[i].inc, kepl_elems[i].inc, 1e-9);
+		EXPECT_NEAR(back[i].ri_asc_node, kepl_elems[i].ri_asc_node, 1e-9);
+		EXPECT_NEAR(back[i].arg_of_per, kepl_elems[i].arg_of_per, 1e-6);
+		EXPECT_NEAR(back[i].true_anom, kepl_elems[i].true_anom, 1e-6);
+	}
+}
+
+TEST(OrbitalElementsTest, BatchMatchesSingle) {
+	using namespace orbsim;
+
+	// More than one block, split between threads
+	std::vector<KeplElem> kepl_elems = random_elems(10000);
+	ThreadPool pool(4);
+	std::vector<CartElem> cart_elems = kepl_to_cart(kepl_elems, Earth, &pool);
+	std::vector<KeplElem> back = cart_to_kepl(cart_elems, Earth, &pool);
+
+	std::vector<Vec3> pos_arr, vel_arr;
+	for (const CartElem &c : cart_elems) {
+		pos_arr.push_back(c.pos);
+		vel_arr.push_back(c.vel);
+	}
+	std::vector<KeplElem> from_arrays(kepl_elems.size());
+	cart_to_kepl(pos_arr.data(), vel_arr.data(), from_arrays.data(), kepl_elems.size());
+
+	for (std::size_t i = 0; i < kepl_elems.size(); i += 7) {
+		CartElem single = kepl_to_cart(kepl_elems[i]);
+		EXPECT_EQ(cart_elems[i].pos, single.pos);
+		EXPECT_EQ(cart_elems[i].vel, single.vel);
+		EXPECT_DOUBLE_EQ(back[i].true_anom, cart_to_kepl(single).true_anom);
+		EXPECT_DOUBLE_EQ(from_arrays[i].arg_of_per, back[i].arg_of_per);
+	}
+}
+
+TEST(OrbitalElementsTest, KeplerEquation) {
+	using namespace orbsim;
+
+	// Machine precision over the whole eccentricity range, in any revolution
+	for (double e : {0.0, 0.01, 0.3, 0.7, 0.9, 0.99, 0.999999}) {
+		for (double M = -20; M < 20; M += 0.0137) {
+			double E = ecc_anom_from_mean(M, e);
+			EXPECT_NEAR(E - e * std::sin(E), M, 1e-14 * std::max(1.0, std::fabs(M)));
+			EXPECT_LT(std::fabs(E - M), PI);
+		}
+	}
+	EXPECT_DOUBLE_EQ(ecc_anom_from_mean(0, 0.5), 0);
+	EXPECT_DOUBLE_EQ(ecc_anom_from_mean(PI, 0.5), PI);
+}
+
+TEST(OrbitalElementsTest, AnomalyConversions) {
+	using namespace orbsim;
+
+	for (double e : {0.0, 0.2, 0.8}) {
+		for (double ni = 0.05; ni < 2 * PI; ni += 0.1) {
+			double E = ecc_anom_from_true(ni, e);
+			EXPECT_NEAR(true_anom_from_ecc(E, e), ni, 1e-12);
+			EXPECT_NEAR(true_anom_from_mean(mean_anom_from_true(ni, e), e), ni, 1e-12);
+
+			// The distance agrees both ways
+			EXPECT_NEAR(1 - e * std::cos(E), (1 - e*e) / (1 + e * std::cos(ni)), 1e-12);
+		}
+	}
+
+	// Mean anomaly at apoapsis and after a full revolution
+	EXPECT_NEAR(mean_anom_from_true(PI, 0.5), PI, 1e-12);
+	EXPECT_NEAR(true_anom_from_mean(2 * PI + 1, 0.3), 2 * PI + true_anom_from_mean(1, 0.3), 1e-12);
+}
+
+TEST(OrbitalElementsTest, BatchKeplerEquation) {
+	using namespace orbsim;
+
+	std::mt19937 gen(5);
+	std::uniform_real_distribution<double> mean(-10, 10);
+	std::uniform_real_distribution<double> ecc(0, 0.99);
+	std::vector<double> M(20000), e(20000), E(20000), ni(20000);
+	for (std::size_t i = 0; i < M.size(); i++) {
+		M[i] = mean(gen);
+		e[i] = ecc(gen);
+	}
+
+	ThreadPool pool(4);
+	ecc_anom_from_mean(M.data(), e.data(), E.data(), M.size(), &pool);
+	true_anom_from_mean(M.data(), e.data(), ni.data(), M.size());
+
+	for (std::size_t i = 0; i < M.size(); i++) {
+		EXPECT_DOUBLE_EQ(E[i], ecc_anom_from_mean(M[i], e[i]));
+		EXPECT_DOUBLE_EQ(ni[i], true_anom_from_mean(M[i], e[i]));
+	}
+}
@@ -0,0 +1,50 @@
+#include "simulation/parallel_propagator.hpp"
+#include "simulation/satellite.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+
+TEST(ParallelPropagatorTest, AddSatellites) {
+	using namespace orbsim;
+
+	ParallelPropagator propagator(2);
+	propagator.add_sat(Satellite());
+	propagator.add_sats(std::vector<CartElem>{
+		{Vec3{7000, 0, 0}, Vec3{0, 5.1, 7.3}},
+		{Vec3{7100, 0, 1300}, Vec3{0, 7.35, 1}},
+	});
+	propagator.add_sats(std::vector<KeplElem>{{0.1, 7500, 0.1, 0.2, 0.3, 1.5}});
+
+	EXPECT_EQ(propagator.get_threads(), 2);
+	EXPECT_EQ(propagator.size(), 4);
+	EXPECT_EQ(propagator.get_sat(1).get_cart_elem().pos, (Vec3{7000, 0, 0}));
+	EXPECT_DOUBLE_EQ(propagator.get_sat(3).get_kepl_elem().ecc, 0.1);
+}
+
+TEST(ParallelPropagatorTest, MatchesSerialPropagation) {
+	using namespace orbsim;
+
+	std::vector<CartElem> cart_elems;
+	for (int i = 0; i < 40; i++) {
+		cart_elems.push_back(CartElem{Vec3{7000.0 + 50*i, 0, 0}, Vec3{0, 7.3, 0.1*i}});
+	}
+
+	ParallelPropagator propagator(4);
+	propagator.add_sats(cart_elems, "RK4", Earth, 0, 3000, 301);
+	std::vector<SimData> sim_data = propagator.propagate();
+
+	ASSERT_EQ(sim_data.size(), cart_elems.size());
+	for (std::size_t i = 0; i < cart_elems.size(); i++) {
+		Satellite sat(cart_elems[i], "RK4", Earth, 0, 3000, 301);
+		SimData expected = sat.propagate();
+
+		ASSERT_EQ(sim_data[i].get_steps(), expected.get_steps());
+		EXPECT_EQ(sim_data[i].get_pos_arr()[0], expected.get_pos_arr()[0]);
+		EXPECT_EQ(sim_data[i].get_pos_arr()[300], expected.get_pos_arr()[300]);
+		EXPECT_EQ(sim_data[i].get_vel_arr()[300], expected.get_vel_arr()[300]);
+	}
+}
@@ -0,0 +1,166 @@
+#include "simulation/propagation_cache.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/satellite.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+orbsim::PropagationKey test_key(double x) {
+	return orbsim::PropagationKey{
+		orbsim::CartElem{orbsim::Vec3{x, 0, 0}, orbsim::Vec3{0, 7.5, 0}},
+		"RK4", orbsim::Earth, 0, 10, 100, 0
+	};
+}
+
+// 100 samples with pos = (i, x, 0)
+void put_test_trajectory(orbsim::PropagationCache &cache, double x) {
+	std::vector<double> time_arr(100);
+	std::vector<orbsim::Vec3> pos_arr(100), vel_arr(100);
+	for (int i = 0; i < 100; i++) {
+		time_arr[i] = 10 * i;
+		pos_arr[i] = orbsim::Vec3{(double) i, x, 0};
+	}
+	cache.put(test_key(x), 100, time_arr.data(), pos_arr.data(), vel_arr.data());
+}
+
+// Where the cache spills the trajectory of test_key(x)
+std::string spill_path(double x) {
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.orbtraj", (unsigned long long) test_key(x).hash());
+	return testing::TempDir() + "/" + name;
+}
+
+} // namespace
+
+
+TEST(PropagationCacheTest, Key) {
+	using namespace orbsim;
+
+	EXPECT_EQ(test_key(7000), test_key(7000));
+	EXPECT_EQ(test_key(7000).hash(), test_key(7000).hash());
+	EXPECT_NE(test_key(7000).hash(), test_key(7001).hash());
+
+	PropagationKey other = test_key(7000);
+	other.integ_name = "Verlet";
+	EXPECT_FALSE(other == test_key(7000));
+	EXPECT_NE(other.hash(), test_key(7000).hash());
+}
+
+TEST(PropagationCacheTest, HitsAndMisses) {
+	using namespace orbsim;
+
+	PropagationCache cache;
+	EXPECT_EQ(cache.get(test_key(7000)), nullptr);
+	put_test_trajectory(cache, 7000);
+
+	auto trajectory = cache.get(test_key(7000));
+	ASSERT_NE(trajectory, nullptr);
+	EXPECT_EQ(trajectory->pos_arr[42], (Vec3{42, 7000, 0}));
+	EXPECT_EQ(cache.get(test_key(7001)), nullptr);
+
+	EXPECT_EQ(cache.get_hits(), 1u);
+	EXPECT_EQ(cache.get_misses(), 2u);
+	EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(PropagationCacheTest, LeastRecentlyUsedIsEvicted) {
+	using namespace orbsim;
+
+	// Room for two trajectories
+	std::size_t entry_bytes = 100 * (sizeof(double) + 2 * sizeof(Vec3));
+	PropagationCache cache(2 * entry_bytes);
+	put_test_trajectory(cache, 1);
+	put_test_trajectory(cache, 2);
+	cache.get(test_key(1));
+	put_test_trajectory(cache, 3);
+
+	EXPECT_EQ(cache.size(), 2u);
+	EXPECT_EQ(cache.get_bytes(), 2 * entry_bytes);
+	EXPECT_NE(cache.get(test_key(1)), nullptr);
+	EXPECT_EQ(cache.get(test_key(2)), nullptr);
+	EXPECT_NE(cache.get(test_key(3)), nullptr);
+
+	cache.set_max_bytes(entry_bytes);
+	EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(PropagationCacheTest, SpillToDisk) {
+	using namespace orbsim;
+
+	std::size_t entry_bytes = 100 * (sizeof(double) + 2 * sizeof(Vec3));
+	PropagationCache cache(entry_bytes, testing::TempDir());
+	put_test_trajectory(cache, 1);
+	put_test_trajectory(cache, 2);
+	EXPECT_EQ(cache.size(), 1u);
+
+	// Loaded back from the spill directory
+	auto trajectory = cache.get(test_key(1));
+	ASSERT_NE(trajectory, nullptr);
+	EXPECT_EQ(trajectory->pos_arr[99], (Vec3{99, 1, 0}));
+	EXPECT_DOUBLE_EQ(trajectory->time_arr[99], 990);
+	EXPECT_EQ(cache.get_hits(), 1u);
+
+	for (double x : {1, 2}) {
+		std::remove(spill_path(x).c_str());
+		std::remove((spill_path(x) + ".key").c_str());
+	}
+}
+
+TEST(PropagationCacheTest, SpilledKeyIsChecked) {
+	using namespace orbsim;
+
+	std::size_t entry_bytes = 100 * (sizeof(double) + 2 * sizeof(Vec3));
+	PropagationCache cache(entry_bytes, testing::TempDir());
+	put_test_trajectory(cache, 4);
+	put_test_trajectory(cache, 5);
+
+	// A stale file under the name of another key, as after a hash collision
+	for (std::string ext : {"", ".key"}) {
+		std::ifstream in(spill_path(4) + ext, std::ios::binary);
+		std::ofstream out(spill_path(6) + ext, std::ios::binary);
+		out << in.rdbuf();
+	}
+	EXPECT_EQ(cache.get(test_key(6)), nullptr);
+	EXPECT_NE(cache.get(test_key(4)), nullptr);
+
+	for (double x : {4, 5, 6}) {
+		std::remove(spill_path(x).c_str());
+		std::remove((spill_path(x) + ".key").c_str());
+	}
+}
+
+TEST(PropagationCacheTest, SatellitePropagation) {
+	using namespace orbsim;
+
+	PropagationCache cache;
+	Satellite sat;
+	sat.set_cache(&cache);
+	SimData sim_data = sat.propagate();
+	Vec3 last = sim_data.get_pos_arr()[sim_data.get_steps() - 1];
+	EXPECT_EQ(cache.get_misses(), 1u);
+
+	// Another satellite with the same inputs gets the cached result
+	Satellite other;
+	other.set_cache(&cache);
+	other.set_integ("Verlet");
+	other.set_integ("RK4");
+	SimData other_data = other.propagate();
+	EXPECT_EQ(cache.get_hits(), 1u);
+	EXPECT_EQ(other_data.get_steps(), sim_data.get_steps());
+	EXPECT_EQ(other_data.get_pos_arr()[other_data.get_steps() - 1], last);
+
+	// Different inputs miss
+	other.set_integ("Verlet");
+	other_data = other.propagate();
+	EXPECT_EQ(cache.get_misses(), 2u);
+	EXPECT_NE(other_data.get_pos_arr()[other_data.get_steps() - 1], last);
+}
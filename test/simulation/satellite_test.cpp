@@ -1,8 +1,14 @@
 #include "simulation/satellite.hpp"
+#include "simulation/celestial_obj.hpp"
 #include "simulation/math_obj.hpp"
+#include "simulation/sim_data.hpp"
+#include "simulation/trajectory_buffer.hpp"
+#include "simulation/trajectory_sink.hpp"
 
 #include "gtest/gtest.h"
 
+#include <cmath>
+
 
 TEST(SatelliteTest, DefaultConstructor) {
 	using namespace orbsim;
@@ -130,3 +136,130 @@ TEST(SatelliteTest, Assignment) {
 	EXPECT_EQ(sat1.get_cart_elem().pos, cart_elem.pos);
 	EXPECT_EQ(sat1.get_cart_elem().vel, cart_elem.vel);
 }
+
+TEST(SatelliteTest, StreamingPropagation) {
+	using namespace orbsim;
+
+	Satellite sat;
+	RingBufferSink sink(10);
+	sat.propagate(sink, 64);
+
+	// Only the last samples are kept, and they match the in-memory run
+	SimData sim_data = sat.propagate();
+	ASSERT_EQ(sink.get_total(), sim_data.get_steps());
+	ASSERT_EQ(sink.size(), 10);
+	for (int i = 0; i < 10; i++) {
+		int step = sim_data.get_steps() - 10 + i;
+		EXPECT_DOUBLE_EQ(sink.time_at(i), sim_data.get_time_arr()[step]);
+		EXPECT_EQ(sink.pos_at(i), sim_data.get_pos_arr()[step]);
+		EXPECT_EQ(sink.vel_at(i), sim_data.get_vel_arr()[step]);
+	}
+}
+
+TEST(SatelliteTest, IntegratorChangeKeepsArrays) {
+	using namespace orbsim;
+
+	TrajectoryArena arena;
+	Satellite sat;
+	sat.set_arena(&arena);
+	sat.propagate();
+	std::size_t heap_allocs = arena.get_heap_allocs();
+
+	sat.set_integ("Verlet");
+	SimData new_data = sat.propagate();
+	EXPECT_EQ(arena.get_heap_allocs(), heap_allocs);
+	EXPECT_EQ(new_data.get_pos_arr()[0], sat.get_cart_elem().pos);
+	EXPECT_EQ(sat.get_integ_name(), "Verlet");
+}
+
+TEST(SatelliteTest, ArenaSweep) {
+	using namespace orbsim;
+
+	TrajectoryArena arena;
+	Satellite sat;
+	sat.set_arena(&arena);
+	sat.propagate();
+	std::size_t heap_allocs = arena.get_heap_allocs();
+
+	// Changing the parameters and propagating again doesn't allocate
+	for (int i = 0; i < 5; i++) {
+		sat.set_cart_elem(CartElem{Vec3{7000.0 + 100 * i, 0, 0}, Vec3{0, 7.5, 0}});
+		sat.set_t_steps(8640 - 1000 * i);
+		sat.set_integ(i % 2 == 0 ? "RK4" : "Verlet");
+		sat.propagate();
+	}
+	EXPECT_EQ(arena.get_heap_allocs(), heap_allocs);
+
+	// A copy gets its arrays from the arena too
+	{
+		Satellite sat_copy(sat);
+		sat_copy.propagate();
+	}
+	Satellite sat_copy(sat);
+	EXPECT_GT(arena.get_reuses(), 0u);
+}
+
+TEST(SatelliteTest, IncrementalPropagation) {
+	using namespace orbsim;
+
+	Satellite sat;
+	sat.set_incremental(true);
+	SimData sim_data = sat.propagate();
+	Vec3 last = sim_data.get_pos_arr()[sim_data.get_steps() - 1];
+
+	// Twice the time span, the old samples are kept and the new ones added
+	sat.set_t_end(2 * 86400);
+	EXPECT_EQ(sat.get_t_steps(), 2 * 8640 - 1);
+	sim_data = sat.propagate();
+	ASSERT_EQ(sim_data.get_steps(), 2 * 8640 - 1);
+	EXPECT_EQ(sim_data.get_pos_arr()[8639], last);
+	EXPECT_NEAR(sim_data.get_time_arr()[sim_data.get_steps() - 1], 2 * 86400, 1e-6);
+
+	// Same as propagating the whole span at once
+	Satellite full(sat.get_cart_elem(), "RK4", Earth, 0, 2 * 86400, 2 * 8640 - 1);
+	SimData full_data = full.propagate();
+	EXPECT_NEAR((sim_data.get_pos_arr()[sim_data.get_steps() - 1] - full_data.get_pos_arr()[full_data.get_steps() - 1]).len(), 0, 1e-6);
+
+	// A shorter time span keeps only the samples up to the new end
+	sat.set_t_end(43200);
+	EXPECT_EQ(sat.get_t_steps(), 4321);
+	sim_data = sat.propagate();
+	ASSERT_EQ(sim_data.get_steps(), 4321);
+	EXPECT_NEAR(sim_data.get_time_arr()[4320], 43200, 10);
+	EXPECT_DOUBLE_EQ(sim_data.get_time_arr()[4320], full_data.get_time_arr()[4320]);
+	EXPECT_EQ(sim_data.get_pos_arr()[4320], full_data.get_pos_arr()[4320]);
+
+	// And grows again from there
+	sat.set_t_end(86400);
+	sim_data = sat.propagate();
+	ASSERT_EQ(sim_data.get_steps(), 8640);
+	EXPECT_EQ(sim_data.get_pos_arr()[8639], last);
+
+	// A new integrator or initial state starts over
+	sat.set_integ("Verlet");
+	sim_data = sat.propagate();
+	EXPECT_NE(sim_data.get_pos_arr()[8639], last);
+	sat.set_cart_elem(CartElem{Vec3{7100, 0, 0}, Vec3{0, 7.5, 0}});
+	sim_data = sat.propagate();
+	EXPECT_EQ(sim_data.get_pos_arr()[0], (Vec3{7100, 0, 0}));
+}
+
+TEST(SatelliteTest, MeanAnomaly) {
+	using namespace orbsim;
+
+	KeplElem kepl_elem{0.5, 7500, 0.1, 0.2, 0.3, 1.5};
+	Satellite sat(kepl_elem, "Kepler", Earth, 0, 1000, 101);
+	sat.set_mean_anom(2.0);
+
+	EXPECT_NEAR(sat.get_mean_anom(), 2.0, 1e-12);
+	EXPECT_DOUBLE_EQ(sat.get_kepl_elem().sem_maj_ax, kepl_elem.sem_maj_ax);
+	EXPECT_DOUBLE_EQ(sat.get_kepl_elem().arg_of_per, kepl_elem.arg_of_per);
+
+	// Back from the Cartesian state, the mean anomaly grows by n * t along the orbit
+	double n = std::sqrt(G * Earth.mass / 1e9 / std::pow(kepl_elem.sem_maj_ax, 3));
+	SimData sim_data = sat.propagate();
+	Satellite start(CartElem{sim_data.get_pos_arr()[0], sim_data.get_vel_arr()[0]});
+	Satellite end(CartElem{sim_data.get_pos_arr()[100], sim_data.get_vel_arr()[100]});
+	EXPECT_NEAR(start.get_mean_anom(), 2.0, 1e-9);
+	EXPECT_NEAR(end.get_mean_anom(), 2.0 + n * 1000, 1e-9);
+}
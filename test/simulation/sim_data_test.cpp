@@ -0,0 +1,75 @@
+#include "simulation/sim_data.hpp"
+#include "simulation/satellite.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <vector>
+
+
+TEST(SimDataTest, OwnsSamples) {
+	using namespace orbsim;
+
+	Satellite sat(CartElem{Vec3{7000, 0, 0}, Vec3{0, 7.5, 0}}, "RK4", Earth, 0, 1000, 101);
+	SimData sim_data = sat.propagate();
+	Vec3 last = sim_data.get_pos_arr()[100];
+
+	// Propagating again doesn't change a result that was handed out
+	sat.set_cart_elem(CartElem{Vec3{8000, 0, 0}, Vec3{0, 7, 0}});
+	sat.propagate();
+	EXPECT_EQ(sim_data.get_pos_arr()[100], last);
+
+	EXPECT_EQ(sim_data.get_steps(), 101);
+	EXPECT_DOUBLE_EQ(sim_data.get_t_start(), 0);
+	EXPECT_DOUBLE_EQ(sim_data.get_t_end(), 1000);
+	EXPECT_DOUBLE_EQ(sim_data.get_time_arr()[50], 500);
+	EXPECT_EQ(SimData().get_steps(), 0);
+}
+
+TEST(SimDataTest, StateAt) {
+	using namespace orbsim;
+
+	// Every 10th step of a fine run, interpolated back to the fine steps
+	CartElem initial{Vec3{7000, 0, 0}, Vec3{0, 5.1, 7.3}};
+	Satellite fine(initial, "RK87", Earth, 0, 6000, 6001);
+	Satellite coarse(initial, "RK87", Earth, 0, 6000, 601);
+	SimData fine_data = fine.propagate();
+	SimData coarse_data = coarse.propagate();
+
+	for (int i = 0; i < 6001; i += 7) {
+		CartElem state = coarse_data.state_at(i);
+		EXPECT_NEAR((state.pos - fine_data.get_pos_arr()[i]).len(), 0, 1e-3);
+		EXPECT_NEAR((state.vel - fine_data.get_vel_arr()[i]).len(), 0, 1e-5);
+	}
+
+	// Exact at the samples
+	EXPECT_EQ(coarse_data.state_at(6000).pos, coarse_data.get_pos_arr()[600]);
+	EXPECT_NEAR((coarse_data.state_at(1230).pos - coarse_data.get_pos_arr()[123]).len(), 0, 1e-9);
+
+	EXPECT_THROW(coarse_data.state_at(-1), std::out_of_range);
+	EXPECT_THROW(coarse_data.state_at(6001), std::out_of_range);
+	EXPECT_THROW(SimData().state_at(0), std::out_of_range);
+}
+
+TEST(SimDataTest, BatchQuery) {
+	using namespace orbsim;
+
+	Satellite sat(CartElem{Vec3{7000, 0, 0}, Vec3{0, 5.1, 7.3}}, "RK4", Earth, 100, 3100, 301);
+	SimData sim_data = sat.propagate();
+
+	std::vector<double> times;
+	for (double t = 100; t <= 3100; t += 3.7) times.push_back(t);
+	std::vector<CartElem> states = sim_data.states_at(times);
+
+	ASSERT_EQ(states.size(), times.size());
+	for (std::size_t i = 0; i < times.size(); i++) {
+		EXPECT_EQ(states[i].pos, sim_data.state_at(times[i]).pos);
+		EXPECT_EQ(states[i].vel, sim_data.state_at(times[i]).vel);
+	}
+
+	// Nothing is interpolated if any time is outside
+	times.push_back(50);
+	EXPECT_THROW(sim_data.states_at(times), std::out_of_range);
+}
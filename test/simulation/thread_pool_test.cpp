@@ -0,0 +1,85 @@
+#include "simulation/thread_pool.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+
+TEST(ThreadPoolTest, Constructor) {
+	using namespace orbsim;
+
+	ThreadPool pool1(3);
+	ThreadPool pool2;
+
+	EXPECT_EQ(pool1.get_threads(), 3);
+	EXPECT_GE(pool2.get_threads(), 1);
+}
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+	using namespace orbsim;
+
+	ThreadPool pool(4);
+
+	for (std::size_t count : {0, 1, 3, 1000}) {
+		std::vector<std::atomic<int>> visits(count);
+		pool.parallel_for(count, [&](std::size_t i) { visits[i]++; });
+
+		for (std::size_t i = 0; i < count; i++) {
+			EXPECT_EQ(visits[i], 1);
+		}
+	}
+}
+
+TEST(ThreadPoolTest, UnevenTasks) {
+	using namespace orbsim;
+
+	ThreadPool pool(4);
+	std::vector<double> results(64);
+
+	// The first indices are much more expensive, so the rest must be stolen
+	pool.parallel_for(results.size(), [&](std::size_t i) {
+		double sum = 0;
+		for (int j = 0; j < (i < 4 ? 200000 : 10); j++) {
+			sum += 1.0 / (j + 1);
+		}
+		results[i] = sum;
+	});
+
+	for (std::size_t i = 4; i < results.size(); i++) {
+		EXPECT_DOUBLE_EQ(results[i], results[4]);
+	}
+}
+
+TEST(ThreadPoolTest, Exception) {
+	using namespace orbsim;
+
+	ThreadPool pool(2);
+	std::atomic<int> runs = 0;
+
+	EXPECT_THROW(pool.parallel_for(10, [&](std::size_t i) {
+		runs++;
+		if (i == 7) throw std::runtime_error("task failed");
+	}), std::runtime_error);
+	EXPECT_EQ(runs, 10);
+
+	// The pool must still be usable afterwards
+	pool.parallel_for(10, [&](std::size_t) { runs++; });
+	EXPECT_EQ(runs, 20);
+}
+
+TEST(ThreadPoolTest, NestedParallelFor) {
+	using namespace orbsim;
+
+	ThreadPool pool(4);
+	std::vector<std::atomic<int>> visits(8 * 8);
+
+	pool.parallel_for(8, [&](std::size_t i) {
+		pool.parallel_for(8, [&](std::size_t j) { visits[i * 8 + j]++; });
+	});
+
+	for (std::size_t i = 0; i < visits.size(); i++) {
+		EXPECT_EQ(visits[i], 1);
+	}
+}
@@ -0,0 +1,75 @@
+#include "simulation/trajectory_buffer.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "gtest/gtest.h"
+
+
+TEST(TrajectoryBufferTest, ReserveOnlyGrows) {
+	using namespace orbsim;
+
+	TrajectoryBuffer buffer;
+	EXPECT_EQ(buffer.get_capacity(), 0);
+	EXPECT_EQ(buffer.get_pos_arr(), nullptr);
+
+	buffer.reserve(10);
+	buffer.get_time_arr()[9] = 9;
+	buffer.get_pos_arr()[9] = Vec3{1, 2, 3};
+	buffer.get_vel_arr()[9] = Vec3{4, 5, 6};
+	const Vec3 *pos_arr = buffer.get_pos_arr();
+
+	buffer.reserve(5);
+	EXPECT_EQ(buffer.get_capacity(), 10);
+	EXPECT_EQ(buffer.get_pos_arr(), pos_arr);
+
+	// Growing keeps the samples
+	buffer.reserve(100);
+	EXPECT_EQ(buffer.get_capacity(), 100);
+	EXPECT_DOUBLE_EQ(buffer.get_time_arr()[9], 9);
+	EXPECT_EQ(buffer.get_pos_arr()[9], (Vec3{1, 2, 3}));
+	EXPECT_EQ(buffer.get_vel_arr()[9], (Vec3{4, 5, 6}));
+	EXPECT_EQ(buffer.get_pos_arr()[99], (Vec3{0, 0, 0}));
+}
+
+TEST(TrajectoryBufferTest, CopyAndAssignment) {
+	using namespace orbsim;
+
+	TrajectoryBuffer buffer;
+	buffer.reserve(4);
+	buffer.get_pos_arr()[3] = Vec3{1, 2, 3};
+
+	TrajectoryBuffer buffer_copy(buffer);
+	EXPECT_EQ(buffer_copy.get_capacity(), 4);
+	EXPECT_NE(buffer_copy.get_pos_arr(), buffer.get_pos_arr());
+	EXPECT_EQ(buffer_copy.get_pos_arr()[3], (Vec3{1, 2, 3}));
+
+	TrajectoryBuffer assigned;
+	assigned = buffer;
+	EXPECT_EQ(assigned.get_pos_arr()[3], (Vec3{1, 2, 3}));
+}
+
+TEST(TrajectoryBufferTest, ArenaReusesBlocks) {
+	using namespace orbsim;
+
+	TrajectoryArena arena;
+	{
+		TrajectoryBuffer buffer(&arena);
+		buffer.reserve(1000);
+	}
+	EXPECT_EQ(arena.get_heap_allocs(), 1u);
+
+	// Same size class, the released block comes back
+	for (int i = 0; i < 10; i++) {
+		TrajectoryBuffer buffer(&arena);
+		buffer.reserve(900 + i);
+	}
+	EXPECT_EQ(arena.get_heap_allocs(), 1u);
+	EXPECT_EQ(arena.get_reuses(), 10u);
+
+	// Moving a buffer into the arena keeps its samples
+	TrajectoryBuffer buffer;
+	buffer.reserve(10);
+	buffer.get_vel_arr()[5] = Vec3{1, 1, 1};
+	buffer.set_arena(&arena);
+	EXPECT_EQ(buffer.get_arena(), &arena);
+	EXPECT_EQ(buffer.get_vel_arr()[5], (Vec3{1, 1, 1}));
+}
@@ -0,0 +1,151 @@
+#include "simulation/trajectory_file.hpp"
+#include "simulation/events.hpp"
+#include "simulation/celestial_obj.hpp"
+#include "simulation/math_obj.hpp"
+#include "simulation/satellite.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+
+TEST(TrajectoryFileTest, RoundTrip) {
+	using namespace orbsim;
+
+	Satellite sat;
+	SimData sim_data = sat.propagate();
+
+	std::string filename = testing::TempDir() + "trajectory_file_test.orbtraj";
+	write_trajectory(filename, TrajectoryHeader{"RK4", Earth, 10, sim_data.get_steps()},
+					 sim_data.get_time_arr(), sim_data.get_pos_arr(), sim_data.get_vel_arr());
+
+	{
+		TrajectoryReader reader(filename);
+		const TrajectoryHeader &header = reader.get_header();
+		EXPECT_EQ(header.integ_name, "RK4");
+		EXPECT_DOUBLE_EQ(header.cel_obj.mass, Earth.mass);
+		EXPECT_DOUBLE_EQ(header.cel_obj.radius, Earth.radius);
+		EXPECT_DOUBLE_EQ(header.epoch, 10);
+		ASSERT_EQ(reader.size(), sim_data.get_steps());
+
+		for (int i = 0; i < sim_data.get_steps(); i++) {
+			EXPECT_DOUBLE_EQ(reader.time_at(i), sim_data.get_time_arr()[i]);
+			EXPECT_EQ(reader.pos_at(i), sim_data.get_pos_arr()[i]);
+			EXPECT_EQ(reader.vel_at(i), sim_data.get_vel_arr()[i]);
+		}
+
+		// The columns are contiguous
+		const double *vel_y = reader.column(TrajectoryColumn::VelY);
+		EXPECT_DOUBLE_EQ(vel_y[sim_data.get_steps() - 1], sim_data.get_vel_arr()[sim_data.get_steps() - 1].y);
+	}
+
+	std::remove(filename.c_str());
+}
+
+TEST(TrajectoryFileTest, StreamingWriter) {
+	using namespace orbsim;
+
+	Satellite sat;
+	SimData sim_data = sat.propagate();
+
+	// Small windows, so the writer gets many blocks
+	std::string filename = testing::TempDir() + "trajectory_file_stream_test.orbtraj";
+	{
+		TrajectoryWriter writer(filename, sat.get_integ_name(), sat.get_cel_obj(), sat.get_t_start());
+		sat.propagate(writer, 100);
+	}
+	sim_data = sat.propagate();
+
+	{
+		TrajectoryReader reader(filename);
+		ASSERT_EQ(reader.size(), sim_data.get_steps());
+		for (int i = 0; i < sim_data.get_steps(); i++) {
+			EXPECT_DOUBLE_EQ(reader.time_at(i), sim_data.get_time_arr()[i]);
+			EXPECT_EQ(reader.pos_at(i), sim_data.get_pos_arr()[i]);
+			EXPECT_EQ(reader.vel_at(i), sim_data.get_vel_arr()[i]);
+		}
+	}
+
+	std::remove(filename.c_str());
+}
+
+TEST(TrajectoryFileTest, TerminalEvent) {
+	using namespace orbsim;
+
+	// Too slow to stay in orbit, the impact ends the trajectory early
+	CartElem initial{Vec3{Earth.radius + 200, 0, 0}, Vec3{0, 6, 0}};
+	EventDetector detector({impact_event()});
+	Satellite sat(initial, "RK4", Earth, 0, 3000, 3001);
+	sat.set_events(&detector);
+	SimData sim_data = sat.propagate();
+	ASSERT_LT(sim_data.get_steps(), 3001);
+
+	std::string filename = testing::TempDir() + "trajectory_file_event_test.orbtraj";
+	{
+		TrajectoryWriter writer(filename, sat.get_integ_name(), sat.get_cel_obj(), sat.get_t_start());
+		sat.propagate(writer, 100);
+	}
+
+	{
+		TrajectoryReader reader(filename);
+		ASSERT_EQ(reader.size(), sim_data.get_steps());
+		for (int i = 0; i < sim_data.get_steps(); i++) {
+			EXPECT_DOUBLE_EQ(reader.time_at(i), sim_data.get_time_arr()[i]);
+			EXPECT_EQ(reader.pos_at(i), sim_data.get_pos_arr()[i]);
+			EXPECT_EQ(reader.vel_at(i), sim_data.get_vel_arr()[i]);
+		}
+		EXPECT_NEAR(reader.pos_at(reader.size() - 1).len(), Earth.radius, 1e-6);
+	}
+
+	std::remove(filename.c_str());
+}
+
+TEST(TrajectoryFileTest, InvalidFiles) {
+	using namespace orbsim;
+
+	EXPECT_THROW(TrajectoryReader("/nonexistent/dir/file.orbtraj"), std::runtime_error);
+	EXPECT_THROW(TrajectoryWriter("/nonexistent/dir/file.orbtraj", "RK4", Earth), std::runtime_error);
+	EXPECT_THROW(TrajectoryWriter(testing::TempDir() + "name_test.orbtraj", std::string(64, 'x'), Earth),
+				 std::domain_error);
+
+	// Not a trajectory file
+	std::string filename = testing::TempDir() + "trajectory_file_invalid_test.orbtraj";
+	{
+		std::ofstream file(filename);
+		file << "0 0 0 0 0 0\n";
+	}
+	EXPECT_THROW(TrajectoryReader{filename}, std::runtime_error);
+
+	// Truncated columns
+	double time_arr[4] = {0, 1, 2, 3};
+	Vec3 pos_arr[4] = {};
+	Vec3 vel_arr[4] = {};
+	write_trajectory(filename, TrajectoryHeader{"RK4", Earth, 0, 4}, time_arr, pos_arr, vel_arr);
+	{
+		std::ifstream in(filename, std::ios::binary);
+		std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		in.close();
+		std::ofstream out(filename, std::ios::binary);
+		out.write(contents.data(), contents.size() - 8);
+	}
+	EXPECT_THROW(TrajectoryReader{filename}, std::runtime_error);
+
+	// Sample counts that overflow the size of the columns
+	for (std::uint64_t steps : {(std::uint64_t) 1 << 61, ((std::uint64_t) 1 << 63) + 1}) {
+		write_trajectory(filename, TrajectoryHeader{"RK4", Earth, 0, 4}, time_arr, pos_arr, vel_arr);
+		{
+			std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+			file.seekp(16);
+			file.write(reinterpret_cast<const char *>(&steps), sizeof(steps));
+		}
+		EXPECT_THROW(TrajectoryReader{filename}, std::runtime_error);
+	}
+
+	std::remove(filename.c_str());
+	std::remove((testing::TempDir() + "name_test.orbtraj").c_str());
+}
@@ -0,0 +1,106 @@
+#include "simulation/trajectory_sink.hpp"
+#include "simulation/math_obj.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+
+namespace {
+
+// Block of samples i = first ... first + count - 1 with pos = (i, 0, 0)
+struct TestBlock {
+	double time_arr[16];
+	orbsim::Vec3 pos_arr[16];
+	orbsim::Vec3 vel_arr[16];
+
+	orbsim::TrajectoryBlock get(int first, int count) {
+		for (int i = 0; i < count; i++) {
+			this->time_arr[i] = first + i;
+			this->pos_arr[i] = orbsim::Vec3{(double) first + i, 0, 0};
+			this->vel_arr[i] = orbsim::Vec3{0, (double) first + i, 0};
+		}
+		return orbsim::TrajectoryBlock{first, count, this->time_arr, this->pos_arr, this->vel_arr};
+	}
+};
+
+} // namespace
+
+
+TEST(TrajectorySinkTest, Callback) {
+	using namespace orbsim;
+
+	TestBlock data;
+	int received = 0;
+	CallbackSink sink([&](const TrajectoryBlock &block) { received += block.count; });
+	sink.consume(data.get(0, 5));
+	sink.consume(data.get(5, 3));
+
+	EXPECT_EQ(received, 8);
+}
+
+TEST(TrajectorySinkTest, RingBuffer) {
+	using namespace orbsim;
+
+	TestBlock data;
+	RingBufferSink sink(4);
+	sink.begin(20);
+	sink.consume(data.get(0, 3));
+
+	EXPECT_EQ(sink.size(), 3);
+	EXPECT_EQ(sink.pos_at(0), (Vec3{0, 0, 0}));
+
+	sink.consume(data.get(3, 6));
+
+	// Only samples 5 ... 8 are left
+	EXPECT_EQ(sink.get_capacity(), 4);
+	EXPECT_EQ(sink.size(), 4);
+	EXPECT_EQ(sink.get_total(), 9);
+	EXPECT_DOUBLE_EQ(sink.time_at(0), 5);
+	EXPECT_EQ(sink.pos_at(3), (Vec3{8, 0, 0}));
+	EXPECT_EQ(sink.vel_at(3), (Vec3{0, 8, 0}));
+	EXPECT_THROW(sink.pos_at(4), std::out_of_range);
+
+	// A new run starts empty
+	sink.begin(20);
+	EXPECT_EQ(sink.size(), 0);
+	EXPECT_THROW(RingBufferSink(0), std::domain_error);
+}
+
+TEST(TrajectorySinkTest, Stream) {
+	using namespace orbsim;
+
+	TestBlock data;
+	std::ostringstream os;
+	StreamSink sink(os);
+	sink.consume(data.get(0, 2));
+
+	std::string expected = Vec3{0, 0, 0}.to_str() + " " + Vec3{0, 0, 0}.to_str() + "\n"
+						 + Vec3{1, 0, 0}.to_str() + " " + Vec3{0, 1, 0}.to_str() + "\n";
+	EXPECT_EQ(os.str(), expected);
+}
+
+TEST(TrajectorySinkTest, File) {
+	using namespace orbsim;
+
+	TestBlock data;
+	std::string filename = testing::TempDir() + "trajectory_sink_test.txt";
+	{
+		FileSink sink(filename);
+		sink.consume(data.get(0, 10));
+		sink.end(10);
+	}
+
+	std::ifstream file(filename);
+	std::string line;
+	int lines = 0;
+	while (std::getline(file, line)) lines++;
+	EXPECT_EQ(lines, 10);
+
+	std::remove(filename.c_str());
+	EXPECT_THROW(FileSink("/nonexistent/dir/file.txt"), std::runtime_error);
+}
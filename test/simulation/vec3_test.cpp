@@ -155,3 +155,102 @@ TEST(Vec3Test, ToString) {
 
 	EXPECT_STREQ(v1.to_str().c_str(), "[1.75830921  2.18274001  3.11208863]");
 }
+
+TEST(Vec3Test, CompoundAssignment) {
+	using orbsim::Vec3;
+
+	Vec3 v1{1.5, 2.5, 3.1};
+	v1 += Vec3{4.4, 5.5, 6.9};
+	EXPECT_DOUBLE_EQ(v1.x, 1.5 + 4.4);
+	EXPECT_DOUBLE_EQ(v1.y, 2.5 + 5.5);
+	EXPECT_DOUBLE_EQ(v1.z, 3.1 + 6.9);
+
+	v1 -= Vec3{4.4, 5.5, 6.9};
+	EXPECT_EQ(v1, (Vec3{1.5, 2.5, 3.1}));
+}
+
+TEST(Vec3Test, FusedMultiplyAdd) {
+	using orbsim::Vec3;
+
+	Vec3 v1{2.5, 7.5, 10.1};
+	Vec3 v2{1.1, -2.6, 0.3};
+	Vec3 v3 = orbsim::fmadd(0.3, v1, v2);
+
+	// Rounded the same as the expression
+	EXPECT_EQ(v3.x, (0.3 * v1 + v2).x);
+	EXPECT_EQ(v3.y, (0.3 * v1 + v2).y);
+	EXPECT_EQ(v3.z, (0.3 * v1 + v2).z);
+}
+
+TEST(Vec3Test, Constexpr) {
+	using orbsim::Vec3;
+
+	constexpr Vec3 v1{1, 2, 3};
+	constexpr Vec3 v2{4, 5, 6};
+	static_assert(v1 + v2 == Vec3{5, 7, 9});
+	static_assert(v1.dot(v2) == 32);
+	static_assert(v1.cross(v2) == Vec3{-3, 6, -3});
+	static_assert(orbsim::fmadd(2, v1, v2) == Vec3{6, 9, 12});
+	static_assert(noexcept(v1 + v2));
+	SUCCEED();
+}
+
+TEST(Mat3Test, Products) {
+	using orbsim::Mat3;
+	using orbsim::Vec3;
+
+	Mat3 a{{1, 2, 3, 4, 5, 6, 7, 8, 10}};
+	Vec3 v{1, -1, 2};
+	EXPECT_EQ(a * v, (Vec3{5, 11, 19}));
+	EXPECT_EQ(a.transpose() * v, (Vec3{11, 13, 17}));
+	EXPECT_EQ(a.row(1), (Vec3{4, 5, 6}));
+	EXPECT_EQ(a.col(1), (Vec3{2, 5, 8}));
+
+	Mat3 b = a * Mat3::identity();
+	for (int k = 0; k < 9; k++) EXPECT_EQ(b.m[k], a.m[k]);
+
+	// (a a^T)_ij = row i . row j
+	Mat3 c = a * a.transpose();
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) EXPECT_DOUBLE_EQ(c(i, j), a.row(i).dot(a.row(j)));
+	}
+
+	Mat3 d = 2 * a - a + orbsim::outer(v, v);
+	EXPECT_DOUBLE_EQ(d(0, 0), 1 + 1);
+	EXPECT_DOUBLE_EQ(d(1, 2), 6 - 2);
+	EXPECT_DOUBLE_EQ(d(2, 2), 10 + 4);
+}
+
+TEST(Mat3Test, Rotations) {
+	using namespace orbsim;
+
+	// Counterclockwise looking down the axis
+	EXPECT_EQ((rot_z(PI / 2) * Vec3{1, 0, 0}), (Vec3{0, 1, 0}));
+	EXPECT_EQ((rot_x(PI / 2) * Vec3{0, 1, 0}), (Vec3{0, 0, 1}));
+	EXPECT_EQ((rot_y(PI / 2) * Vec3{0, 0, 1}), (Vec3{1, 0, 0}));
+
+	// Orthogonal, the transpose is the inverse
+	Mat3 rot = rot_z(0.3) * rot_x(1.1) * rot_y(-2.4);
+	Mat3 prod = rot * rot.transpose();
+	for (int k = 0; k < 9; k++) EXPECT_NEAR(prod.m[k], k % 4 == 0 ? 1 : 0, 1e-15);
+	Vec3 v{3.1, -0.4, 2.2};
+	EXPECT_DOUBLE_EQ((rot * v).len(), v.len());
+
+	static_assert(rot_z(0, 1) * Vec3{1, 0, 0} == Vec3{0, 1, 0});
+}
+
+TEST(CartElemTest, Arithmetic) {
+	using namespace orbsim;
+
+	CartElem a{Vec3{1, 2, 3}, Vec3{0.1, 0.2, 0.3}};
+	CartElem b{Vec3{-1, 0, 1}, Vec3{0.5, 0.5, 0.5}};
+	CartElem c = fmadd(2, a, b);
+	EXPECT_EQ(c.pos, (Vec3{1, 4, 7}));
+	EXPECT_EQ(c.vel, (Vec3{0.7, 0.9, 1.1}));
+
+	c -= b;
+	c *= 0.5;
+	EXPECT_EQ(c.pos, a.pos);
+	EXPECT_EQ(c.vel, a.vel);
+	EXPECT_EQ((a + b - b).pos, a.pos);
+}